@@ -93,6 +93,43 @@ UNIT_TEST(BitwiseMerge)
   }
 }
 
+UNIT_TEST(BitwiseSplit)
+{
+  for (uint32_t x = 0; x < 16; ++x)
+  {
+    for (uint32_t y = 0; y < 16; ++y)
+    {
+      uint32_t rx, ry;
+      bits::BitwiseSplit(bits::BitwiseMerge(x, y), rx, ry);
+      TEST_EQUAL(rx, x, (x, y));
+      TEST_EQUAL(ry, y, (x, y));
+    }
+  }
+
+  // The reference implementation which unshuffles 32-bit halves.
+  auto bitwiseSplitSlow = [](uint64_t v, uint32_t & x, uint32_t & y) {
+    uint32_t const hi = bits::PerfectUnshuffle(static_cast<uint32_t>(v >> 32));
+    uint32_t const lo = bits::PerfectUnshuffle(static_cast<uint32_t>(v & 0xFFFFFFFFULL));
+    x = ((hi & 0xFFFF) << 16) | (lo & 0xFFFF);
+    y = (hi & 0xFFFF0000) | (lo >> 16);
+  };
+
+  uint64_t v = 0x9E3779B97F4A7C15ULL;
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    v ^= v << 13;
+    v ^= v >> 7;
+    v ^= v << 17;
+
+    uint32_t x, y, xSlow, ySlow;
+    bits::BitwiseSplit(v, x, y);
+    bitwiseSplitSlow(v, xSlow, ySlow);
+    TEST_EQUAL(x, xSlow, (v));
+    TEST_EQUAL(y, ySlow, (v));
+    TEST_EQUAL(bits::BitwiseMerge(x, y), v, ());
+  }
+}
+
 UNIT_TEST(ZigZagEncode)
 {
   TEST_EQUAL(bits::ZigZagEncode(0),  0, ());
@@ -15,6 +15,8 @@ public:
   {
   }
 
+  Value const * Get(Key const & key) { return m_cache.Get(key); }
+
   Value const & GetValue(Key const & key)
   {
     bool found;
@@ -174,3 +176,26 @@ UNIT_TEST(LruCacheLoaderCallsTest)
   cache.GetValue(1);
   TEST(cache.IsValid(), ());
 }
+
+UNIT_TEST(LruCacheGetTest)
+{
+  using Key = int;
+  using Value = int;
+  LruCacheTest<Key, Value> cache(2 /* maxCacheSize */, [](Key k, Value & v) { v = k; } /* loader */);
+  cache.GetValue(1);
+  cache.GetValue(2);
+
+  // Misses don't evict the cached values.
+  TEST(!cache.Get(3), ());
+  TEST(!cache.Get(4), ());
+  TEST(cache.IsValid(), ());
+
+  // A hit makes 1 the most recently used value, so 2 is evicted by 3.
+  TEST(cache.Get(1), ());
+  TEST_EQUAL(*cache.Get(1), 1, ());
+  cache.GetValue(3);
+  TEST(!cache.Get(2), ());
+  TEST(cache.Get(1), ());
+  TEST(cache.Get(3), ());
+  TEST(cache.IsValid(), ());
+}
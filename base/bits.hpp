@@ -156,12 +156,23 @@ namespace bits
     return (static_cast<uint64_t>(hi) << 32) + lo;
   }
 
+  // Returns the bits of |v| at even-numbered positions packed to the lower half of the result.
+  inline uint32_t CompactEvenBits(uint64_t v)
+  {
+    v &= 0x5555555555555555ULL;
+    v = (v | (v >> 1)) & 0x3333333333333333ULL;
+    v = (v | (v >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v >> 4)) & 0x00FF00FF00FF00FFULL;
+    v = (v | (v >> 8)) & 0x0000FFFF0000FFFFULL;
+    v = (v | (v >> 16)) & 0x00000000FFFFFFFFULL;
+    return static_cast<uint32_t>(v);
+  }
+
+  // The inverse of BitwiseMerge.
   inline void BitwiseSplit(uint64_t v, uint32_t & x, uint32_t & y)
   {
-    uint32_t const hi = PerfectUnshuffle(static_cast<uint32_t>(v >> 32));
-    uint32_t const lo = PerfectUnshuffle(static_cast<uint32_t>(v & 0xFFFFFFFFULL));
-    x = ((hi & 0xFFFF) << 16) | (lo & 0xFFFF);
-    y = (hi & 0xFFFF0000) | (lo >> 16);
+    x = CompactEvenBits(v);
+    y = CompactEvenBits(v >> 1);
   }
 
   // Returns 1 if bit is set and 0 otherwise.
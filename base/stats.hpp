@@ -81,6 +81,12 @@ template <class Key> class TopStatsCounter
 public:
   void Add(Key const & key) { ++m_data[key]; }
 
+  void Merge(TopStatsCounter const & other)
+  {
+    for (auto const & [key, count] : other.m_data)
+      m_data[key] += count;
+  }
+
   void PrintTop(size_t count) const
   {
     ASSERT(count > 0, ());
@@ -1,6 +1,7 @@
 #include "testing/testing.hpp"
 
 #include "coding/files_container.hpp"
+#include "coding/memory_region.hpp"
 #include "coding/varint.hpp"
 
 #include "base/logging.hpp"
@@ -11,6 +12,8 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <string>
 
 #ifndef OMIM_OS_WINDOWS
@@ -80,6 +83,91 @@ UNIT_TEST(FilesContainer_Smoke)
   FileWriter::DeleteFileX(fName);
 }
 
+UNIT_TEST(FilesContainer_MmapAccessMode)
+{
+  string const fName = "files_container_mmap.tmp";
+  FileWriter::DeleteFileX(fName);
+  SCOPE_GUARD(deleteFile, [&fName]() { FileWriter::DeleteFileX(fName); });
+
+  // "geom0" and "geom1" get the advice of "geom".
+  char const * tags[] = {"geom0", "geom1", "idx", "other"};
+  {
+    FilesContainerW writer(fName);
+    for (size_t i = 0; i < ARRAY_SIZE(tags); ++i)
+    {
+      auto w = writer.GetWriter(tags[i]);
+      for (uint32_t j = 0; j < 10000 * i; ++j)
+        WriteVarUint(w, j);
+    }
+  }
+
+  auto const defaultParams = FilesContainerR::GetAccessParams();
+  SCOPE_GUARD(restoreParams, [&defaultParams]() { FilesContainerR::SetAccessParams(defaultParams); });
+
+  FilesContainerR::AccessParams params;
+  params.m_mode = FilesContainerR::AccessMode::Mmap;
+  FilesContainerR::SetAccessParams(params);
+  FilesContainerR::SetSectionAdvice("geom", MmapReader::Advice::Random);
+
+  FilesContainerR reader(fName);
+  for (size_t i = 0; i < ARRAY_SIZE(tags); ++i)
+  {
+    auto const r = reader.GetReader(tags[i]);
+    TEST(dynamic_cast<MmapReader const *>(r.GetPtr()), (tags[i]));
+
+    ReaderSource<FilesContainerR::TReader> src(r);
+    for (uint32_t j = 0; j < 10000 * i; ++j)
+      TEST_EQUAL(ReadVarUint<uint32_t>(src), j, (tags[i]));
+    TEST_EQUAL(src.Size(), 0, (tags[i]));
+  }
+
+  // The page cache params are used by the ReaderCache mode only.
+  params.m_mode = FilesContainerR::AccessMode::ReaderCache;
+  params.m_logPageSize = 12;
+  params.m_logPageCount = 2;
+  FilesContainerR::SetAccessParams(params);
+  auto const fileReader = FilesContainerR::CreateFileReader(fName, 10, 10);
+  TEST(dynamic_cast<FileReader const *>(fileReader.get()), ());
+}
+
+UNIT_TEST(FilesContainer_MappedSectionRegion)
+{
+  string const fName = "files_container_region.tmp";
+  FileWriter::DeleteFileX(fName);
+  SCOPE_GUARD(deleteFile, [&fName]() { FileWriter::DeleteFileX(fName); });
+
+  string const data[] = {"header", string(10000, 'a'), "tail"};
+  {
+    FilesContainerW writer(fName);
+    for (size_t i = 0; i < ARRAY_SIZE(data); ++i)
+      writer.Write(data[i].data(), data[i].size(), strings::to_string(i));
+  }
+
+  auto const defaultParams = FilesContainerR::GetAccessParams();
+  SCOPE_GUARD(restoreParams, [&defaultParams]() { FilesContainerR::SetAccessParams(defaultParams); });
+
+  for (auto const mode : {FilesContainerR::AccessMode::ReaderCache, FilesContainerR::AccessMode::Mmap})
+  {
+    FilesContainerR::AccessParams params;
+    params.m_mode = mode;
+    FilesContainerR::SetAccessParams(params);
+
+    unique_ptr<MappedSectionRegion> regions[ARRAY_SIZE(data)];
+    {
+      FilesContainerR reader(fName);
+      for (size_t i = 0; i < ARRAY_SIZE(data); ++i)
+        regions[i] = make_unique<MappedSectionRegion>(reader, strings::to_string(i));
+    }
+
+    // The regions outlive the container.
+    for (size_t i = 0; i < ARRAY_SIZE(data); ++i)
+    {
+      TEST_EQUAL(regions[i]->Size(), data[i].size(), (i));
+      TEST_EQUAL(memcmp(regions[i]->ImmutableData(), data[i].data(), data[i].size()), 0, (i));
+    }
+  }
+}
+
 namespace
 {
   void CheckInvariant(FilesContainerR & reader, string const & tag, int64_t test)
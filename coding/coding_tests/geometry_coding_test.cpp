@@ -16,6 +16,8 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <random>
 #include <vector>
 
 using namespace coding;
@@ -118,6 +120,37 @@ UNIT_TEST(PredictPointsInPolyline2)
 
   // Clamp 0
   TEST_EQUAL(PU(4, 0), PredictPointInPolyline(PD(5, 5), PU(4, 1), PU(4, 4)), ());
+
+  // Integer version
+  uint32_t const kMax = numeric_limits<uint32_t>::max();
+  PU const maxPoints[] = {PU(8, 7), PU(4, 4), PU(5, 5), PU(kMax, kMax)};
+  PU const points[] = {PU(0, 0), PU(1, 2), PU(4, 1), PU(4, 4), PU(7, 3), PU(kMax, kMax - 1)};
+  for (auto const & maxPoint : maxPoints)
+  {
+    for (auto const & p1 : points)
+    {
+      for (auto const & p2 : points)
+      {
+        TEST_EQUAL(PredictPointInPolyline(maxPoint, p1, p2),
+                   PredictPointInPolyline(PD(maxPoint), p1, p2), (maxPoint, p1, p2));
+      }
+    }
+  }
+
+  // Short segments as in the real roads.
+  mt19937 rng(0);
+  auto const randomPoint = [&rng](PU const & base) {
+    return PU(base.x + rng() % 2000, base.y + rng() % 2000);
+  };
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    PU const base(rng() % (kMax - 4000), rng() % (kMax - 4000));
+    PU const maxPoint(kMax, kMax);
+    PU const p1 = randomPoint(base);
+    PU const p2 = randomPoint(base);
+    TEST_EQUAL(PredictPointInPolyline(maxPoint, p1, p2),
+               PredictPointInPolyline(PD(maxPoint), p1, p2), (maxPoint, p1, p2));
+  }
 }
 
 UNIT_TEST(PredictPointsInTriangle)
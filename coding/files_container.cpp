@@ -6,6 +6,8 @@
 #include "coding/write_to_sink.hpp"
 
 #include <cstring>
+#include <map>
+#include <mutex>
 #include <sstream>
 
 #ifndef OMIM_OS_WINDOWS
@@ -68,18 +70,74 @@ void FilesContainerBase::ReadInfo(Reader & reader)
 // FilesContainerR
 /////////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+struct AccessSettings
+{
+  std::mutex m_mutex;
+  FilesContainerR::AccessParams m_params;
+  std::map<FilesContainerBase::Tag, MmapReader::Advice> m_advices;
+};
+
+AccessSettings & GetAccessSettings()
+{
+  static AccessSettings settings;
+  return settings;
+}
+}  // namespace
+
+// static
+void FilesContainerR::SetAccessParams(AccessParams const & params)
+{
+  auto & settings = GetAccessSettings();
+  std::lock_guard<std::mutex> lock(settings.m_mutex);
+  settings.m_params = params;
+}
+
+// static
+FilesContainerR::AccessParams FilesContainerR::GetAccessParams()
+{
+  auto & settings = GetAccessSettings();
+  std::lock_guard<std::mutex> lock(settings.m_mutex);
+  return settings.m_params;
+}
+
+// static
+void FilesContainerR::SetSectionAdvice(Tag const & tag, MmapReader::Advice advice)
+{
+  auto & settings = GetAccessSettings();
+  std::lock_guard<std::mutex> lock(settings.m_mutex);
+  settings.m_advices[tag] = advice;
+}
+
+// static
+std::unique_ptr<ModelReader> FilesContainerR::CreateFileReader(std::string const & filePath,
+                                                               uint32_t logPageSize,
+                                                               uint32_t logPageCount)
+{
+  auto const params = GetAccessParams();
+  if (params.m_mode == AccessMode::Mmap)
+    return std::make_unique<MmapReader>(filePath);
+
+  return std::make_unique<FileReader>(filePath,
+                                      params.m_logPageSize != 0 ? params.m_logPageSize : logPageSize,
+                                      params.m_logPageCount != 0 ? params.m_logPageCount : logPageCount);
+}
+
 FilesContainerR::FilesContainerR(std::string const & filePath,
                                  uint32_t logPageSize,
                                  uint32_t logPageCount)
-  : m_source(std::make_unique<FileReader>(filePath, logPageSize, logPageCount))
+  : m_source(CreateFileReader(filePath, logPageSize, logPageCount))
 {
   ReadInfo(m_source);
+  AdviseSections();
 }
 
 FilesContainerR::FilesContainerR(TReader const & file)
   : m_source(file)
 {
   ReadInfo(m_source);
+  AdviseSections();
 }
 
 FilesContainerR::TReader FilesContainerR::GetReader(Tag const & tag) const
@@ -101,6 +159,26 @@ std::pair<uint64_t, uint64_t> FilesContainerR::GetAbsoluteOffsetAndSize(Tag cons
   return std::make_pair(offset + p->m_offset, p->m_size);
 }
 
+void FilesContainerR::AdviseSections() const
+{
+  auto const * mmap = dynamic_cast<MmapReader const *>(m_source.GetPtr());
+  if (!mmap)
+    return;
+
+  auto & settings = GetAccessSettings();
+  std::lock_guard<std::mutex> lock(settings.m_mutex);
+  for (auto const & info : m_info)
+  {
+    auto const end = info.m_tag.find_last_not_of("0123456789");
+    auto const it = settings.m_advices.find(info.m_tag.substr(0, end == Tag::npos ? 0 : end + 1));
+    if (it == settings.m_advices.end() || info.m_size == 0)
+      continue;
+
+    auto const section = m_source.SubReader(info.m_offset, info.m_size);
+    static_cast<MmapReader const *>(section.GetPtr())->Advise(it->second);
+  }
+}
+
 FilesContainerBase::TagInfo const * FilesContainerBase::GetInfo(Tag const & tag) const
 {
   auto i = lower_bound(m_info.begin(), m_info.end(), tag, LessInfo());
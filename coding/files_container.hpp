@@ -2,6 +2,7 @@
 
 #include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/mmap_reader.hpp"
 
 #include "base/assert.hpp"
 #include "base/macros.hpp"
@@ -116,6 +117,39 @@ class FilesContainerR : public FilesContainerBase
 public:
   using TReader = ModelReaderPtr;
 
+  enum class AccessMode
+  {
+    /// Every reader of a container reads the file through its own FileReader page cache.
+    ReaderCache,
+    /// Section readers read the shared read-only mapping of the file: the pages are shared
+    /// by all the readers and processes, and nothing is copied to the per-reader caches.
+    Mmap
+  };
+
+  /// Process-wide settings of how the container files are read. They are applied to the files
+  /// opened after the call, so they are expected to be set on startup.
+  struct AccessParams
+  {
+    AccessMode m_mode = AccessMode::ReaderCache;
+    /// FileReader page cache for AccessMode::ReaderCache. Zeroes mean the values
+    /// passed by the caller, e.g. READER_CHUNK_LOG_SIZE and READER_CHUNK_LOG_COUNT.
+    uint32_t m_logPageSize = 0;
+    uint32_t m_logPageCount = 0;
+  };
+
+  static void SetAccessParams(AccessParams const & params);
+  static AccessParams GetAccessParams();
+
+  /// Sets the advice for the pages of the |tag| sections in AccessMode::Mmap, e.g. Random for
+  /// the geometry, WillNeed for the small hot indexes, Sequential for the generator passes.
+  /// Trailing digits of the section tags are ignored, so "geom" stands for all geometry scales.
+  /// There are no advices by default, MwmSet sets them for the mwm sections.
+  static void SetSectionAdvice(Tag const & tag, MmapReader::Advice advice);
+
+  /// Opens |filePath| according to the access params, e.g. for Platform::GetReader().
+  static std::unique_ptr<ModelReader> CreateFileReader(std::string const & filePath,
+                                                       uint32_t logPageSize, uint32_t logPageCount);
+
   explicit FilesContainerR(std::string const & filePath,
                            uint32_t logPageSize = 10,
                            uint32_t logPageCount = 10);
@@ -136,6 +170,9 @@ public:
   std::pair<uint64_t, uint64_t> GetAbsoluteOffsetAndSize(Tag const & tag) const;
 
 private:
+  // Gives the section advices when the file is mapped.
+  void AdviseSections() const;
+
   TReader m_source;
 };
 
@@ -6,7 +6,9 @@
 
 #include "base/assert.hpp"
 
+#include <algorithm>
 #include <complex>
+#include <cstdint>
 #include <stack>
 
 namespace
@@ -57,6 +59,20 @@ m2::PointU PredictPointInPolyline(m2::PointD const & maxPoint, m2::PointU const
   return ClampPoint(maxPoint, m2::PointD(p1) + (m2::PointD(p1) - m2::PointD(p2)) / 2.0);
 }
 
+m2::PointU PredictPointInPolyline(m2::PointU const & maxPoint, m2::PointU const & p1,
+                                  m2::PointU const & p2)
+{
+  // p1 + (p1 - p2) / 2 is a multiple of 0.5, so the double version is exact, and truncation
+  // of a clamped non-negative value is a shift.
+  auto const predict = [](uint32_t max, uint32_t c1, uint32_t c2) -> uint32_t {
+    int64_t const twice = 3 * static_cast<int64_t>(c1) - static_cast<int64_t>(c2);
+    if (twice <= 0)
+      return 0;
+    return static_cast<uint32_t>(std::min(static_cast<uint64_t>(twice) >> 1, uint64_t{max}));
+  };
+  return {predict(maxPoint.x, p1.x, p2.x), predict(maxPoint.y, p1.y, p2.y)};
+}
+
 uint64_t EncodePointDeltaAsUint(m2::PointU const & actual, m2::PointU const & prediction)
 {
   return bits::BitwiseMerge(
@@ -138,11 +154,10 @@ void EncodePolylinePrev2(InPointsT const & points, m2::PointU const & basePoint,
     deltas.push_back(EncodePointDeltaAsUint(points[0], basePoint));
     if (count > 1)
     {
-      m2::PointD const maxPointD(maxPoint);
       deltas.push_back(EncodePointDeltaAsUint(points[1], points[0]));
       for (size_t i = 2; i < count; ++i)
         deltas.push_back(EncodePointDeltaAsUint(
-            points[i], PredictPointInPolyline(maxPointD, points[i - 1], points[i - 2])));
+            points[i], PredictPointInPolyline(maxPoint, points[i - 1], points[i - 2])));
     }
   }
 
@@ -155,16 +170,20 @@ void DecodePolylinePrev2(InDeltasT const & deltas, m2::PointU const & basePoint,
   size_t const count = deltas.size();
   if (count > 0)
   {
-    points.push_back(DecodePointDeltaFromUint(deltas[0], basePoint));
+    m2::PointU prev2 = DecodePointDeltaFromUint(deltas[0], basePoint);
+    points.push_back(prev2);
     if (count > 1)
     {
-      m2::PointD const maxPointD(maxPoint);
-      points.push_back(DecodePointDeltaFromUint(deltas[1], points.back()));
+      // Previous points are kept in registers instead of being read back from |points|.
+      m2::PointU prev1 = DecodePointDeltaFromUint(deltas[1], prev2);
+      points.push_back(prev1);
       for (size_t i = 2; i < count; ++i)
       {
-        size_t const n = points.size();
-        points.push_back(DecodePointDeltaFromUint(
-            deltas[i], PredictPointInPolyline(maxPointD, points[n - 1], points[n - 2])));
+        m2::PointU const pt =
+            DecodePointDeltaFromUint(deltas[i], PredictPointInPolyline(maxPoint, prev1, prev2));
+        points.push_back(pt);
+        prev2 = prev1;
+        prev1 = pt;
       }
     }
   }
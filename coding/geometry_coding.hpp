@@ -55,6 +55,12 @@ m2::PointU DecodePointDelta(Source & source, m2::PointU const & base)
 m2::PointU PredictPointInPolyline(m2::PointD const & maxPoint, m2::PointU const & p1,
                                   m2::PointU const & p2);
 
+/// The same prediction in integer arithmetic: the result is equal to the one above
+/// for m2::PointD(maxPoint), but there is no round trip through doubles, which is
+/// the longest dependency in the polyline decoding loop.
+m2::PointU PredictPointInPolyline(m2::PointU const & maxPoint, m2::PointU const & p1,
+                                  m2::PointU const & p2);
+
 /// Predict next point for polyline with given previous points (p1, p2, p3).
 m2::PointU PredictPointInPolyline(m2::PointD const & maxPoint, m2::PointU const & p1,
                                   m2::PointU const & p2, m2::PointU const & p3);
@@ -182,8 +188,9 @@ void DecodeImpl(TDecodeFun fn, DeltasT const & deltas, GeometryCodingParams cons
     points.reserve(count);
   }
 
-  std::transform(upoints.begin(), upoints.begin() + adapt.size(), std::back_inserter(points),
-                 std::bind(&pts::U2D, std::placeholders::_1, params.GetCoordBits()));
+  auto const coordBits = params.GetCoordBits();
+  for (size_t i = 0; i < adapt.size(); ++i)
+    points.push_back(pts::U2D(upoints[i], coordBits));
 }
 
 template <class TSink>
@@ -241,8 +248,9 @@ void LoadOuter(DecodeFunT fn, TSource & src, GeometryCodingParams const & params
                size_t reserveF = 1)
 {
   uint32_t const count = ReadVarUint<uint32_t>(src);
-  std::vector<char> buffer(count);
-  char * p = &buffer[0];
+  // Most of the outer geometry blobs are small, so they are read without a heap allocation.
+  buffer_vector<char, 256> buffer(count);
+  char * p = buffer.data();
   src.Read(p, count);
 
   DeltasT deltas;
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "coding/files_container.hpp"
+#include "coding/mmap_reader.hpp"
 
 #include "base/macros.hpp"
 
 #include <cstdint>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -50,3 +52,44 @@ private:
 
   DISALLOW_COPY(CopiedMemoryRegion);
 };
+
+// Section of a container which is queried right from the file mapping, without loading it
+// to the heap. The mapping of the container is shared when the container file is mapped
+// (FilesContainerR::AccessMode::Mmap), otherwise the section is mapped on its own.
+// The region may outlive the container.
+class MappedSectionRegion : public MemoryRegion
+{
+public:
+  MappedSectionRegion(FilesContainerR const & cont, FilesContainerBase::Tag const & tag)
+  {
+    auto reader = cont.GetReader(tag);
+    if (auto const * mmap = dynamic_cast<MmapReader const *>(reader.GetPtr()))
+    {
+      m_data = mmap->RangeData();
+      m_size = mmap->Size();
+      m_reader.emplace(std::move(reader));
+      return;
+    }
+
+    // The mapping stays valid when the file is closed.
+    detail::MappedFile file;
+    file.Open(cont.GetFileName());
+    auto const offsetAndSize = cont.GetAbsoluteOffsetAndSize(tag);
+    m_handle = file.Map(offsetAndSize.first, offsetAndSize.second, tag);
+    m_data = m_handle.GetData<uint8_t>();
+    m_size = m_handle.GetSize();
+  }
+
+  // MemoryRegion overrides:
+  uint64_t Size() const override { return m_size; }
+  uint8_t const * ImmutableData() const override { return m_data; }
+
+private:
+  // Keeps the shared mapping alive.
+  std::optional<FilesContainerR::TReader> m_reader;
+  detail::MappedFile::Handle m_handle;
+  uint8_t const * m_data = nullptr;
+  uint64_t m_size = 0;
+
+  DISALLOW_COPY(MappedSectionRegion);
+};
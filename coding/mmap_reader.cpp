@@ -4,6 +4,7 @@
 
 #include "std/target_os.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 #ifdef OMIM_OS_WINDOWS
@@ -66,15 +67,31 @@ public:
       MYTHROW(OpenException, ("mmap failed for file", fileName));
     }
 
+    Advise(0 /* offset */, m_size, advice);
+#endif
+  }
+
+  void Advise(uint64_t offset, uint64_t size, Advice advice) const
+  {
+#ifndef OMIM_OS_WINDOWS
+    if (size == 0)
+      return;
+
+    // madvise() needs a page-aligned address.
+    static uint64_t const pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t const begin = offset - offset % pageSize;
+    uint64_t const end = std::min(offset + size, m_size);
+
     int adv = MADV_NORMAL;
     switch (advice)
     {
     case Advice::Random: adv = MADV_RANDOM; break;
     case Advice::Sequential: adv = MADV_SEQUENTIAL; break;
+    case Advice::WillNeed: adv = MADV_WILLNEED; break;
     case Advice::Normal: adv = MADV_NORMAL; break;
     }
 
-    if (madvise(m_memory, static_cast<size_t>(s.st_size), adv) != 0)
+    if (madvise(m_memory + begin, static_cast<size_t>(end - begin), adv) != 0)
       LOG(LWARNING, ("madvise error:", strerror(errno)));
 #endif
   }
@@ -141,6 +158,16 @@ uint8_t * MmapReader::Data() const
   return m_data->m_memory;
 }
 
+uint8_t const * MmapReader::RangeData() const
+{
+  return m_data->m_memory + m_offset;
+}
+
+void MmapReader::Advise(Advice advice) const
+{
+  m_data->Advise(m_offset, m_size, advice);
+}
+
 void MmapReader::SetOffsetAndSize(uint64_t offset, uint64_t size)
 {
   ASSERT_LESS_OR_EQUAL(offset + size, Size(), (offset, size));
@@ -15,7 +15,9 @@ public:
   {
     Normal,
     Random,
-    Sequential
+    Sequential,
+    // Pages are read ahead right away, for the small hot sections.
+    WillNeed
   };
 
   explicit MmapReader(std::string const & fileName, Advice advice = Advice::Normal);
@@ -26,6 +28,11 @@ public:
 
   /// Direct file/memory access
   uint8_t * Data() const;
+  /// Memory of this reader, i.e. of its own range for the sub readers, unlike Data().
+  uint8_t const * RangeData() const;
+
+  /// Gives |advice| about the pages of this reader only, e.g. of a section of a file container.
+  void Advise(Advice advice) const;
 
 protected:
   // Used in special derived readers.
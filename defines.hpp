@@ -32,6 +32,10 @@
 // Feature -> Street, do not rename for compatibility.
 #define FEATURE2STREET_FILE_TAG "addr"
 #define FEATURE2PLACE_FILE_TAG "ft2place"
+// Street -> Features, inverse of FEATURE2STREET_FILE_TAG.
+#define STREET2FEATURE_FILE_TAG "street2ft"
+// Classificator type -> Features, built from the categories branch of the search index.
+#define TYPES_POSTINGS_FILE_TAG "types_postings"
 
 #define POSTCODE_POINTS_FILE_TAG "postcode_points"
 #define POSTCODES_FILE_TAG "postcodes"
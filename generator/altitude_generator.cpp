@@ -45,7 +45,10 @@ using namespace routing;
 class SrtmGetter : public AltitudeGetter
 {
 public:
-  explicit SrtmGetter(std::string const & srtmDir) : m_srtmManager(srtmDir) {}
+  SrtmGetter(std::string const & srtmDir, size_t threadsCount)
+    : m_srtmManager(srtmDir), m_threadsCount(threadsCount)
+  {
+  }
 
   // AltitudeGetter overrides:
   geometry::Altitude GetAltitude(m2::PointD const & p) override
@@ -53,8 +56,19 @@ public:
     return m_srtmManager.GetHeight(mercator::ToLatLon(p));
   }
 
+  void GetAltitudes(std::vector<m2::PointD> const & points,
+                    geometry::Altitudes & altitudes) override
+  {
+    std::vector<ms::LatLon> coords;
+    coords.reserve(points.size());
+    for (auto const & p : points)
+      coords.push_back(mercator::ToLatLon(p));
+    m_srtmManager.GetHeights(coords, altitudes, m_threadsCount);
+  }
+
 private:
   generator::SrtmTileManager m_srtmManager;
+  size_t const m_threadsCount;
 };
 
 class Processor
@@ -88,17 +102,15 @@ public:
 
   geometry::Altitude GetMinAltitude() const { return m_minAltitude; }
 
+  // Collects the points of the roads, the altitudes are got for all of them at once in Finish().
   void operator()(FeatureType & f, uint32_t const & id)
   {
-    if (id != m_altitudeAvailabilityBuilder.size())
+    if (id != m_featuresCount)
     {
       LOG(LERROR, ("There's a gap in feature id order."));
       return;
     }
-
-    bool hasAltitude = false;
-    SCOPE_GUARD(altitudeAvailabilityBuilding,
-                [&]() { m_altitudeAvailabilityBuilder.push_back(hasAltitude); });
+    ++m_featuresCount;
 
     if (!routing::IsRoad(feature::TypesHolder(f)))
       return;
@@ -108,32 +120,47 @@ public:
     if (pointsCount == 0)
       return;
 
-    geometry::Altitudes altitudes;
-    geometry::Altitude minFeatureAltitude = geometry::kInvalidAltitude;
+    m_roads.push_back({id, m_points.size(), pointsCount});
     for (size_t i = 0; i < pointsCount; ++i)
+      m_points.push_back(f.GetPoint(i));
+  }
+
+  void Finish()
+  {
+    geometry::Altitudes pointAltitudes;
+    m_altitudeGetter.GetAltitudes(m_points, pointAltitudes);
+    CHECK_EQUAL(pointAltitudes.size(), m_points.size(), ());
+
+    auto road = m_roads.cbegin();
+    for (uint32_t id = 0; id < m_featuresCount; ++id)
     {
-      geometry::Altitude const a = m_altitudeGetter.GetAltitude(f.GetPoint(i));
-      if (a == geometry::kInvalidAltitude)
-      {
-        // One invalid point invalidates the whole feature.
-        return;
-      }
+      bool hasAltitude = false;
+      SCOPE_GUARD(altitudeAvailabilityBuilding,
+                  [&]() { m_altitudeAvailabilityBuilder.push_back(hasAltitude); });
 
-      if (minFeatureAltitude == geometry::kInvalidAltitude)
-        minFeatureAltitude = a;
-      else
-        minFeatureAltitude = std::min(minFeatureAltitude, a);
+      if (road == m_roads.cend() || road->m_featureId != id)
+        continue;
 
-      altitudes.push_back(a);
-    }
+      auto const begin = pointAltitudes.cbegin() + road->m_firstPoint;
+      auto const end = begin + road->m_pointsCount;
+      ++road;
 
-    hasAltitude = true;
-    m_featureAltitudes.emplace_back(id, Altitudes(std::move(altitudes)));
+      // One invalid point invalidates the whole feature.
+      if (std::find(begin, end, geometry::kInvalidAltitude) != end)
+        continue;
 
-    if (m_minAltitude == geometry::kInvalidAltitude)
-      m_minAltitude = minFeatureAltitude;
-    else
-      m_minAltitude = std::min(minFeatureAltitude, m_minAltitude);
+      geometry::Altitude const minFeatureAltitude = *std::min_element(begin, end);
+      hasAltitude = true;
+      m_featureAltitudes.emplace_back(id, Altitudes(geometry::Altitudes(begin, end)));
+
+      if (m_minAltitude == geometry::kInvalidAltitude)
+        m_minAltitude = minFeatureAltitude;
+      else
+        m_minAltitude = std::min(minFeatureAltitude, m_minAltitude);
+    }
+
+    m_roads.clear();
+    m_points.clear();
   }
 
   bool HasAltitudeInfo() const { return !m_featureAltitudes.empty(); }
@@ -145,7 +172,17 @@ public:
   }
 
 private:
+  struct Road
+  {
+    uint32_t m_featureId;
+    size_t m_firstPoint;
+    size_t m_pointsCount;
+  };
+
   AltitudeGetter & m_altitudeGetter;
+  uint32_t m_featuresCount = 0;
+  std::vector<Road> m_roads;
+  std::vector<m2::PointD> m_points;
   TFeatureAltitudes m_featureAltitudes;
   succinct::bit_vector_builder m_altitudeAvailabilityBuilder;
   geometry::Altitude m_minAltitude;
@@ -161,6 +198,7 @@ void BuildRoadAltitudes(std::string const & mwmPath, AltitudeGetter & altitudeGe
     // Preparing altitude information.
     Processor processor(altitudeGetter);
     feature::ForEachFeature(mwmPath, processor);
+    processor.Finish();
 
     if (!processor.HasAltitudeInfo())
     {
@@ -233,10 +271,20 @@ void BuildRoadAltitudes(std::string const & mwmPath, AltitudeGetter & altitudeGe
   }
 }
 
-void BuildRoadAltitudes(std::string const & mwmPath, std::string const & srtmDir)
+void AltitudeGetter::GetAltitudes(std::vector<m2::PointD> const & points,
+                                  geometry::Altitudes & altitudes)
+{
+  altitudes.clear();
+  altitudes.reserve(points.size());
+  for (auto const & p : points)
+    altitudes.push_back(GetAltitude(p));
+}
+
+void BuildRoadAltitudes(std::string const & mwmPath, std::string const & srtmDir,
+                        size_t threadsCount)
 {
   LOG(LINFO, ("mwmPath =", mwmPath, "srtmDir =", srtmDir));
-  SrtmGetter srtmGetter(srtmDir);
+  SrtmGetter srtmGetter(srtmDir, threadsCount);
   BuildRoadAltitudes(mwmPath, srtmGetter);
 }
 }  // namespace routing
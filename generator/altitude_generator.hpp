@@ -5,7 +5,9 @@
 
 #include "indexer/feature_altitude.hpp"
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace routing
 {
@@ -13,6 +15,10 @@ class AltitudeGetter
 {
 public:
   virtual geometry::Altitude GetAltitude(m2::PointD const & p) = 0;
+  // Fills |altitudes| with the altitudes of |points|. The getters which get the altitudes
+  // faster in batches override it.
+  virtual void GetAltitudes(std::vector<m2::PointD> const & points,
+                            geometry::Altitudes & altitudes);
 };
 
 /// \brief Adds altitude section to mwm. It has the following format:
@@ -26,5 +32,6 @@ public:
 /// feat. table offset  feature table         alt. info offset - feat. table offset
 /// alt. info offset    altitude info         end of section - alt. info offset
 void BuildRoadAltitudes(std::string const & mwmPath, AltitudeGetter & altitudeGetter);
-void BuildRoadAltitudes(std::string const & mwmPath, std::string const & srtmDir);
+void BuildRoadAltitudes(std::string const & mwmPath, std::string const & srtmDir,
+                        size_t threadsCount = 1);
 }  // namespace routing
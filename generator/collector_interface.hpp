@@ -40,6 +40,7 @@ class CollectorInterface
 {
 public:
   friend class CollectorCollection;
+  friend class ProfiledCollector;
 
   CollectorInterface(std::string const & filename = {}) : m_id(CreateId()), m_filename(filename) {}
   virtual ~CollectorInterface() { CHECK(Platform::RemoveFileIfExists(GetTmpFilename()), (GetTmpFilename())); }
@@ -12,6 +12,9 @@
 #include "coding/geometry_coding.hpp"
 #include "coding/read_write_utils.hpp"
 #include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/zlib.hpp"
 
 #include "geometry/region2d.hpp"
 
@@ -21,6 +24,8 @@
 
 #include <algorithm>
 #include <cstring>
+#include <iterator>
+#include <utility>
 #include <vector>
 
 namespace feature
@@ -762,6 +767,253 @@ std::string DebugPrint(FeatureBuilder const & fb)
   return out.str();
 }
 
+// Features blocks --------------------------------------------------------------------------------
+namespace
+{
+using serialization_policy::SerializationVersion;
+
+enum class BlockCompression : uint8_t
+{
+  None,
+  ZLib
+};
+
+struct FeaturesBlock
+{
+  SerializationVersion m_version = SerializationVersion::Undefined;
+  BlockCompression m_compression = BlockCompression::None;
+  uint64_t m_featuresSize = 0;
+  FeatureBuilder::Buffer m_data;
+};
+
+void DeserializeFeature(SerializationVersion version, FeatureBuilder & fb,
+                        FeatureBuilder::Buffer & buffer)
+{
+  switch (version)
+  {
+  case SerializationVersion::MinSize:
+    serialization_policy::MinSize::Deserialize(fb, buffer);
+    return;
+  case SerializationVersion::MaxAccuracy:
+    serialization_policy::MaxAccuracy::Deserialize(fb, buffer);
+    return;
+  case SerializationVersion::Undefined: break;
+  }
+  CHECK(false, ("Unknown serialization version:", static_cast<uint32_t>(version)));
+}
+
+// Reads the block which follows the zero size record.
+template <typename Source>
+FeaturesBlock ReadFeaturesBlock(Source & src)
+{
+  FeaturesBlock block;
+  block.m_version = static_cast<SerializationVersion>(ReadPrimitiveFromSource<uint8_t>(src));
+  block.m_compression = static_cast<BlockCompression>(ReadPrimitiveFromSource<uint8_t>(src));
+  block.m_featuresSize = ReadVarUint<uint64_t>(src);
+  block.m_data.resize(ReadVarUint<uint64_t>(src));
+  src.Read(block.m_data.data(), block.m_data.size());
+  return block;
+}
+
+std::vector<FeatureBuilder> DecodeFeaturesBlock(FeaturesBlock const & block)
+{
+  FeatureBuilder::Buffer features;
+  switch (block.m_compression)
+  {
+  case BlockCompression::None: features = block.m_data; break;
+  case BlockCompression::ZLib:
+  {
+    features.reserve(block.m_featuresSize);
+    coding::ZLib::Inflate const inflate(coding::ZLib::Inflate::Format::ZLib);
+    CHECK(inflate(block.m_data.data(), block.m_data.size(), std::back_inserter(features)),
+          ("Broken features block."));
+    break;
+  }
+  default: CHECK(false, ("Unknown block compression:", static_cast<uint32_t>(block.m_compression)));
+  }
+  CHECK_EQUAL(features.size(), block.m_featuresSize, ("Broken features block."));
+
+  std::vector<FeatureBuilder> fbs;
+  MemReader reader(features.data(), features.size());
+  ReaderSource<MemReader> src(reader);
+  while (src.Size() > 0)
+  {
+    uint32_t const size = ReadVarUint<uint32_t>(src);
+    CHECK_NOT_EQUAL(size, 0, ("Nested features blocks."));
+    FeatureBuilder::Buffer buffer(size);
+    src.Read(buffer.data(), size);
+    DeserializeFeature(block.m_version, fbs.emplace_back(), buffer);
+  }
+  return fbs;
+}
+}  // namespace
+
+FeatureBuilder::Buffer MakeFeaturesBlock(FeatureBuilder::Buffer const & records,
+                                         FeaturesBlockOptions const & options)
+{
+  auto version = SerializationVersion::MaxAccuracy;
+  FeatureBuilder::Buffer quantized;
+  if (options.m_quantize)
+  {
+    version = SerializationVersion::MinSize;
+    MemReader reader(records.data(), records.size());
+    ReaderSource<MemReader> src(reader);
+    PushBackByteSink<FeatureBuilder::Buffer> sink(quantized);
+    while (src.Size() > 0)
+    {
+      FeatureBuilder fb;
+      ReadFromSourceRawFormat<serialization_policy::MaxAccuracy>(src, fb);
+      FeatureBuilderWriter<serialization_policy::MinSize>::Write(sink, fb);
+    }
+  }
+  auto const & features = options.m_quantize ? quantized : records;
+
+  auto compression = BlockCompression::None;
+  FeatureBuilder::Buffer compressed;
+  if (options.m_compress)
+  {
+    compression = BlockCompression::ZLib;
+    coding::ZLib::Deflate const deflate(coding::ZLib::Deflate::Format::ZLib,
+                                        coding::ZLib::Deflate::Level::BestSpeed);
+    CHECK(deflate(features.data(), features.size(), std::back_inserter(compressed)), ());
+  }
+  auto const & data = options.m_compress ? compressed : features;
+
+  FeatureBuilder::Buffer block;
+  PushBackByteSink<FeatureBuilder::Buffer> sink(block);
+  WriteVarUint(sink, uint32_t{0});
+  WriteToSink(sink, static_cast<uint8_t>(version));
+  WriteToSink(sink, static_cast<uint8_t>(compression));
+  WriteVarUint(sink, static_cast<uint64_t>(features.size()));
+  WriteVarUint(sink, static_cast<uint64_t>(data.size()));
+  sink.Write(data.data(), data.size());
+  return block;
+}
+
+// FeatureBuilderReader ----------------------------------------------------------------------------
+FeatureBuilderReader::FeatureBuilderReader(std::string const & filename,
+                                           serialization_policy::TypeSerializationVersion version,
+                                           size_t threadsCount)
+  : m_reader(filename)
+  , m_src(m_reader)
+  , m_version(static_cast<SerializationVersion>(version))
+  , m_maxPendingRecords(threadsCount > 1 ? 2 * threadsCount : 1)
+{
+  if (threadsCount > 1)
+    m_pool = std::make_unique<base::ComputationalThreadPool>(threadsCount);
+}
+
+bool FeatureBuilderReader::Read(std::vector<FeatureBuilder> & fbs, uint64_t & pos)
+{
+  ReadAhead();
+  if (m_pendingRecords.empty())
+    return false;
+
+  auto & record = m_pendingRecords.front();
+  pos = record.m_pos;
+  fbs = record.m_decoding.valid() ? record.m_decoding.get() : std::move(record.m_fbs);
+  m_pendingRecords.pop();
+  return true;
+}
+
+void FeatureBuilderReader::ReadAhead()
+{
+  while (m_pendingRecords.size() < m_maxPendingRecords && m_src.Size() > 0)
+  {
+    Record record;
+    record.m_pos = m_src.Pos();
+    uint32_t const size = ReadVarUint<uint32_t>(m_src);
+    if (size != 0)
+    {
+      FeatureBuilder::Buffer buffer(size);
+      m_src.Read(buffer.data(), size);
+      DeserializeFeature(m_version, record.m_fbs.emplace_back(), buffer);
+    }
+    else
+    {
+      m_hasReadBlocks = true;
+      auto block = ReadFeaturesBlock(m_src);
+      if (m_pool)
+      {
+        record.m_decoding = m_pool->Submit(
+            [block = std::move(block)]() { return DecodeFeaturesBlock(block); });
+      }
+      else
+      {
+        record.m_fbs = DecodeFeaturesBlock(block);
+      }
+    }
+    m_pendingRecords.push(std::move(record));
+  }
+}
+
+bool HasFeaturesBlocks(std::string const & filename)
+{
+  FileReader reader(filename);
+  ReaderSource<FileReader> src(reader);
+  while (src.Size() > 0)
+  {
+    uint32_t const size = ReadVarUint<uint32_t>(src);
+    if (size == 0)
+      return true;
+    src.Skip(size);
+  }
+  return false;
+}
+
+void UnpackFeaturesBlocks(std::string const & filename, size_t threadsCount)
+{
+  FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(filename, true /* mangleName */);
+  ForEachFeatureRawFormat(filename, [&](FeatureBuilder const & fb, uint64_t) { writer.Write(fb); },
+                          threadsCount);
+}
+
+// FeaturesBlockWriter -----------------------------------------------------------------------------
+FeaturesBlockWriter::FeaturesBlockWriter(std::string const & filename,
+                                         FeaturesBlockOptions const & options, bool mangleName)
+  : m_filename(filename)
+  , m_mangleName(mangleName)
+  , m_options(options)
+  , m_writer(std::make_unique<FileWriter>(m_mangleName ? m_filename + "_" : m_filename))
+{
+}
+
+FeaturesBlockWriter::~FeaturesBlockWriter()
+{
+  WriteBlock();
+  if (m_mangleName)
+  {
+    // Flush and close.
+    auto const currentFilename = m_writer->GetName();
+    m_writer.reset();
+    CHECK(base::RenameFileX(currentFilename, m_filename), (currentFilename, m_filename));
+  }
+}
+
+void FeaturesBlockWriter::Write(FeatureBuilder const & fb)
+{
+  if (!m_options.IsEnabled())
+  {
+    FeatureBuilderWriter<serialization_policy::MaxAccuracy>::Write(*m_writer, fb);
+    return;
+  }
+
+  PushBackByteSink<FeatureBuilder::Buffer> sink(m_records);
+  FeatureBuilderWriter<serialization_policy::MaxAccuracy>::Write(sink, fb);
+  if (m_records.size() >= kBlockSize)
+    WriteBlock();
+}
+
+void FeaturesBlockWriter::WriteBlock()
+{
+  if (m_records.empty())
+    return;
+
+  auto const block = MakeFeaturesBlock(m_records, m_options);
+  m_writer->Write(block.data(), block.size());
+  m_records.clear();
+}
+
 namespace serialization_policy
 {
 // static
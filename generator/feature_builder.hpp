@@ -10,9 +10,15 @@
 
 #include "base/geo_object_id.hpp"
 #include "base/stl_helpers.hpp"
+#include "base/thread_pool_computational.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <list>
+#include <memory>
+#include <queue>
 #include <string>
 #include <vector>
 
@@ -253,7 +259,7 @@ struct MinSize
 struct MaxAccuracy
 {
   auto static const kSerializationVersion =
-      static_cast<TypeSerializationVersion>(SerializationVersion::MinSize);
+      static_cast<TypeSerializationVersion>(SerializationVersion::MaxAccuracy);
 
   static void Serialize(FeatureBuilder const & fb, FeatureBuilder::Buffer & data)
   {
@@ -285,37 +291,97 @@ struct MaxAccuracy
 //  }
 //}
 
+// Features blocks.
+// Besides single features, the intermediate files may contain blocks of features. A block is
+// stored as a record of zero size, which a single feature never has, so the blocks and the single
+// features can be mixed in a file and the files can be appended by any writer. The features of
+// a block may be quantized and delta-encoded by MinSize policy and the block may be deflated.
+struct FeaturesBlockOptions
+{
+  bool IsEnabled() const { return m_quantize || m_compress; }
+
+  bool m_quantize = false;
+  bool m_compress = false;
+};
+
+// Makes a block record of |records|: the features serialized by MaxAccuracy policy, each one
+// prefixed by its size the same way as FeatureBuilderWriter writes them.
+FeatureBuilder::Buffer MakeFeaturesBlock(FeatureBuilder::Buffer const & records,
+                                         FeaturesBlockOptions const & options);
+
+// Reads the features of an intermediate file record by record. Blocks are decoded on the
+// |threadsCount| threads ahead of the reading, the features are returned in the order of the file.
+class FeatureBuilderReader
+{
+public:
+  FeatureBuilderReader(std::string const & filename,
+                       serialization_policy::TypeSerializationVersion version,
+                       size_t threadsCount = 1);
+
+  // Returns the features of the next record and the position of the record in the file,
+  // false at the end of the file.
+  bool Read(std::vector<FeatureBuilder> & fbs, uint64_t & pos);
+
+  // Returns true if any features block was read.
+  bool HasReadBlocks() const { return m_hasReadBlocks; }
+
+private:
+  struct Record
+  {
+    uint64_t m_pos = 0;
+    std::vector<FeatureBuilder> m_fbs;
+    // Valid for blocks decoded by the pool.
+    std::future<std::vector<FeatureBuilder>> m_decoding;
+  };
+
+  void ReadAhead();
+
+  FileReader m_reader;
+  ReaderSource<FileReader> m_src;
+  serialization_policy::SerializationVersion const m_version;
+  size_t const m_maxPendingRecords;
+  bool m_hasReadBlocks = false;
+  std::queue<Record> m_pendingRecords;
+  // The pool is the last member, so the tasks are finished before the other members are gone.
+  std::unique_ptr<base::ComputationalThreadPool> m_pool;
+};
+
+// Returns true if the file has features blocks. Single features are skipped without decoding.
+bool HasFeaturesBlocks(std::string const & filename);
+
+// Rewrites the file in the format of FeatureBuilderWriter with MaxAccuracy policy: the blocks
+// are replaced with their features. It's needed by the readers which address single features
+// by their positions in the file.
+void UnpackFeaturesBlocks(std::string const & filename, size_t threadsCount = 1);
+
 // Read feature from feature source.
 template <class SerializationPolicy = serialization_policy::MaxAccuracy, class Source>
 void ReadFromSourceRawFormat(Source & src, FeatureBuilder & fb)
 {
   uint32_t const sz = ReadVarUint<uint32_t>(src);
+  CHECK_NOT_EQUAL(sz, 0, ("Features block can't be read as a single feature."));
   typename FeatureBuilder::Buffer buffer(sz);
   src.Read(&buffer[0], sz);
   SerializationPolicy::Deserialize(fb, buffer);
 }
 
-// Process features in features file.
+// Process features in features file. All the features of a block get the position of the block.
 template <class SerializationPolicy = serialization_policy::MaxAccuracy, class ToDo>
-void ForEachFeatureRawFormat(std::string const & filename, ToDo && toDo)
+void ForEachFeatureRawFormat(std::string const & filename, ToDo && toDo, size_t threadsCount = 1)
 {
-  FileReader reader(filename);
-  ReaderSource<FileReader> src(reader);
-  // TryReadAndCheckVersion<SerializationPolicy>(src);
-  auto const fileSize = reader.Size();
-  auto currPos = src.Pos();
-  // read features one by one
-  while (currPos < fileSize)
+  FeatureBuilderReader reader(filename, SerializationPolicy::kSerializationVersion, threadsCount);
+  std::vector<FeatureBuilder> fbs;
+  uint64_t pos = 0;
+  while (reader.Read(fbs, pos))
   {
-    FeatureBuilder fb;
-    ReadFromSourceRawFormat<SerializationPolicy>(src, fb);
-    toDo(std::move(fb), currPos);
-    currPos = src.Pos();
+    for (auto & fb : fbs)
+      toDo(std::move(fb), pos);
   }
 }
 
 template <class SerializationPolicy = serialization_policy::MaxAccuracy>
-std::vector<FeatureBuilder> ReadAllDatRawFormat(std::string const & fileName)
+std::vector<FeatureBuilder> ReadAllDatRawFormat(std::string const & fileName,
+                                                size_t threadsCount = 1)
 {
   std::vector<FeatureBuilder> fbs;
   // Happens in tests when World or Country file is empty (no valid Features to emit).
@@ -324,7 +390,7 @@ std::vector<FeatureBuilder> ReadAllDatRawFormat(std::string const & fileName)
     ForEachFeatureRawFormat<SerializationPolicy>(fileName, [&](FeatureBuilder && fb, uint64_t)
     {
       fbs.emplace_back(std::move(fb));
-    });
+    }, threadsCount);
   }
   return fbs;
 }
@@ -382,4 +448,29 @@ private:
   bool m_mangleName = false;
   std::unique_ptr<Writer> m_writer;
 };
+
+// Writes the features serialized by MaxAccuracy policy as blocks of |options|, or one by one the
+// same way as FeatureBuilderWriter does if the options are disabled. The final processors use it
+// to rewrite the files written by RawGeneratorWriter without losing their blocks.
+class FeaturesBlockWriter
+{
+public:
+  // Size of the serialized features of a block before the encoding.
+  static size_t constexpr kBlockSize = 1 << 20;
+
+  FeaturesBlockWriter(std::string const & filename, FeaturesBlockOptions const & options,
+                      bool mangleName = false);
+  ~FeaturesBlockWriter();
+
+  void Write(FeatureBuilder const & fb);
+
+private:
+  void WriteBlock();
+
+  std::string m_filename;
+  bool m_mangleName = false;
+  FeaturesBlockOptions m_options;
+  FeatureBuilder::Buffer m_records;
+  std::unique_ptr<FileWriter> m_writer;
+};
 }  // namespace feature
@@ -27,12 +27,15 @@
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 #include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include "defines.hpp"
 
+#include <future>
 #include <limits>
 #include <list>
 #include <memory>
+#include <queue>
 #include <vector>
 
 
@@ -59,10 +62,19 @@ public:
     }
 
     m_addrFile = std::make_unique<FileWriter>(info.GetIntermediateFileName(name + DATA_FILE_EXTENSION, TEMP_ADDR_EXTENSION));
+
+    // Geometry of the next features is prepared on the pool while the current ones are written.
+    if (info.m_threadsCount > 1)
+    {
+      m_maxPendingFeatures = kPendingFeaturesPerThread * info.m_threadsCount;
+      m_pool = std::make_unique<base::ComputationalThreadPool>(info.m_threadsCount);
+    }
   }
 
   void Finish() override
   {
+    WritePendingFeatures();
+
     // write version information
     {
       FilesContainerW writer(m_filename);
@@ -142,13 +154,70 @@ public:
     }
   }
 
-  void SetBounds(m2::RectD const & bounds) { m_bounds = bounds; }
+  void SetBounds(m2::RectD const & bounds)
+  {
+    // Pending features would extend the bounds.
+    WritePendingFeatures();
+    m_bounds = bounds;
+  }
 
-  void operator()(FeatureBuilder & fb)
+  // Features must be added in the order of the mwm. The output doesn't depend on the threads count.
+  void operator()(FeatureBuilder && fb)
   {
-    GeometryHolder holder([this](int i) -> FileWriter & { return m_geoFile[i]->GetWriter(); },
-                          [this](int i) -> FileWriter & { return m_trgFile[i]->GetWriter(); }, fb, m_header);
+    if (!m_pool)
+    {
+      GeometryHolder holder([this](int i) -> Writer & { return m_geoFile[i]->GetWriter(); },
+                            [this](int i) -> Writer & { return m_trgFile[i]->GetWriter(); }, fb, m_header);
+      PrepareGeometry(fb, holder);
+      Write(fb, holder.GetBuffer());
+      return;
+    }
+
+    m_pendingFeatures.push(m_pool->Submit([this, fb = std::move(fb)]() mutable {
+      return PrepareFeature(std::move(fb));
+    }));
+    while (m_pendingFeatures.size() > m_maxPendingFeatures)
+      WriteFrontFeature();
+  }
+
+private:
+  using Points = std::vector<m2::PointD>;
+  using Polygons = std::list<Points>;
+
+  // Feature with the geometry which is not written to the geometry files yet. The offsets of its
+  // geometry are relative to the buffers of the scales.
+  struct PreparedFeature
+  {
+    FeatureBuilder m_fb;
+    FeatureBuilder::SupportingData m_data;
+    std::vector<FeatureBuilder::Buffer> m_geometry;
+    std::vector<FeatureBuilder::Buffer> m_triangles;
+  };
+
+  class TmpFile
+  {
+    std::unique_ptr<FileWriter> m_writer;
+  public:
+    explicit TmpFile(std::string const & filePath)
+      : m_writer(std::make_unique<FileWriter>(filePath)) {}
+
+    FileWriter & GetWriter() { return *m_writer; }
+
+    ~TmpFile()
+    {
+      auto const name = m_writer->GetName();
+      m_writer.reset();
+      FileWriter::DeleteFileX(name);
+    }
+  };
 
+  using TmpFiles = std::vector<std::unique_ptr<TmpFile>>;
+
+  static size_t constexpr kPendingFeaturesPerThread = 16;
+
+  // Simplifies and tesselates the geometry for all the scales.
+  void PrepareGeometry(FeatureBuilder const & fb, GeometryHolder & holder) const
+  {
     if (!fb.IsPoint())
     {
       bool const isLine = fb.IsLine();
@@ -250,7 +319,77 @@ public:
         }
       }
     }
+  }
+
+  PreparedFeature PrepareFeature(FeatureBuilder && fb) const
+  {
+    PreparedFeature prepared;
+    prepared.m_fb = std::move(fb);
+    prepared.m_geometry.resize(m_header.GetScalesCount());
+    prepared.m_triangles.resize(m_header.GetScalesCount());
 
+    std::vector<MemWriter<FeatureBuilder::Buffer>> geometry;
+    std::vector<MemWriter<FeatureBuilder::Buffer>> triangles;
+    for (size_t i = 0; i < m_header.GetScalesCount(); ++i)
+    {
+      geometry.emplace_back(prepared.m_geometry[i]);
+      triangles.emplace_back(prepared.m_triangles[i]);
+    }
+
+    GeometryHolder holder([&geometry](int i) -> Writer & { return geometry[i]; },
+                          [&triangles](int i) -> Writer & { return triangles[i]; }, prepared.m_fb,
+                          m_header);
+    PrepareGeometry(prepared.m_fb, holder);
+    prepared.m_data = std::move(holder.GetBuffer());
+    return prepared;
+  }
+
+  void WriteFrontFeature()
+  {
+    auto prepared = m_pendingFeatures.front().get();
+    m_pendingFeatures.pop();
+
+    auto & data = prepared.m_data;
+    WriteGeometry(data.m_ptsMask, prepared.m_geometry, m_geoFile, data.m_ptsOffset);
+    WriteGeometry(data.m_trgMask, prepared.m_triangles, m_trgFile, data.m_trgOffset);
+    Write(prepared.m_fb, data);
+  }
+
+  void WritePendingFeatures()
+  {
+    while (!m_pendingFeatures.empty())
+      WriteFrontFeature();
+  }
+
+  // Appends the geometry of the scales to the files and makes the offsets absolute. The offsets
+  // are added from the upper scale to the lower one, a scale has an offset if its bit is in |mask|.
+  static void WriteGeometry(uint8_t mask, std::vector<FeatureBuilder::Buffer> const & geometry,
+                            TmpFiles & files, FeatureBuilder::Offsets & offsets)
+  {
+    size_t offsetIndex = 0;
+    for (int i = static_cast<int>(geometry.size()) - 1; i >= 0; --i)
+    {
+      auto & writer = files[i]->GetWriter();
+      if (mask & (1 << i))
+      {
+        CHECK_LESS(offsetIndex, offsets.size(), ());
+        auto & offset = offsets[offsetIndex++];
+        if (offset != feature::kGeomOffsetFallback)
+        {
+          uint64_t const pos = writer.Pos() + offset;
+          CHECK_LESS_OR_EQUAL(pos, std::numeric_limits<uint32_t>::max(),
+                              ("Feature offset is out of 32bit boundary!"));
+          offset = static_cast<uint32_t>(pos);
+          CHECK(offset != feature::kGeomOffsetFallback, ());
+        }
+      }
+      writer.Write(geometry[i].data(), geometry[i].size());
+    }
+    CHECK_EQUAL(offsetIndex, offsets.size(), ());
+  }
+
+  void Write(FeatureBuilder & fb, FeatureBuilder::SupportingData & buffer)
+  {
     // Override "alt_name" with synonym for Country or State for better search matching.
     /// @todo Probably, we should store and index OSM's short_name tag.
     if (indexer::SynonymsHolder::CanApply(fb.GetTypes()))
@@ -283,7 +422,6 @@ public:
       }
     }
 
-    auto & buffer = holder.GetBuffer();
     if (fb.PreSerializeAndRemoveUselessNamesForMwm(buffer))
     {
       fb.SerializeForMwm(buffer, m_header.GetDefGeometryCodingParams());
@@ -307,29 +445,6 @@ public:
     }
   }
 
-private:
-  using Points = std::vector<m2::PointD>;
-  using Polygons = std::list<Points>;
-
-  class TmpFile
-  {
-    std::unique_ptr<FileWriter> m_writer;
-  public:
-    explicit TmpFile(std::string const & filePath)
-      : m_writer(std::make_unique<FileWriter>(filePath)) {}
-
-    FileWriter & GetWriter() { return *m_writer; }
-
-    ~TmpFile()
-    {
-      auto const name = m_writer->GetName();
-      m_writer.reset();
-      FileWriter::DeleteFileX(name);
-    }
-  };
-
-  using TmpFiles = std::vector<std::unique_ptr<TmpFile>>;
-
   bool IsCountry() const { return m_header.GetType() == feature::DataHeader::MapType::Country; }
 
   static void SimplifyPoints(int level, bool isCoast, m2::RectD const & rect, Points const & in, Points & out)
@@ -359,6 +474,11 @@ private:
 
   indexer::SynonymsHolder m_synonyms;
 
+  size_t m_maxPendingFeatures = 0;
+  std::queue<std::future<PreparedFeature>> m_pendingFeatures;
+  // The pool is the last member, so the tasks are finished before the other members are gone.
+  std::unique_ptr<base::ComputationalThreadPool> m_pool;
+
   DISALLOW_COPY_AND_MOVE(FeaturesCollector2);
 };
 
@@ -368,6 +488,13 @@ bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const
   std::string const srcFilePath = info.GetTmpFileName(name);
   std::string const dataFilePath = info.GetTargetFileName(name);
 
+  // Features are read below by their positions, it's impossible for the features of a block.
+  if (HasFeaturesBlocks(srcFilePath))
+  {
+    LOG(LINFO, ("Unpacking features blocks of", srcFilePath));
+    UnpackFeaturesBlocks(srcFilePath, info.m_threadsCount);
+  }
+
   LOG(LINFO, ("Calculating middle points"));
   // Store cellIds for middle points.
   CalculateMidPoints midPoints;
@@ -417,7 +544,7 @@ bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const
 
         FeatureBuilder fb;
         ReadFromSourceRawFormat(src, fb);
-        collector(fb);
+        collector(std::move(fb));
       }
 
       LOG(LINFO, ("Writing features' data to", dataFilePath));
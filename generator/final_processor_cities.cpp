@@ -10,10 +10,9 @@ namespace generator
 
 FinalProcessorCities::FinalProcessorCities(AffiliationInterfacePtr const & affiliation,
                                            std::string const & mwmPath, size_t threadsCount)
-  : FinalProcessorIntermediateMwmInterface(FinalProcessorPriority::Places)
+  : FinalProcessorIntermediateMwmInterface(FinalProcessorPriority::Places, threadsCount)
   , m_temporaryMwmPath(mwmPath)
   , m_affiliation(affiliation)
-  , m_threadsCount(threadsCount)
 {
 }
 
@@ -31,7 +30,7 @@ void FinalProcessorCities::Process()
       return;
 
     std::vector<FeatureBuilder> cities;
-    FeatureBuilderWriter writer(path, true /* mangleName */);
+    FeaturesBlockWriter writer(path, m_blockOptions, true /* mangleName */);
     ForEachFeatureRawFormat(path, [&](FeatureBuilder && fb, uint64_t)
     {
       if (localityChecker.GetType(fb.GetTypes()) < ftypes::LocalityType::City)
@@ -65,4 +64,6 @@ void FinalProcessorCities::Process()
   }
 }
 
+std::string FinalProcessorCities::GetName() const { return "Places"; }
+
 } // namespace generator
@@ -1,7 +1,11 @@
 #pragma once
 #include "generator/affiliation.hpp"
+#include "generator/feature_builder.hpp"
 #include "generator/final_processor_interface.hpp"
 
+#include <string>
+#include <vector>
+
 namespace generator
 {
 
@@ -16,13 +20,20 @@ public:
     m_boundariesCollectorFile = collectorFile;
     m_boundariesOutFile = boundariesOutFile;
   }
+  // The rewritten country files keep the blocks of RawGeneratorWriter.
+  void SetFeaturesBlockOptions(feature::FeaturesBlockOptions const & options)
+  {
+    m_blockOptions = options;
+  }
 
-  void Process();
+  // FinalProcessorIntermediateMwmInterface overrides:
+  void Process() override;
+  std::string GetName() const override;
 
 private:
   std::string m_temporaryMwmPath, m_boundariesCollectorFile, m_boundariesOutFile;
   AffiliationInterfacePtr m_affiliation;
-  size_t m_threadsCount;
+  feature::FeaturesBlockOptions m_blockOptions;
 };
 
 } // namespace generator
@@ -9,8 +9,8 @@ namespace generator
 using namespace feature;
 
 CoastlineFinalProcessor::CoastlineFinalProcessor(std::string const & filename, size_t threadsCount)
-  : FinalProcessorIntermediateMwmInterface(FinalProcessorPriority::WorldCoasts)
-  , m_filename(filename), m_threadsCount(threadsCount)
+  : FinalProcessorIntermediateMwmInterface(FinalProcessorPriority::WorldCoasts, threadsCount)
+  , m_filename(filename)
 {
 }
 
@@ -26,7 +26,7 @@ void CoastlineFinalProcessor::Process()
   ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(m_filename, [this](FeatureBuilder const & fb, uint64_t)
   {
     m_generator.Process(fb);
-  });
+  }, m_threadsCount);
 
   FeaturesAndRawGeometryCollector collector(m_coastlineGeomFilename, m_coastlineRawGeomFilename);
   // Check and stop if some coasts were not merged.
@@ -46,4 +46,6 @@ void CoastlineFinalProcessor::Process()
 
   LOG(LINFO, ("Total features:", totalFeatures, "total polygons:", totalPolygons, "total points:", totalPoints));
 }
+
+std::string CoastlineFinalProcessor::GetName() const { return "Coastline"; }
 }  // namespace generator
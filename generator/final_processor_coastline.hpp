@@ -4,6 +4,7 @@
 #include "generator/final_processor_interface.hpp"
 
 #include <string>
+#include <vector>
 
 namespace generator
 {
@@ -17,10 +18,10 @@ public:
 
   // FinalProcessorIntermediateMwmInterface overrides:
   void Process() override;
+  std::string GetName() const override;
 
 private:
   std::string m_filename;
-  size_t m_threadsCount;
   std::string m_coastlineGeomFilename;
   std::string m_coastlineRawGeomFilename;
   CoastlineFeaturesGenerator m_generator;
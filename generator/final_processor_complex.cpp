@@ -15,10 +15,9 @@ namespace generator
 {
 ComplexFinalProcessor::ComplexFinalProcessor(std::string const & mwmTmpPath,
                                              std::string const & outFilename, size_t threadsCount)
-  : FinalProcessorIntermediateMwmInterface(FinalProcessorPriority::Complex)
+  : FinalProcessorIntermediateMwmInterface(FinalProcessorPriority::Complex, threadsCount)
   , m_mwmTmpPath(mwmTmpPath)
   , m_outFilename(outFilename)
-  , m_threadsCount(threadsCount)
 {
 }
 
@@ -160,6 +159,8 @@ ComplexFinalProcessor::RemoveRelationBuildingParts(std::vector<FeatureBuilder> &
   return buildingParts;
 }
 
+std::string ComplexFinalProcessor::GetName() const { return "Complex"; }
+
 void ComplexFinalProcessor::WriteLines(std::vector<HierarchyEntry> const & lines)
 {
   auto stream = OfstreamWithExceptions(m_outFilename);
@@ -34,6 +34,7 @@ public:
 
   // FinalProcessorIntermediateMwmInterface overrides:
   void Process() override;
+  std::string GetName() const override;
 
 private:
   std::unique_ptr<hierarchy::HierarchyEntryEnricher> CreateEnricher(
@@ -53,6 +54,5 @@ private:
   std::string m_mwmPath;
   std::string m_osm2ftPath;
   std::string m_buildingPartsFilename;
-  size_t m_threadsCount;
 };
 }  // namespace generator
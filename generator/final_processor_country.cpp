@@ -26,10 +26,9 @@ using namespace feature;
 
 CountryFinalProcessor::CountryFinalProcessor(AffiliationInterfacePtr affiliations,
                                              std::string const & temporaryMwmPath, size_t threadsCount)
-  : FinalProcessorIntermediateMwmInterface(FinalProcessorPriority::CountriesOrWorld)
+  : FinalProcessorIntermediateMwmInterface(FinalProcessorPriority::CountriesOrWorld, threadsCount)
   , m_temporaryMwmPath(temporaryMwmPath)
   , m_affiliations(std::move(affiliations))
-  , m_threadsCount(threadsCount)
 {
   ASSERT(m_affiliations, ());
 }
@@ -86,6 +85,8 @@ void CountryFinalProcessor::Process()
   //Finish();
 }
 
+std::string CountryFinalProcessor::GetName() const { return "Country"; }
+
 /*
 void CountryFinalProcessor::Order()
 {
@@ -123,7 +124,7 @@ void CountryFinalProcessor::ProcessRoundabouts()
     if (ReadRegionData(name, data))
       transformer.SetLeftHandTraffic(data.Get(RegionData::Type::RD_DRIVING) == "l");
 
-    FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path, true /* mangleName */);
+    FeaturesBlockWriter writer(path, m_blockOptions, true /* mangleName */);
     ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder && fb, uint64_t)
     {
       if (roundabouts.IsRoadExists(fb))
@@ -248,7 +249,7 @@ void CountryFinalProcessor::ProcessBuildingParts()
       }
     });
 
-    FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path, true /* mangleName */);
+    FeaturesBlockWriter writer(path, m_blockOptions, true /* mangleName */);
     ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder && fb, uint64_t)
     {
       if (fb.IsArea() &&
@@ -282,7 +283,8 @@ void CountryFinalProcessor::AddIsolines()
 void CountryFinalProcessor::ProcessCoastline()
 {
   /// @todo We can remove MinSize at all.
-  auto fbs = ReadAllDatRawFormat<serialization_policy::MaxAccuracy>(m_coastlineGeomFilename);
+  auto fbs = ReadAllDatRawFormat<serialization_policy::MaxAccuracy>(m_coastlineGeomFilename,
+                                                                  m_threadsCount);
 
   auto const affiliations = AppendToMwmTmp(fbs, *m_affiliations, m_temporaryMwmPath, m_threadsCount);
   FeatureBuilderWriter<> collector(m_worldCoastsFilename);
@@ -318,7 +320,7 @@ void CountryFinalProcessor::DropProhibitedSpeedCameras()
     if (!routing::AreSpeedCamerasProhibited(platform::CountryFile(country)))
       return;
 
-    FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path, true /* mangleName */);
+    FeaturesBlockWriter writer(path, m_blockOptions, true /* mangleName */);
     ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder const & fb, uint64_t)
     {
       // Removing point features with speed cameras type from geometry index for some countries.
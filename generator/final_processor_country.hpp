@@ -1,9 +1,11 @@
 #pragma once
 
 #include "generator/affiliation.hpp"
+#include "generator/feature_builder.hpp"
 #include "generator/final_processor_interface.hpp"
 
 #include <string>
+#include <vector>
 
 namespace generator
 {
@@ -20,6 +22,11 @@ public:
   void SetMiniRoundabouts(std::string const & filename);
   void SetAddrInterpolation(std::string const & filename);
   void SetIsolinesDir(std::string const & dir);
+  // The rewritten country files keep the blocks of RawGeneratorWriter.
+  void SetFeaturesBlockOptions(feature::FeaturesBlockOptions const & options)
+  {
+    m_blockOptions = options;
+  }
 
   void SetCityBoundariesFiles(std::string const & collectorFile)
   {
@@ -28,6 +35,7 @@ public:
 
   // FinalProcessorIntermediateMwmInterface overrides:
   void Process() override;
+  std::string GetName() const override;
 
   void ProcessBuildingParts();
 
@@ -56,7 +64,6 @@ private:
   std::string m_hierarchySrcFilename;
 
   AffiliationInterfacePtr m_affiliations;
-
-  size_t m_threadsCount;
+  feature::FeaturesBlockOptions m_blockOptions;
 };
 }  // namespace generator
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <string>
 
 namespace generator
 {
@@ -16,18 +19,28 @@ enum class FinalProcessorPriority : uint8_t
 // Each derived class has a priority. This is done to comply with the order of processing
 // intermediate mwm, taking into account the dependencies between them. For example, before adding a
 // coastline to a country, we must build coastline. Processors with higher priority will be called
-// first. Processors with the same priority can run in parallel.
+// first. Processors with declared dependencies run in parallel, see FinalProcessorScheduler.
 class FinalProcessorIntermediateMwmInterface
 {
 public:
-  explicit FinalProcessorIntermediateMwmInterface(FinalProcessorPriority priority)
-    : m_priority(priority)
+  explicit FinalProcessorIntermediateMwmInterface(FinalProcessorPriority priority,
+                                                  size_t threadsCount = 1)
+    : m_priority(priority), m_threadsCount(threadsCount)
   {
   }
   virtual ~FinalProcessorIntermediateMwmInterface() = default;
 
   virtual void Process() = 0;
 
+  // Name for the logs.
+  virtual std::string GetName() const { return "Custom"; }
+
+  // Max number of threads for Process(). FinalProcessorScheduler sets the share of its threads
+  // before Process().
+  void SetThreadsCount(size_t threadsCount) { m_threadsCount = threadsCount; }
+  // Max number of threads which Process() uses, the scheduler doesn't give more to it.
+  virtual size_t GetMaxThreadsCount() const { return std::numeric_limits<size_t>::max(); }
+
   bool operator<(FinalProcessorIntermediateMwmInterface const & other) const
   {
     return m_priority < other.m_priority;
@@ -35,6 +48,7 @@ public:
 
 protected:
   FinalProcessorPriority m_priority;
+  size_t m_threadsCount;
 };
 
 }  // namespace generator
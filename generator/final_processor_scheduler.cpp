@@ -0,0 +1,186 @@
+#include "generator/final_processor_scheduler.hpp"
+
+#include "generator/stage_profiler.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <queue>
+#include <utility>
+
+namespace generator
+{
+FinalProcessorScheduler::FinalProcessorScheduler(size_t threadsCount)
+  : m_threadsCount(threadsCount)
+{
+  CHECK_GREATER(m_threadsCount, 0, ());
+}
+
+void FinalProcessorScheduler::Add(FinalProcessorPtr const & processor)
+{
+  CHECK(processor, ());
+  m_entries.push_back({processor, {}, true /* waitsForAll */});
+}
+
+void FinalProcessorScheduler::Add(FinalProcessorPtr const & processor,
+                                  std::vector<FinalProcessorPtr> const & dependencies)
+{
+  CHECK(processor, ());
+  m_entries.push_back({processor, dependencies, false /* waitsForAll */});
+}
+
+void FinalProcessorScheduler::Run()
+{
+  // The processors are run once.
+  auto entries = std::move(m_entries);
+  m_entries.clear();
+  if (entries.empty())
+    return;
+
+  // Higher priority goes first, the processors of the same priority keep the order of addition.
+  std::stable_sort(entries.begin(), entries.end(), [](Entry const & lhs, Entry const & rhs) {
+    return *rhs.m_processor < *lhs.m_processor;
+  });
+
+  size_t const count = entries.size();
+  std::vector<size_t> dependenciesCount(count, 0);
+  std::vector<std::vector<size_t>> dependents(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    auto const & entry = entries[i];
+    for (size_t j = 0; j < i; ++j)
+    {
+      auto const & deps = entry.m_dependencies;
+      if (entry.m_waitsForAll || entries[j].m_waitsForAll ||
+          std::find(deps.begin(), deps.end(), entries[j].m_processor) != deps.end())
+      {
+        ++dependenciesCount[i];
+        dependents[j].emplace_back(i);
+      }
+    }
+
+    for (auto const & dependency : entry.m_dependencies)
+    {
+      auto const it = std::find_if(entries.begin(), entries.begin() + i, [&](Entry const & e) {
+        return e.m_processor == dependency;
+      });
+      CHECK(it != entries.begin() + i, ("Final processor", entry.m_processor->GetName(),
+                                        "depends on a processor which is not added before it."));
+    }
+  }
+
+  base::Timer timer;
+  std::mutex mutex;
+  std::condition_variable cv;
+  // Indices of the finished processors with their exceptions.
+  std::queue<std::pair<size_t, std::exception_ptr>> finished;
+  // Indices of the processors which wait only for the threads.
+  std::deque<size_t> ready;
+  std::vector<size_t> threadsCounts(count, 0);
+  size_t freeThreadsCount = m_threadsCount;
+  size_t running = 0;
+  // A processor takes at least one thread, so no more than |m_threadsCount| processors run at once.
+  // The pool is declared after the state which is used by the tasks.
+  base::ComputationalThreadPool pool(std::min(m_threadsCount, count));
+
+  auto const run = [&](size_t i) {
+    auto & processor = *entries[i].m_processor;
+    // The free threads are shared equally between the ready processors, the threads which
+    // a processor can't use are left to the next ones.
+    threadsCounts[i] = std::min(std::max(size_t{1}, freeThreadsCount / ready.size()),
+                                std::max(size_t{1}, processor.GetMaxThreadsCount()));
+    freeThreadsCount -= threadsCounts[i];
+    ++running;
+
+    processor.SetThreadsCount(threadsCounts[i]);
+    pool.Submit([&, i]() {
+      LOG(LINFO, ("Final processor", processor.GetName(), "is started with", threadsCounts[i],
+                  "threads."));
+
+      base::Timer processorTimer;
+      std::exception_ptr error;
+      try
+      {
+        processor.Process();
+
+        StageMetrics metrics;
+        metrics.m_seconds = processorTimer.ElapsedSeconds();
+        StageProfiler::Instance().Add(StageProfiler::Kind::FinalProcessor, processor.GetName(),
+                                      metrics);
+        LOG(LINFO, ("Final processor", processor.GetName(), "is finished in", metrics.m_seconds,
+                    "seconds."));
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+
+      std::lock_guard lock(mutex);
+      finished.emplace(i, error);
+      cv.notify_one();
+    });
+  };
+
+  auto const runReady = [&]() {
+    // The processors with fewer threads go first, so their unused shares go to the others.
+    std::stable_sort(ready.begin(), ready.end(), [&](size_t lhs, size_t rhs) {
+      return entries[lhs].m_processor->GetMaxThreadsCount() <
+             entries[rhs].m_processor->GetMaxThreadsCount();
+    });
+    while (!ready.empty() && freeThreadsCount != 0)
+    {
+      run(ready.front());
+      ready.pop_front();
+    }
+  };
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (dependenciesCount[i] == 0)
+      ready.push_back(i);
+  }
+  runReady();
+
+  std::exception_ptr error;
+  while (running != 0)
+  {
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [&finished]() { return !finished.empty(); });
+    auto const [i, processorError] = finished.front();
+    finished.pop();
+    lock.unlock();
+
+    --running;
+    freeThreadsCount += threadsCounts[i];
+    if (processorError)
+    {
+      LOG(LERROR, ("Final processor", entries[i].m_processor->GetName(), "failed."));
+      if (!error)
+        error = processorError;
+    }
+
+    // Nothing new is run after a failure, only the running processors are waited for.
+    if (error)
+      continue;
+
+    for (auto const j : dependents[i])
+    {
+      if (--dependenciesCount[j] == 0)
+        ready.push_back(j);
+    }
+    runReady();
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+
+  LOG(LINFO, ("Final processing took", timer.ElapsedSeconds(), "seconds."));
+}
+}  // namespace generator
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "generator/final_processor_interface.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace generator
+{
+// Runs the final processors in the order of their priorities, as one by one run did. But a
+// processor with declared dependencies waits only for them, so independent processors run
+// in parallel. The processors which run at once share |threadsCount| threads, see
+// FinalProcessorIntermediateMwmInterface::SetThreadsCount().
+class FinalProcessorScheduler
+{
+public:
+  using FinalProcessorPtr = std::shared_ptr<FinalProcessorIntermediateMwmInterface>;
+
+  explicit FinalProcessorScheduler(size_t threadsCount);
+
+  // Adds a processor which waits for all the earlier processors, and all the later processors
+  // wait for it.
+  void Add(FinalProcessorPtr const & processor);
+  // Adds a processor which waits only for |dependencies| and for the earlier processors added
+  // without dependencies. |dependencies| must be added too and go earlier in the order of
+  // priorities.
+  void Add(FinalProcessorPtr const & processor, std::vector<FinalProcessorPtr> const & dependencies);
+
+  // Runs all the added processors and waits for them. An exception of a processor is rethrown
+  // when all the running processors are finished, the dependent processors are not run.
+  void Run();
+
+private:
+  struct Entry
+  {
+    FinalProcessorPtr m_processor;
+    std::vector<FinalProcessorPtr> m_dependencies;
+    // The processor is added without dependencies.
+    bool m_waitsForAll = false;
+  };
+
+  size_t m_threadsCount;
+  std::vector<Entry> m_entries;
+};
+}  // namespace generator
@@ -22,7 +22,8 @@ WorldFinalProcessor::WorldFinalProcessor(std::string const & temporaryMwmPath,
 
 void WorldFinalProcessor::Process()
 {
-  auto fbs = ReadAllDatRawFormat<serialization_policy::MaxAccuracy>(m_worldTmpFilename);
+  auto fbs = ReadAllDatRawFormat<serialization_policy::MaxAccuracy>(m_worldTmpFilename,
+                                                                  m_threadsCount);
   Order(fbs);
   WorldGenerator generator(m_worldTmpFilename, m_coastlineGeomFilename, m_popularPlacesFilename);
   LOG(LINFO, ("Process World features"));
@@ -33,4 +34,6 @@ void WorldFinalProcessor::Process()
   generator.DoMerge();
 }
 
+std::string WorldFinalProcessor::GetName() const { return "World"; }
+
 }  // namespace generator
@@ -5,6 +5,7 @@
 #include "generator/world_map_generator.hpp"
 
 #include <string>
+#include <vector>
 
 namespace generator
 {
@@ -23,6 +24,9 @@ public:
 
   // FinalProcessorIntermediateMwmInterface overrides:
   void Process() override;
+  std::string GetName() const override;
+  // The World features are processed one by one.
+  size_t GetMaxThreadsCount() const override { return 1; }
 
 private:
   std::string m_temporaryMwmPath;
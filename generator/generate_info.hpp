@@ -19,13 +19,15 @@ struct GenerateInfo
   {
     Memory,
     Index,
-    File
+    File,
+    Paged
   };
 
   enum class OsmSourceType
   {
     XML,
-    O5M
+    O5M,
+    PBF
   };
 
   // Directory for .mwm.tmp files.
@@ -48,6 +50,8 @@ struct GenerateInfo
   NodeStorageType m_nodeStorageType = NodeStorageType::Memory;
   OsmSourceType m_osmFileType = OsmSourceType::XML;
   std::string m_osmFileName;
+  // Threads for the sources which are decoded in parallel, e.g. pbf.
+  size_t m_threadsCount = 1;
 
   std::string m_brandsFilename;
   std::string m_brandsTranslationsFilename;
@@ -71,6 +75,9 @@ struct GenerateInfo
   bool m_failOnCoasts = false;
   bool m_preloadCache = false;
   bool m_verbose = false;
+  // Intermediate features of the countries are written as blocks, see FeaturesBlockOptions.
+  bool m_quantizeIntermediateFeatures = false;
+  bool m_compressIntermediateFeatures = false;
 
   GenerateInfo() = default;
 
@@ -80,6 +87,8 @@ struct GenerateInfo
       m_osmFileType = OsmSourceType::XML;
     else if (type == "o5m")
       m_osmFileType = OsmSourceType::O5M;
+    else if (type == "pbf")
+      m_osmFileType = OsmSourceType::PBF;
     else
       LOG(LCRITICAL, ("Unknown source type:", type));
   }
@@ -92,6 +101,8 @@ struct GenerateInfo
       m_nodeStorageType = NodeStorageType::Index;
     else if (type == "mem")
       m_nodeStorageType = NodeStorageType::Memory;
+    else if (type == "paged")
+      m_nodeStorageType = NodeStorageType::Paged;
     else
       LOG(LCRITICAL, ("Incorrect node_storage type:", type));
   }
@@ -10,9 +10,14 @@
 #include "indexer/feature_visibility.hpp"
 #include "indexer/ftypes_matcher.hpp"
 
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include "coding/byte_stream.hpp"
+
 #include "base/geo_object_id.hpp"
 
 #include <limits>
+#include <vector>
 
 namespace feature_builder_test
 {
@@ -242,6 +247,96 @@ UNIT_CLASS_TEST(TestWithClassificator, FBuilder_SerializeLocalityObjectForBuildi
   TEST(fb.PreSerializeAndRemoveUselessNamesForMwm(buffer), ());
 }
 
+UNIT_CLASS_TEST(TestWithClassificator, FBuilder_FeaturesBlocks)
+{
+  using platform::tests_support::ScopedFile;
+  using Writer = FeatureBuilderWriter<serialization_policy::MaxAccuracy>;
+
+  std::vector<FeatureBuilder> fbs;
+  for (uint64_t i = 0; i < 30; ++i)
+  {
+    auto const & c = classif();
+    FeatureBuilderParams params;
+    params.AddType(i % 2 == 0 ? c.GetTypeByPath({"highway", "primary"})
+                              : c.GetTypeByPath({"amenity", "cafe"}));
+    params.FinishAddingTypes();
+
+    FeatureBuilder fb;
+    fb.SetParams(params);
+    fb.AddOsmId(base::MakeOsmWay(i + 1));
+    m2::PointD const p(10.123456789 + i, -5.987654321 * i);
+    if (i % 2 == 0)
+    {
+      fb.AssignPoints({p, p + m2::PointD(0.1234567, 0.7654321), p + m2::PointD(0.5, 1.0)});
+      fb.SetLinear();
+    }
+    else
+    {
+      fb.SetCenter(p);
+    }
+    TEST(fb.IsValid(), (fb));
+    fbs.push_back(std::move(fb));
+  }
+
+  auto const makeBlock = [&](size_t begin, size_t end, FeaturesBlockOptions const & options) {
+    FeatureBuilder::Buffer records;
+    PushBackByteSink<FeatureBuilder::Buffer> sink(records);
+    for (size_t i = begin; i < end; ++i)
+      Writer::Write(sink, fbs[i]);
+    return MakeFeaturesBlock(records, options);
+  };
+
+  ScopedFile const file("features_blocks.mwm.tmp", ScopedFile::Mode::DoNotCreate);
+  auto const & path = file.GetFullPath();
+  {
+    // Single features and blocks of all kinds are mixed.
+    FileWriter writer(path);
+    for (size_t i = 0; i < 5; ++i)
+      Writer::Write(writer, fbs[i]);
+
+    FeaturesBlockOptions options;
+    options.m_quantize = true;
+    auto block = makeBlock(5, 15, options);
+    writer.Write(block.data(), block.size());
+
+    options.m_compress = true;
+    block = makeBlock(15, 20, options);
+    writer.Write(block.data(), block.size());
+
+    options.m_quantize = false;
+    block = makeBlock(20, 28, options);
+    writer.Write(block.data(), block.size());
+
+    for (size_t i = 28; i < fbs.size(); ++i)
+      Writer::Write(writer, fbs[i]);
+  }
+
+  TEST(HasFeaturesBlocks(path), ());
+  for (size_t threadsCount : {1, 3})
+    TEST_EQUAL(ReadAllDatRawFormat(path, threadsCount), fbs, (threadsCount));
+
+  UnpackFeaturesBlocks(path, 2 /* threadsCount */);
+  TEST(!HasFeaturesBlocks(path), ());
+  TEST_EQUAL(ReadAllDatRawFormat(path), fbs, ());
+
+  // A final processor rewrites the file in place.
+  auto const rewrite = [&](FeaturesBlockOptions const & options) {
+    FeaturesBlockWriter writer(path, options, true /* mangleName */);
+    ForEachFeatureRawFormat(path, [&](FeatureBuilder const & fb, uint64_t) { writer.Write(fb); });
+  };
+
+  FeaturesBlockOptions options;
+  options.m_quantize = true;
+  options.m_compress = true;
+  rewrite(options);
+  TEST(HasFeaturesBlocks(path), ());
+  TEST_EQUAL(ReadAllDatRawFormat(path), fbs, ());
+
+  rewrite({});
+  TEST(!HasFeaturesBlocks(path), ());
+  TEST_EQUAL(ReadAllDatRawFormat(path), fbs, ());
+}
+
 UNIT_TEST(LooksLikeHouseNumber)
 {
   TEST(FeatureParams::LooksLikeHouseNumber("1 bis"), ());
@@ -0,0 +1,217 @@
+#include "testing/testing.hpp"
+
+#include "generator/final_processor_scheduler.hpp"
+
+#include "base/logging.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace final_processor_scheduler_tests
+{
+using namespace generator;
+using namespace std;
+
+// Records the sequence numbers of the processors' starts and finishes.
+class Events
+{
+public:
+  void Start(string const & name) { Add(name, m_starts); }
+  void Finish(string const & name) { Add(name, m_finishes); }
+
+  bool IsRun(string const & name) const { return m_finishes.count(name) != 0; }
+
+  // Returns true if |later| is started after |earlier| is finished.
+  bool IsAfter(string const & later, string const & earlier) const
+  {
+    return m_starts.at(later) > m_finishes.at(earlier);
+  }
+
+private:
+  void Add(string const & name, map<string, size_t> & events)
+  {
+    lock_guard lock(m_mutex);
+    events[name] = m_counter++;
+  }
+
+  mutable mutex m_mutex;
+  size_t m_counter = 0;
+  map<string, size_t> m_starts;
+  map<string, size_t> m_finishes;
+};
+
+class TestProcessor : public FinalProcessorIntermediateMwmInterface
+{
+public:
+  TestProcessor(FinalProcessorPriority priority, string const & name, Events & events)
+    : FinalProcessorIntermediateMwmInterface(priority), m_name(name), m_events(events)
+  {
+  }
+
+  void SetAction(function<void()> const & action) { m_action = action; }
+
+  void SetMaxThreadsCount(size_t maxThreadsCount) { m_maxThreadsCount = maxThreadsCount; }
+  size_t GetThreadsCount() const { return m_threadsCount; }
+
+  // FinalProcessorIntermediateMwmInterface overrides:
+  void Process() override
+  {
+    m_events.Start(m_name);
+    if (m_action)
+      m_action();
+    m_events.Finish(m_name);
+  }
+
+  string GetName() const override { return m_name; }
+  size_t GetMaxThreadsCount() const override { return m_maxThreadsCount; }
+
+private:
+  string m_name;
+  size_t m_maxThreadsCount = numeric_limits<size_t>::max();
+  Events & m_events;
+  function<void()> m_action;
+};
+
+// The processors of RawGenerator with their dependencies.
+void AddGeneratorProcessors(FinalProcessorScheduler & scheduler, Events & events)
+{
+  auto const country =
+      make_shared<TestProcessor>(FinalProcessorPriority::CountriesOrWorld, "Country", events);
+  auto const places = make_shared<TestProcessor>(FinalProcessorPriority::Places, "Places", events);
+  auto const world =
+      make_shared<TestProcessor>(FinalProcessorPriority::CountriesOrWorld, "World", events);
+  auto const coastline =
+      make_shared<TestProcessor>(FinalProcessorPriority::WorldCoasts, "Coastline", events);
+
+  scheduler.Add(country, {coastline, places});
+  scheduler.Add(places, {});
+  scheduler.Add(world, {coastline, places});
+  scheduler.Add(coastline, {});
+}
+
+UNIT_TEST(FinalProcessorScheduler_Dependencies)
+{
+  for (size_t threadsCount : {1, 2, 4})
+  {
+    Events events;
+    FinalProcessorScheduler scheduler(threadsCount);
+    AddGeneratorProcessors(scheduler, events);
+    scheduler.Run();
+
+    TEST(events.IsAfter("Country", "Places"), (threadsCount));
+    TEST(events.IsAfter("Country", "Coastline"), (threadsCount));
+    TEST(events.IsAfter("World", "Places"), (threadsCount));
+    TEST(events.IsAfter("World", "Coastline"), (threadsCount));
+  }
+}
+
+UNIT_TEST(FinalProcessorScheduler_Parallel)
+{
+  Events events;
+  mutex mutex;
+  condition_variable cv;
+  bool coastlineStarted = false;
+
+  FinalProcessorScheduler scheduler(2 /* threadsCount */);
+  auto places = make_shared<TestProcessor>(FinalProcessorPriority::Places, "Places", events);
+  auto coastline =
+      make_shared<TestProcessor>(FinalProcessorPriority::WorldCoasts, "Coastline", events);
+  // Places is not finished until Coastline is started.
+  bool waited = false;
+  places->SetAction([&]() {
+    unique_lock lock(mutex);
+    waited = cv.wait_for(lock, chrono::seconds(10), [&]() { return coastlineStarted; });
+  });
+  coastline->SetAction([&]() {
+    lock_guard lock(mutex);
+    coastlineStarted = true;
+    cv.notify_one();
+  });
+
+  scheduler.Add(places, {});
+  scheduler.Add(coastline, {});
+  scheduler.Run();
+  TEST(waited, ());
+}
+
+UNIT_TEST(FinalProcessorScheduler_ThreadsBudget)
+{
+  Events events;
+  FinalProcessorScheduler scheduler(5 /* threadsCount */);
+  auto places = make_shared<TestProcessor>(FinalProcessorPriority::Places, "Places", events);
+  auto coastline =
+      make_shared<TestProcessor>(FinalProcessorPriority::WorldCoasts, "Coastline", events);
+  auto country =
+      make_shared<TestProcessor>(FinalProcessorPriority::CountriesOrWorld, "Country", events);
+  scheduler.Add(places, {});
+  scheduler.Add(coastline, {});
+  scheduler.Add(country, {places, coastline});
+  scheduler.Run();
+
+  // Places and Coastline share the threads, Country takes all of them.
+  TEST_EQUAL(places->GetThreadsCount(), 2, ());
+  TEST_EQUAL(coastline->GetThreadsCount(), 3, ());
+  TEST_EQUAL(country->GetThreadsCount(), 5, ());
+}
+
+UNIT_TEST(FinalProcessorScheduler_MaxThreadsCount)
+{
+  Events events;
+  FinalProcessorScheduler scheduler(8 /* threadsCount */);
+  auto coastline =
+      make_shared<TestProcessor>(FinalProcessorPriority::WorldCoasts, "Coastline", events);
+  auto country =
+      make_shared<TestProcessor>(FinalProcessorPriority::CountriesOrWorld, "Country", events);
+  auto world = make_shared<TestProcessor>(FinalProcessorPriority::CountriesOrWorld, "World", events);
+  world->SetMaxThreadsCount(1);
+  scheduler.Add(coastline, {});
+  scheduler.Add(country, {coastline});
+  scheduler.Add(world, {coastline});
+  scheduler.Run();
+
+  // World takes one thread, Country takes the rest of them.
+  TEST_EQUAL(world->GetThreadsCount(), 1, ());
+  TEST_EQUAL(country->GetThreadsCount(), 7, ());
+}
+
+UNIT_TEST(FinalProcessorScheduler_UndeclaredDependencies)
+{
+  Events events;
+  FinalProcessorScheduler scheduler(4 /* threadsCount */);
+  AddGeneratorProcessors(scheduler, events);
+  scheduler.Add(make_shared<TestProcessor>(FinalProcessorPriority::WorldCoasts, "Custom", events));
+  scheduler.Run();
+
+  TEST(events.IsAfter("Custom", "Places"), ());
+  TEST(events.IsAfter("Custom", "Coastline"), ());
+  TEST(events.IsAfter("Country", "Custom"), ());
+  TEST(events.IsAfter("World", "Custom"), ());
+}
+
+UNIT_TEST(FinalProcessorScheduler_Exception)
+{
+  // The failure of the processor is logged as an error.
+  base::ScopedLogAbortLevelChanger ignoreLogError(base::LogLevel::LCRITICAL);
+
+  Events events;
+  FinalProcessorScheduler scheduler(4 /* threadsCount */);
+  auto coastline =
+      make_shared<TestProcessor>(FinalProcessorPriority::WorldCoasts, "Coastline", events);
+  coastline->SetAction([]() { throw runtime_error("Coastline failure"); });
+  scheduler.Add(coastline, {});
+  scheduler.Add(
+      make_shared<TestProcessor>(FinalProcessorPriority::CountriesOrWorld, "Country", events),
+      {coastline});
+
+  TEST_ANY_THROW(scheduler.Run(), ());
+  TEST(!events.IsRun("Country"), ());
+}
+}  // namespace final_processor_scheduler_tests
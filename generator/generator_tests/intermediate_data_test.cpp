@@ -8,12 +8,18 @@
 
 #include "testing/testing.hpp"
 
+#include "generator/generate_info.hpp"
+#include "generator/intermediate_data.hpp"
 #include "generator/intermediate_elements.hpp"
 
+#include "platform/platform_tests_support/scoped_file.hpp"
+
 #include "coding/reader.hpp"
 #include "coding/writer.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -109,4 +115,57 @@ UNIT_TEST(Intermediate_Data_relation_element_save_load_test)
   TEST_NOT_EQUAL(e2.m_tags["key1old"], "value1old", ());
   TEST_NOT_EQUAL(e2.m_tags["key2old"], "value2old", ());
 }
+
+UNIT_TEST(Intermediate_Data_paged_point_storage_test)
+{
+  using platform::tests_support::ScopedFile;
+  using Type = feature::GenerateInfo::NodeStorageType;
+
+  ScopedFile const file("paged_nodes.dat", ScopedFile::Mode::DoNotCreate);
+
+  // Ids at the page bounds, far apart and the dense ones.
+  std::vector<uint64_t> ids = {0, 65535, 65536, 1000000, uint64_t{1} << 33};
+  for (uint64_t id = 200000; id < 300000; id += 3)
+    ids.push_back(id);
+
+  auto const getLat = [](uint64_t id) { return static_cast<double>(id % 1000) / 10.0 - 50.0; };
+  auto const getLon = [](uint64_t id) { return static_cast<double>(id % 777) / 7.0; };
+
+  {
+    std::vector<uint64_t> sortedIds = ids;
+    std::sort(sortedIds.begin(), sortedIds.end());
+
+    auto writer = generator::cache::CreatePointStorageWriter(Type::Paged, file.GetFullPath());
+    // Pages go in the order of ids, but the ids of a page may come in any order.
+    for (auto it = sortedIds.begin(); it != sortedIds.end();)
+    {
+      auto const page = *it >> 16;
+      auto const end =
+          std::find_if(it, sortedIds.end(), [page](uint64_t id) { return id >> 16 != page; });
+      for (auto rit = std::make_reverse_iterator(end); rit != std::make_reverse_iterator(it); ++rit)
+        writer->AddPoint(*rit, getLat(*rit), getLon(*rit));
+      it = end;
+    }
+
+    TEST_EQUAL(writer->GetNumProcessedPoints(), ids.size(), ());
+  }
+
+  auto const reader = generator::cache::CreatePointStorageReader(Type::Paged, file.GetFullPath());
+  for (auto const id : ids)
+  {
+    double lat = 0.0;
+    double lon = 0.0;
+    TEST(reader->GetPoint(id, lat, lon), (id));
+    TEST_ALMOST_EQUAL_ABS(lat, getLat(id), 1e-7, (id));
+    TEST_ALMOST_EQUAL_ABS(lon, getLon(id), 1e-7, (id));
+  }
+
+  std::vector<uint64_t> const absentIds = {1, 65537, 200001, 999999, 5000000, (uint64_t{1} << 33) + 1};
+  for (auto const id : absentIds)
+  {
+    double lat = 0.0;
+    double lon = 0.0;
+    TEST(!reader->GetPoint(id, lat, lon), (id));
+  }
+}
 }  // namespace intermediate_data_test
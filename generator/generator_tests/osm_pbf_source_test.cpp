@@ -0,0 +1,252 @@
+#include "testing/testing.hpp"
+
+#include "generator/generator_tests/source_data.hpp"
+#include "generator/osm_element.hpp"
+#include "generator/osm_source.hpp"
+
+#include "coding/zlib.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace osm_pbf_source_test
+{
+using namespace generator;
+using namespace std;
+
+// Minimal pbf writer, it produces the same wire format as osmium and osmosis do.
+class PbfWriter
+{
+public:
+  PbfWriter()
+  {
+    string header;
+    WriteBytes(header, 4, "OsmSchema-V0.6");
+    WriteBytes(header, 4, "DenseNodes");
+    WriteBlob("OSMHeader", header, false /* compress */);
+    // Blobs of unknown types are skipped.
+    WriteBlob("OSMIndex", "index", false /* compress */);
+  }
+
+  // Writes |elements| of the same type as a block.
+  void WriteBlock(vector<OsmElement> const & elements, bool compress)
+  {
+    map<string, uint64_t> strings = {{"", 0}};
+    auto const getIndex = [&strings](string const & s) {
+      return strings.emplace(s, strings.size()).first->second;
+    };
+
+    string group;
+    if (elements.front().IsNode())
+    {
+      vector<int64_t> ids, lats, lons;
+      vector<uint64_t> keysVals;
+      for (auto const & e : elements)
+      {
+        ids.push_back(static_cast<int64_t>(e.m_id));
+        lats.push_back(llround(e.m_lat * 1e7));
+        lons.push_back(llround(e.m_lon * 1e7));
+        for (auto const & tag : e.Tags())
+        {
+          keysVals.push_back(getIndex(tag.m_key));
+          keysVals.push_back(getIndex(tag.m_value));
+        }
+        keysVals.push_back(0);
+      }
+
+      string dense;
+      WritePacked(dense, 1, Deltas(ids));
+      WritePacked(dense, 8, Deltas(lats));
+      WritePacked(dense, 9, Deltas(lons));
+      WritePacked(dense, 10, keysVals);
+      WriteBytes(group, 2, dense);
+    }
+    else
+    {
+      for (auto const & e : elements)
+      {
+        string message;
+        WriteVarintField(message, 1, e.m_id);
+
+        vector<uint64_t> keys, vals;
+        for (auto const & tag : e.Tags())
+        {
+          keys.push_back(getIndex(tag.m_key));
+          vals.push_back(getIndex(tag.m_value));
+        }
+        WritePacked(message, 2, keys);
+        WritePacked(message, 3, vals);
+
+        if (e.IsWay())
+        {
+          vector<int64_t> refs(e.Nodes().begin(), e.Nodes().end());
+          WritePacked(message, 8, Deltas(refs));
+          WriteBytes(group, 3, message);
+        }
+        else
+        {
+          vector<uint64_t> roles, types;
+          vector<int64_t> refs;
+          for (auto const & member : e.Members())
+          {
+            roles.push_back(getIndex(member.m_role));
+            refs.push_back(static_cast<int64_t>(member.m_ref));
+            types.push_back(member.m_type == OsmElement::EntityType::Node ? 0
+                            : member.m_type == OsmElement::EntityType::Way ? 1 : 2);
+          }
+          WritePacked(message, 8, roles);
+          WritePacked(message, 9, Deltas(refs));
+          WritePacked(message, 10, types);
+          WriteBytes(group, 4, message);
+        }
+      }
+    }
+
+    vector<string> table(strings.size());
+    for (auto const & [s, index] : strings)
+      table[index] = s;
+    string stringTable;
+    for (auto const & s : table)
+      WriteBytes(stringTable, 1, s);
+
+    string block;
+    WriteBytes(block, 1, stringTable);
+    WriteBytes(block, 2, group);
+    WriteVarintField(block, 17, 100 /* granularity */);
+    WriteBlob("OSMData", block, compress);
+  }
+
+  string const & GetData() const { return m_data; }
+
+private:
+  static void WriteVarint(string & out, uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+  }
+
+  static void WriteVarintField(string & out, uint32_t field, uint64_t value)
+  {
+    WriteVarint(out, field << 3);
+    WriteVarint(out, value);
+  }
+
+  static void WriteBytes(string & out, uint32_t field, string const & bytes)
+  {
+    WriteVarint(out, (field << 3) | 2);
+    WriteVarint(out, bytes.size());
+    out += bytes;
+  }
+
+  static void WritePacked(string & out, uint32_t field, vector<uint64_t> const & values)
+  {
+    string packed;
+    for (auto const value : values)
+      WriteVarint(packed, value);
+    WriteBytes(out, field, packed);
+  }
+
+  static vector<uint64_t> Deltas(vector<int64_t> const & values)
+  {
+    vector<uint64_t> deltas;
+    int64_t prev = 0;
+    for (auto const value : values)
+    {
+      auto const delta = value - prev;
+      deltas.push_back((static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+      prev = value;
+    }
+    return deltas;
+  }
+
+  void WriteBlob(string const & type, string const & data, bool compress)
+  {
+    string blob;
+    if (compress)
+    {
+      string compressed;
+      coding::ZLib::Deflate const deflate(coding::ZLib::Deflate::Format::ZLib,
+                                          coding::ZLib::Deflate::Level::BestCompression);
+      TEST(deflate(data, back_inserter(compressed)), ());
+      WriteVarintField(blob, 2, data.size());
+      WriteBytes(blob, 3, compressed);
+    }
+    else
+    {
+      WriteBytes(blob, 1, data);
+    }
+
+    string header;
+    WriteBytes(header, 1, type);
+    WriteVarintField(header, 3, blob.size());
+
+    for (int shift = 24; shift >= 0; shift -= 8)
+      m_data.push_back(static_cast<char>((header.size() >> shift) & 0xFF));
+    m_data += header;
+    m_data += blob;
+  }
+
+  string m_data;
+};
+
+vector<OsmElement> ReadXml(char const * xml)
+{
+  istringstream ss(xml);
+  SourceReader reader(ss);
+  vector<OsmElement> elements;
+  ProcessOsmElementsFromXML(reader, [&elements](OsmElement && e) { elements.push_back(move(e)); });
+  return elements;
+}
+
+vector<OsmElement> ReadPbf(string const & pbf, size_t threadsCount)
+{
+  istringstream ss(pbf);
+  SourceReader reader(ss);
+  vector<OsmElement> elements;
+  ProcessOsmElementsFromPbf(reader, [&elements](OsmElement && e) { elements.push_back(move(e)); },
+                            threadsCount);
+  return elements;
+}
+
+UNIT_TEST(Source_To_Element_check_pbf_equivalence)
+{
+  auto const elementsXML = ReadXml(relation_xml_data);
+
+  // Every run of the elements of the same type is a block, blocks are compressed by turns.
+  PbfWriter writer;
+  vector<OsmElement> block;
+  bool compress = false;
+  for (size_t i = 0; i < elementsXML.size(); ++i)
+  {
+    block.push_back(elementsXML[i]);
+    if (i + 1 == elementsXML.size() || elementsXML[i + 1].m_type != elementsXML[i].m_type)
+    {
+      writer.WriteBlock(block, compress);
+      block.clear();
+      compress = !compress;
+    }
+  }
+
+  for (size_t threadsCount : {1, 3})
+  {
+    auto const elementsPbf = ReadPbf(writer.GetData(), threadsCount);
+    TEST_EQUAL(elementsXML, elementsPbf, (threadsCount));
+  }
+}
+
+UNIT_TEST(Source_To_Element_pbf_empty)
+{
+  PbfWriter writer;
+  TEST(ReadPbf(writer.GetData(), 2 /* threadsCount */).empty(), ());
+  TEST(ReadPbf({}, 2 /* threadsCount */).empty(), ());
+}
+}  // namespace osm_pbf_source_test
@@ -13,6 +13,8 @@
 #include "indexer/feature_algo.hpp"
 #include "indexer/ftypes_matcher.hpp"
 
+#include "coding/file_reader.hpp"
+
 namespace raw_generator_tests
 {
 using TestRawGenerator = generator::tests_support::TestRawGenerator;
@@ -465,6 +467,12 @@ UNIT_CLASS_TEST(TestRawGenerator, Building_Address)
 
       auto street = guard.GetFeatureByIndex(res->m_streetId);
       TEST_EQUAL(street->GetName(StringUtf8Multilang::kDefaultCode), "Airport Boulevard", ());
+
+      auto const street2houses = search::LoadStreetToHousesTable(*value);
+      TEST(street2houses, ());
+      std::vector<uint32_t> houses;
+      TEST(street2houses->Get(res->m_streetId, houses), ());
+      TEST(std::binary_search(houses.begin(), houses.end(), id), (houses));
     }
   }
 
@@ -1200,4 +1208,57 @@ UNIT_CLASS_TEST(TestRawGenerator, Railway_Station)
   TEST_EQUAL(count, 1, ());
 }
 
+UNIT_CLASS_TEST(TestRawGenerator, SearchIndex_ThreadsCount)
+{
+  std::string const mwmName = "Postcodes";
+  BuildFB("./data/osm_test_data/postcode_relations.osm", mwmName);
+  BuildFeatures(mwmName);
+
+  auto const readSection = [&](std::string const & tag)
+  {
+    FilesContainerR cont(GetMwmPath(mwmName));
+    auto const reader = cont.GetReader(tag);
+    std::vector<uint8_t> data(reader.Size());
+    reader.Read(0, data.data(), data.size());
+    return data;
+  };
+
+  // The index which is built in parallel is exactly the same.
+  BuildSearch(mwmName, 1 /* threadsCount */);
+  auto const index = readSection(SEARCH_INDEX_FILE_TAG);
+  auto const postings = readSection(TYPES_POSTINGS_FILE_TAG);
+  TEST(!index.empty(), ());
+
+  for (uint32_t threadsCount : {2, 3, 8})
+  {
+    BuildSearch(mwmName, threadsCount);
+    TEST(readSection(SEARCH_INDEX_FILE_TAG) == index, (threadsCount));
+    TEST(readSection(TYPES_POSTINGS_FILE_TAG) == postings, (threadsCount));
+  }
+}
+
+UNIT_CLASS_TEST(TestRawGenerator, Features_ThreadsCount)
+{
+  std::string const mwmName = "Links";
+  BuildFB("./data/osm_test_data/highway_links.osm", mwmName);
+
+  auto const readMwm = [&]()
+  {
+    std::string data;
+    FileReader(GetMwmPath(mwmName)).ReadAsString(data);
+    return data;
+  };
+
+  // The mwm whose geometry is prepared in parallel is exactly the same.
+  BuildFeatures(mwmName, 1 /* threadsCount */);
+  auto const mwm = readMwm();
+  TEST(!mwm.empty(), ());
+
+  for (size_t threadsCount : {2, 3, 8})
+  {
+    BuildFeatures(mwmName, threadsCount);
+    TEST(readMwm() == mwm, (threadsCount));
+  }
+}
+
 } // namespace raw_generator_tests
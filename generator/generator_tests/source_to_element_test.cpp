@@ -73,3 +73,31 @@ UNIT_TEST(Source_To_Element_check_equivalence)
     TEST_EQUAL(elementsXML[i], elementsO5M[i], ());
   }
 }
+
+UNIT_TEST(Source_To_Element_o5m_ranges_equivalence)
+{
+  std::string const src(std::begin(relation_o5m_data), std::end(relation_o5m_data));
+  auto const read = [&src](size_t threadsCount, size_t rangeSize, size_t maxRangeSize) {
+    std::istringstream ss(src);
+    SourceReader reader(ss);
+    ProcessorOsmElementsFromO5M processor(reader, threadsCount, rangeSize, maxRangeSize);
+
+    std::vector<OsmElement> elements;
+    OsmElement element;
+    while (processor.TryRead(element))
+    {
+      elements.push_back(std::move(element));
+      element.Clear();
+    }
+    return elements;
+  };
+
+  auto const sequential = read(1 /* threadsCount */, 0 /* rangeSize */, 0 /* maxRangeSize */);
+  TEST_EQUAL(sequential.size(), 11, ());
+
+  // Nodes, the way and the relation are separated by resets, so every range is a single type.
+  TEST_EQUAL(read(3 /* threadsCount */, 1 /* rangeSize */, 1000 /* maxRangeSize */), sequential, ());
+  TEST_EQUAL(read(3 /* threadsCount */, 1000 /* rangeSize */, 1000 /* maxRangeSize */), sequential, ());
+  // There are no resets within the nodes, so they are decoded sequentially.
+  TEST_EQUAL(read(3 /* threadsCount */, 1 /* rangeSize */, 50 /* maxRangeSize */), sequential, ());
+}
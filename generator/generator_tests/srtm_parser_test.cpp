@@ -2,6 +2,13 @@
 
 #include "generator/srtm_parser.hpp"
 
+#include "platform/platform.hpp"
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
 using namespace generator;
 
 namespace
@@ -25,4 +32,80 @@ UNIT_TEST(FilenameTests)
   name = GetBase({-34.622358, -58.383654});
   TEST_EQUAL(name, "S35W059", ());
 }
+
+size_t constexpr kTileSide = 3601;
+
+// Returns the coordinates of the position |row|, |col| of the N00E000 tile.
+ms::LatLon GetCoord(double row, double col) { return {1.0 - row / 3600.0, col / 3600.0}; }
+
+// Writes the N00E000 tile where the height is 2 * row + 3 * col, except one void.
+platform::tests_support::ScopedFile WriteTile()
+{
+  std::string data(kTileSide * kTileSide * sizeof(geometry::Altitude), 0);
+  for (size_t row = 0; row < kTileSide; ++row)
+  {
+    for (size_t col = 0; col < kTileSide; ++col)
+    {
+      auto height = static_cast<uint16_t>(2 * row + 3 * col);
+      if (row == 100 && col == 100)
+        height = static_cast<uint16_t>(geometry::kInvalidAltitude);
+      // The heights are big-endian.
+      size_t const ix = (row * kTileSide + col) * sizeof(geometry::Altitude);
+      data[ix] = static_cast<char>(height >> 8);
+      data[ix + 1] = static_cast<char>(height & 0xFF);
+    }
+  }
+  return platform::tests_support::ScopedFile("N00E000.hgt", data);
+}
+
+UNIT_TEST(SrtmTile_Heights)
+{
+  auto const tileFile = WriteTile();
+  SrtmTileManager manager(GetPlatform().WritableDir());
+  auto const tile = manager.GetTile(GetCoord(1800, 1800));
+  TEST(tile->IsValid(), ());
+
+  TEST_EQUAL(tile->GetHeight(GetCoord(1800, 1800)), 9000, ());
+  TEST_EQUAL(tile->GetHeight(GetCoord(10.25, 20.25)), 80, ());
+  TEST_EQUAL(tile->GetBilinearHeight(GetCoord(10.25, 20.25)), 81, ());
+  TEST_EQUAL(tile->GetBilinearHeight(GetCoord(3600, 3599.75)), 17999, ());
+  // The nearest sample is taken next to a void.
+  TEST_EQUAL(tile->GetBilinearHeight(GetCoord(99.25, 99.25)), 495, ());
+  TEST_EQUAL(tile->GetBilinearHeight(GetCoord(100.25, 100.25)), geometry::kInvalidAltitude, ());
+
+  // The coords of the tile are mixed with the coords of an absent tile.
+  std::vector<ms::LatLon> coords;
+  std::vector<geometry::Altitude> expected;
+  for (size_t i = 1; i <= 100; ++i)
+  {
+    coords.push_back(GetCoord(i * 35.5, 3600.0 - i * 17.25));
+    expected.push_back(tile->GetBilinearHeight(coords.back()));
+    coords.push_back({-0.5, -0.5 - i * 0.001});
+    expected.push_back(geometry::kInvalidAltitude);
+  }
+
+  for (size_t threadsCount : {1, 4})
+  {
+    std::vector<geometry::Altitude> heights;
+    manager.GetHeights(coords, heights, threadsCount);
+    TEST_EQUAL(heights, expected, (threadsCount));
+  }
+}
+
+UNIT_TEST(SrtmTileManager_Eviction)
+{
+  auto const tileFile = WriteTile();
+  SrtmTileManager manager(GetPlatform().WritableDir(), 1 /* maxCacheBytes */);
+
+  auto const tile = manager.GetTile(GetCoord(1800, 1800));
+  TEST_EQUAL(manager.GetTilesCount(), 1, ());
+
+  // The tile is evicted by the absent one, but it stays valid while it is referenced.
+  TEST_EQUAL(manager.GetHeight({-0.5, -0.5}), geometry::kInvalidAltitude, ());
+  TEST_EQUAL(manager.GetTilesCount(), 1, ());
+  TEST_EQUAL(tile->GetHeight(GetCoord(1800, 1800)), 9000, ());
+
+  TEST_EQUAL(manager.GetHeight(GetCoord(1800, 1800)), 9000, ());
+  TEST_EQUAL(manager.GetTilesCount(), 1, ());
+}
 }  // namespace
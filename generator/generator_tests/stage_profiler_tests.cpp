@@ -0,0 +1,108 @@
+#include "testing/testing.hpp"
+
+#include "generator/collector_collection.hpp"
+#include "generator/collector_interface.hpp"
+#include "generator/filter_interface.hpp"
+#include "generator/osm_element.hpp"
+#include "generator/stage_profiler.hpp"
+
+#include "cppjansson/cppjansson.hpp"
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace stage_profiler_tests
+{
+using namespace generator;
+using namespace std;
+
+class TestCollector : public CollectorInterface
+{
+public:
+  // CollectorInterface overrides:
+  shared_ptr<CollectorInterface> Clone(IDRInterfacePtr const & = {}) const override
+  {
+    return make_shared<TestCollector>();
+  }
+
+  void Collect(OsmElement const &) override { ++m_count; }
+  void Save() override {}
+
+  IMPLEMENT_COLLECTOR_IFACE(TestCollector);
+  void MergeInto(TestCollector & collector) const { collector.m_count += m_count; }
+
+  size_t m_count = 0;
+};
+
+class TestFilter : public FilterInterface
+{
+public:
+  // FilterInterface overrides:
+  shared_ptr<FilterInterface> Clone() const override { return make_shared<TestFilter>(); }
+
+  bool IsAccepted(OsmElement const & element) const override { return element.IsNode(); }
+};
+
+OsmElement MakeElement(OsmElement::EntityType type)
+{
+  OsmElement element;
+  element.m_type = type;
+  return element;
+}
+
+// Returns the elements count of the stage from the profiler's report.
+optional<uint64_t> GetElementsCount(string const & kind, string const & name)
+{
+  base::Json const report(StageProfiler::Instance().GetJsonReport());
+  auto const * stages = json_object_get(report.get(), "stages");
+  TEST(stages, ());
+  for (size_t i = 0; i < json_array_size(stages); ++i)
+  {
+    auto const * stage = json_array_get(stages, i);
+    if (json_string_value(json_object_get(stage, "kind")) != kind)
+      continue;
+    if (json_string_value(json_object_get(stage, "name")) != name)
+      continue;
+    return json_integer_value(json_object_get(stage, "elements"));
+  }
+  return {};
+}
+
+UNIT_TEST(StageProfiler_Collectors)
+{
+  StageProfiler::Instance().Enable();
+
+  auto const collector = make_shared<TestCollector>();
+  auto const collection = make_shared<CollectorCollection>();
+  collection->Append(collector);
+  {
+    auto const profiled = ProfileCollectors(collection);
+    auto const clone = profiled->Clone();
+    for (size_t i = 0; i < 3; ++i)
+      profiled->Collect(MakeElement(OsmElement::EntityType::Node));
+    for (size_t i = 0; i < 2; ++i)
+      clone->Collect(MakeElement(OsmElement::EntityType::Way));
+    profiled->Merge(*clone);
+    profiled->Finalize(true /* isStable */);
+  }
+
+  TEST_EQUAL(collector->m_count, 5, ());
+  TEST_EQUAL(GetElementsCount("collector", "stage_profiler_tests::TestCollector"), 5, ());
+}
+
+UNIT_TEST(StageProfiler_Filters)
+{
+  StageProfiler::Instance().Enable();
+
+  {
+    auto const profiled = ProfileFilters(make_shared<TestFilter>());
+    TEST(profiled->IsAccepted(MakeElement(OsmElement::EntityType::Node)), ());
+    TEST(!profiled->IsAccepted(MakeElement(OsmElement::EntityType::Way)), ());
+    TEST(!profiled->Clone()->IsAccepted(MakeElement(OsmElement::EntityType::Relation)), ());
+  }
+
+  TEST_EQUAL(GetElementsCount("filter", "stage_profiler_tests::TestFilter"), 3, ());
+  TEST(!GetElementsCount("translator", "stage_profiler_tests::TestFilter"), ());
+}
+}  // namespace stage_profiler_tests
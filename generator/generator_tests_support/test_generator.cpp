@@ -87,9 +87,10 @@ void TestRawGenerator::BuildFB(std::string const & osmFilePath, std::string cons
   CHECK(rawGenerator.Execute(), ("Error generating", mwmName));
 }
 
-void TestRawGenerator::BuildFeatures(std::string const & mwmName)
+void TestRawGenerator::BuildFeatures(std::string const & mwmName, size_t threadsCount /* = 1 */)
 {
   using namespace feature;
+  m_genInfo.m_threadsCount = threadsCount;
   auto const type = IsWorld(mwmName) ? DataHeader::MapType::World : DataHeader::MapType::Country;
   CHECK(GenerateFinalFeatures(m_genInfo, mwmName, type), ());
 
@@ -99,9 +100,9 @@ void TestRawGenerator::BuildFeatures(std::string const & mwmName)
   CHECK(indexer::BuildIndexFromDataFile(mwmPath, mwmPath), ());
 }
 
-void TestRawGenerator::BuildSearch(std::string const & mwmName)
+void TestRawGenerator::BuildSearch(std::string const & mwmName, uint32_t threadsCount /* = 1 */)
 {
-  CHECK(indexer::BuildSearchIndexFromDataFile(mwmName, m_genInfo, true /* forceRebuild */, 1 /* threadsCount */), ());
+  CHECK(indexer::BuildSearchIndexFromDataFile(mwmName, m_genInfo, true /* forceRebuild */, threadsCount), ());
 
   if (IsWorld(mwmName))
   {
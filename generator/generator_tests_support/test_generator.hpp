@@ -25,8 +25,8 @@ public:
   void SetupTmpFolder(std::string const & tmpPath);
 
   void BuildFB(std::string const & osmFilePath, std::string const & mwmName, bool makeWorld = false);
-  void BuildFeatures(std::string const & mwmName);
-  void BuildSearch(std::string const & mwmName);
+  void BuildFeatures(std::string const & mwmName, size_t threadsCount = 1);
+  void BuildSearch(std::string const & mwmName, uint32_t threadsCount = 1);
   void BuildRouting(std::string const & mwmName, std::string const & countryName);
 
   routing::FeatureIdToOsmId LoadFID2OsmID(std::string const & mwmName);
@@ -24,6 +24,7 @@
 #include "generator/routing_index_generator.hpp"
 #include "generator/routing_world_roads_generator.hpp"
 #include "generator/search_index_builder.hpp"
+#include "generator/stage_profiler.hpp"
 #include "generator/statistics.hpp"
 #include "generator/traffic_generator.hpp"
 #include "generator/transit_generator.hpp"
@@ -46,6 +47,7 @@
 #include "coding/endianness.hpp"
 
 #include "base/file_name_utils.hpp"
+#include "base/scope_guard.hpp"
 #include "base/timer.hpp"
 
 #include "defines.hpp"
@@ -74,7 +76,7 @@ DEFINE_bool(emit_coasts, false,
 
 // Generator settings and paths.
 DEFINE_string(osm_file_name, "", "Input osm area file.");
-DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m].");
+DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m, pbf].");
 DEFINE_string(data_path, "", GetDataPathHelp());
 DEFINE_string(user_resource_path, "", "User defined resource path for classificator.txt and etc.");
 DEFINE_string(intermediate_data_path, "", "Path to stored intermediate data.");
@@ -84,7 +86,12 @@ DEFINE_string(cache_path, "",
 DEFINE_string(output, "", "File name for process (without 'mwm' ext).");
 DEFINE_bool(preload_cache, false, "Preload all ways and relations cache.");
 DEFINE_string(node_storage, "map",
-              "Type of storage for intermediate points representation. Available: raw, map, mem.");
+              "Type of storage for intermediate points representation. Available: raw, map, mem, paged.");
+DEFINE_bool(quantize_intermediate_features, false,
+            "Write intermediate features of the countries with quantized delta-encoded "
+            "coordinates instead of the exact ones.");
+DEFINE_bool(compress_intermediate_features, false,
+            "Compress intermediate features of the countries to save the disk space.");
 DEFINE_uint64(planet_version, base::SecondsSinceEpoch(),
               "Version as seconds since epoch, by default - now.");
 
@@ -187,6 +194,9 @@ DEFINE_bool(dump_mwm_tmp, false, "Prints feature builder objects from .mwm.tmp")
 DEFINE_uint64(threads_count, 0, "Desired count of threads. If count equals zero, count of "
                                 "threads is set automatically.");
 DEFINE_bool(verbose, false, "Provide more detailed output.");
+DEFINE_string(stages_report, "",
+              "Output json file with time, processed elements and peak memory of the translators, "
+              "filters, collectors and final processors.");
 
 MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
 {
@@ -202,6 +212,13 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
   gflags::SetVersionString(pl.Version());
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
+  if (!FLAGS_stages_report.empty())
+    StageProfiler::Instance().Enable();
+  SCOPE_GUARD(saveStagesReport, []() {
+    if (!FLAGS_stages_report.empty())
+      StageProfiler::Instance().SaveJsonReport(FLAGS_stages_report);
+  });
+
   unsigned threadsCount = FLAGS_threads_count != 0 ? static_cast<unsigned>(FLAGS_threads_count)
                                                    : pl.CpuCores();
 
@@ -238,8 +255,11 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
     genInfo.SetOsmFileType(FLAGS_osm_file_type);
 
   genInfo.m_osmFileName = FLAGS_osm_file_name;
+  genInfo.m_threadsCount = threadsCount;
   genInfo.m_failOnCoasts = FLAGS_fail_on_coasts;
   genInfo.m_preloadCache = FLAGS_preload_cache;
+  genInfo.m_quantizeIntermediateFeatures = FLAGS_quantize_intermediate_features;
+  genInfo.m_compressIntermediateFeatures = FLAGS_compress_intermediate_features;
   genInfo.m_popularPlacesFilename = FLAGS_popular_places_data;
   genInfo.m_brandsFilename = FLAGS_brands_data;
   genInfo.m_brandsTranslationsFilename = FLAGS_brands_translations_data;
@@ -420,7 +440,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
     }
 
     if (!FLAGS_srtm_path.empty())
-      routing::BuildRoadAltitudes(dataFile, FLAGS_srtm_path);
+      routing::BuildRoadAltitudes(dataFile, FLAGS_srtm_path, threadsCount);
 
     transit::experimental::EdgeIdToFeatureId transitEdgeFeatureIds;
 
@@ -1,10 +1,12 @@
 #include "generator/intermediate_data.hpp"
 
+#include <algorithm>
 #include <new>
 #include <set>
 #include <string>
 
 #include "base/assert.hpp"
+#include "base/bits.hpp"
 #include "base/checked_cast.hpp"
 #include "base/logging.hpp"
 
@@ -25,6 +27,14 @@ string const kShortExtension = ".short";
 // see https://wiki.openstreetmap.org/wiki/Stats
 size_t const kMaxNodesInOSM = size_t{1} << 33;
 
+// Paged storage splits ids into pages of 2^16 ids. It's limited by 2^34 ids, node ids are
+// around 12 billion in 2024.
+uint32_t const kPageBits = 16;
+uint64_t const kPageIds = uint64_t{1} << kPageBits;
+uint64_t const kPageWords = kPageIds / 64;
+uint64_t const kMaxPages = (uint64_t{1} << 34) >> kPageBits;
+uint64_t const kNoPage = std::numeric_limits<uint64_t>::max();
+
 void ToLatLon(double lat, double lon, LatLon & ll)
 {
   int64_t const lat64 = lat * kValueOrder;
@@ -254,6 +264,160 @@ private:
   FileWriter m_fileWriter;
   uint64_t m_numProcessedPoints = 0;
 };
+
+// PagedPointStorageReader -------------------------------------------------------------------------
+// The file is a sequence of the pages with points, the directory of the page offsets
+// (kNoPage for the pages without points) and the number of the directory entries.
+// A page is a bitmap of the stored ids, the numbers of the stored ids before every 64-bit word
+// of the bitmap as uint16_t and the points of the stored ids in the order of ids.
+// So a page takes 10 KB besides sizeof(LatLon) per point, and only the pages with points are stored.
+class PagedPointStorageReader : public PointStorageReaderInterface
+{
+public:
+  explicit PagedPointStorageReader(string const & name)
+    : m_mmapReader(name, MmapReader::Advice::Random)
+  {
+    uint64_t const size = m_mmapReader.Size();
+    CHECK_GREATER_OR_EQUAL(size, sizeof(m_numPages), ("Damaged file", name));
+    m_mmapReader.Read(size - sizeof(m_numPages), &m_numPages, sizeof(m_numPages));
+    CHECK_LESS_OR_EQUAL((m_numPages + 1) * sizeof(uint64_t), size, ("Damaged file", name));
+    m_directory = reinterpret_cast<uint64_t const *>(m_mmapReader.Data() + size -
+                                                     (m_numPages + 1) * sizeof(uint64_t));
+  }
+
+  // PointStorageReaderInterface overrides:
+  bool GetPoint(uint64_t id, double & lat, double & lon) const override
+  {
+    uint64_t const page = id >> kPageBits;
+    if (page >= m_numPages || m_directory[page] == kNoPage)
+      return false;
+
+    auto const * bits = reinterpret_cast<uint64_t const *>(m_mmapReader.Data() + m_directory[page]);
+    auto const * ranks = reinterpret_cast<uint16_t const *>(bits + kPageWords);
+    auto const * points = reinterpret_cast<LatLon const *>(ranks + kPageWords);
+
+    uint64_t const offset = id & (kPageIds - 1);
+    uint64_t const word = bits[offset / 64];
+    uint64_t const mask = uint64_t{1} << (offset % 64);
+    if ((word & mask) == 0)
+      return false;
+
+    LatLon const & ll = points[ranks[offset / 64] + bits::PopCount(word & (mask - 1))];
+    lat = static_cast<double>(ll.m_lat) / kValueOrder;
+    lon = static_cast<double>(ll.m_lon) / kValueOrder;
+    return true;
+  }
+
+private:
+  MmapReader m_mmapReader;
+  uint64_t m_numPages = 0;
+  uint64_t const * m_directory = nullptr;
+};
+
+// PagedPointStorageWriter -------------------------------------------------------------------------
+// Points are written in the PagedPointStorageReader format. They must be added in the order of ids,
+// as nodes are in the OSM files, though the points of a page may come in any order. A page is
+// written out and freed as soon as a point of a next page comes, so only one page is in memory.
+class PagedPointStorageWriter : public PointStorageWriterInterface
+{
+public:
+  explicit PagedPointStorageWriter(string const & name)
+    : m_fileWriter(name), m_bits(kPageWords), m_ranks(kPageWords)
+  {
+    m_entries.reserve(kPageIds);
+  }
+
+  ~PagedPointStorageWriter() noexcept(false) override
+  {
+    WritePage();
+
+    uint64_t const numPages = m_directory.size();
+    m_fileWriter.Write(m_directory.data(), m_directory.size() * sizeof(uint64_t));
+    m_fileWriter.Write(&numPages, sizeof(numPages));
+  }
+
+  // PointStorageWriterInterface overrides:
+  void AddPoint(uint64_t id, double lat, double lon) override
+  {
+    uint64_t const page = id >> kPageBits;
+    CHECK_LESS(page, kMaxPages, ("Found node with id", id, "which is bigger than the storage limit"));
+
+    if (page != m_page)
+    {
+      CHECK(m_page == kNoPage || page > m_page,
+            ("Node", id, "goes after the bigger ids. The paged storage needs the nodes sorted by id."));
+      WritePage();
+      m_page = page;
+    }
+
+    Entry entry;
+    entry.m_offset = static_cast<uint16_t>(id & (kPageIds - 1));
+    ToLatLon(lat, lon, entry.m_ll);
+    m_entries.push_back(entry);
+
+    ++m_numProcessedPoints;
+  }
+
+  uint64_t GetNumProcessedPoints() const override { return m_numProcessedPoints; }
+
+private:
+  struct Entry
+  {
+    uint16_t m_offset = 0;
+    LatLon m_ll;
+  };
+
+  void WritePage()
+  {
+    if (m_entries.empty())
+      return;
+
+    std::stable_sort(m_entries.begin(), m_entries.end(), [](Entry const & lhs, Entry const & rhs) {
+      return lhs.m_offset < rhs.m_offset;
+    });
+
+    std::fill(m_bits.begin(), m_bits.end(), 0);
+    m_points.clear();
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+      // The last of the points with the same id wins.
+      if (i != 0 && m_entries[i].m_offset == m_entries[i - 1].m_offset)
+      {
+        m_points.back() = m_entries[i].m_ll;
+        continue;
+      }
+      m_bits[m_entries[i].m_offset / 64] |= uint64_t{1} << (m_entries[i].m_offset % 64);
+      m_points.push_back(m_entries[i].m_ll);
+    }
+
+    uint32_t rank = 0;
+    for (size_t i = 0; i < kPageWords; ++i)
+    {
+      m_ranks[i] = static_cast<uint16_t>(rank);
+      rank += bits::PopCount(m_bits[i]);
+    }
+
+    m_directory.resize(m_page + 1, kNoPage);
+    m_directory[m_page] = m_fileWriter.Pos();
+    m_fileWriter.Write(m_bits.data(), m_bits.size() * sizeof(uint64_t));
+    m_fileWriter.Write(m_ranks.data(), m_ranks.size() * sizeof(uint16_t));
+    m_fileWriter.Write(m_points.data(), m_points.size() * sizeof(LatLon));
+
+    m_entries.clear();
+  }
+
+  FileWriter m_fileWriter;
+  // Offsets of the written pages, it's 8 bytes per 2^16 ids.
+  std::vector<uint64_t> m_directory;
+  // The page which is being filled and its points.
+  uint64_t m_page = kNoPage;
+  std::vector<Entry> m_entries;
+  // Buffers to write a page.
+  std::vector<uint64_t> m_bits;
+  std::vector<uint16_t> m_ranks;
+  std::vector<LatLon> m_points;
+  uint64_t m_numProcessedPoints = 0;
+};
 }  // namespace
 
 // IndexFileReader ---------------------------------------------------------------------------------
@@ -431,6 +595,8 @@ CreatePointStorageReader(feature::GenerateInfo::NodeStorageType type, string con
     return std::make_unique<MapFilePointStorageReader>(name);
   case feature::GenerateInfo::NodeStorageType::Memory:
     return std::make_unique<RawMemPointStorageReader>(name);
+  case feature::GenerateInfo::NodeStorageType::Paged:
+    return std::make_unique<PagedPointStorageReader>(name);
   }
   UNREACHABLE();
 }
@@ -446,6 +612,8 @@ CreatePointStorageWriter(feature::GenerateInfo::NodeStorageType type, string con
     return std::make_unique<MapFilePointStorageWriter>(name);
   case feature::GenerateInfo::NodeStorageType::Memory:
     return std::make_unique<RawMemPointStorageWriter>(name);
+  case feature::GenerateInfo::NodeStorageType::Paged:
+    return std::make_unique<PagedPointStorageWriter>(name);
   }
   UNREACHABLE();
 }
@@ -2,6 +2,7 @@
 
 #include "coding/buffered_file_writer.hpp"
 #include "coding/file_reader.hpp"
+#include "coding/files_container.hpp"
 #include "coding/file_writer.hpp"
 #include "coding/reader.hpp"
 #include "coding/write_to_sink.hpp"
@@ -13,20 +14,20 @@
 #include "base/checked_cast.hpp"
 #include "base/logging.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <iterator>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "3party/bsdiff-courgette/bsdiff/bsdiff.h"
 
 namespace
 {
-enum Version
-{
-  // Format Version 0: bsdiff+gzip.
-  VERSION_V0 = 0,
-  VERSION_LATEST = VERSION_V0
-};
+using generator::mwm_diff::DiffVersion;
 
 bool MakeDiffVersion0(FileReader & oldReader, FileReader & newReader, FileWriter & diffFileWriter)
 {
@@ -48,7 +49,7 @@ bool MakeDiffVersion0(FileReader & oldReader, FileReader & newReader, FileWriter
   deflate(diffBuf.data(), diffBuf.size(), back_inserter(deflatedDiffBuf));
 
   // A basic header that holds only version.
-  WriteToSink(diffFileWriter, static_cast<uint32_t>(VERSION_V0));
+  WriteToSink(diffFileWriter, static_cast<uint32_t>(DiffVersion::V0));
   diffFileWriter.Write(deflatedDiffBuf.data(), deflatedDiffBuf.size());
 
   return true;
@@ -91,13 +92,479 @@ generator::mwm_diff::DiffApplicationResult ApplyDiffVersion0(
   LOG(LERROR, ("Could not apply patch with bsdiff:", status));
   return DiffApplicationResult::Failed;
 }
+
+// Version 1 ---------------------------------------------------------------------------------------
+// The new mwm is a sequence of chunks, every section of the container is a chunk which is either
+// copied from the old mwm, or patched with bsdiff+gzip against the old section with the same tag,
+// or stored with gzip. The header holds the chunk records, the data of the chunks follows it
+// in any order.
+
+enum class ChunkType : uint8_t
+{
+  // The bytes are copied from the old mwm.
+  Copy = 0,
+  // The bytes are restored from the old mwm range with bsdiff.
+  Patch = 1,
+  // The bytes are stored in the diff.
+  Raw = 2
+};
+
+struct Chunk
+{
+  ChunkType m_type = ChunkType::Raw;
+  uint64_t m_size = 0;
+  // Range of the old mwm for the Copy and Patch chunks.
+  uint64_t m_oldOffset = 0;
+  uint64_t m_oldSize = 0;
+  // Checksum of the old range for the Copy chunks.
+  uint32_t m_crc = 0;
+  // Range of the deflated data in the data of the diff for the Patch and Raw chunks.
+  uint64_t m_dataOffset = 0;
+  uint64_t m_dataSize = 0;
+
+  // Offset of the chunk in the new mwm, it's not stored.
+  uint64_t m_newOffset = 0;
+};
+
+// Type, size, old offset, old size, crc, data offset and data size.
+uint64_t constexpr kChunkRecordSize = 1 + 8 + 8 + 8 + 4 + 8 + 8;
+// Copied chunks are streamed by blocks of this size.
+size_t constexpr kCopyBlockSize = 1 << 20;
+
+uint32_t CalculateCrc(uint32_t crc, uint8_t const * data, size_t size)
+{
+  for (size_t pos = 0; pos < size; pos += kCopyBlockSize)
+  {
+    auto const blockSize = std::min(kCopyBlockSize, size - pos);
+    crc = static_cast<uint32_t>(crc32(crc, data + pos, static_cast<uInt>(blockSize)));
+  }
+  return crc;
+}
+
+bool IsValid(Chunk const & chunk, uint64_t oldSize)
+{
+  // The sizes are limited so that the offsets never overflow.
+  uint64_t constexpr kMaxSize = uint64_t{1} << 48;
+  if (chunk.m_size > kMaxSize || chunk.m_dataOffset > kMaxSize || chunk.m_dataSize > kMaxSize)
+    return false;
+
+  bool const isOldRangeValid =
+      chunk.m_oldOffset <= oldSize && chunk.m_oldSize <= oldSize - chunk.m_oldOffset;
+  switch (chunk.m_type)
+  {
+  case ChunkType::Copy:
+    return isOldRangeValid && chunk.m_oldSize == chunk.m_size && chunk.m_dataSize == 0;
+  case ChunkType::Patch: return isOldRangeValid;
+  case ChunkType::Raw: return chunk.m_oldOffset == 0 && chunk.m_oldSize == 0;
+  }
+  return false;
+}
+
+// Calls |fn| for every index in [0, count) on |threadsCount| threads. No more indices are
+// processed after any call fails. Returns true when all the calls succeed.
+template <typename Fn>
+bool ForEachIndex(size_t count, size_t threadsCount, Fn && fn)
+{
+  std::atomic<size_t> next = 0;
+  std::atomic<bool> ok = true;
+  auto const worker = [&]() {
+    for (size_t i = next++; i < count && ok; i = next++)
+    {
+      try
+      {
+        if (!fn(i))
+          ok = false;
+      }
+      catch (Reader::Exception const & e)
+      {
+        LOG(LERROR, ("Could not read file when processing an mwm diff chunk:", e.Msg()));
+        ok = false;
+      }
+      catch (Writer::Exception const & e)
+      {
+        LOG(LERROR, ("Could not write file when processing an mwm diff chunk:", e.Msg()));
+        ok = false;
+      }
+    }
+  };
+
+  threadsCount = std::min(threadsCount, count);
+  if (threadsCount <= 1)
+  {
+    worker();
+    return ok;
+  }
+
+  std::vector<std::thread> threads;
+  threads.reserve(threadsCount);
+  for (size_t i = 0; i < threadsCount; ++i)
+    threads.emplace_back(worker);
+  for (auto & thread : threads)
+    thread.join();
+  return ok;
+}
+
+// Returns the non-empty sections of the container at |path| ordered by offset. Returns nothing
+// if the file is not a container.
+std::vector<FilesContainerBase::TagInfo> ReadSections(std::string const & path, uint64_t fileSize)
+{
+  std::vector<FilesContainerBase::TagInfo> sections;
+  try
+  {
+    // The offset of the table of contents is the first thing in a container.
+    if (fileSize < sizeof(uint64_t) ||
+        ReadPrimitiveFromPos<uint64_t>(FileReader(path), 0) >= fileSize)
+    {
+      return {};
+    }
+
+    FilesContainerR const container(path);
+    container.ForEachTagInfo([&sections](FilesContainerBase::TagInfo const & info) {
+      if (info.m_size != 0)
+        sections.push_back(info);
+    });
+  }
+  catch (Reader::Exception const &)
+  {
+    return {};
+  }
+
+  std::sort(sections.begin(), sections.end(), [](auto const & lhs, auto const & rhs) {
+    return lhs.m_offset < rhs.m_offset;
+  });
+
+  uint64_t end = 0;
+  for (auto const & section : sections)
+  {
+    if (section.m_offset < end || section.m_offset > fileSize ||
+        section.m_size > fileSize - section.m_offset)
+    {
+      return {};
+    }
+    end = section.m_offset + section.m_size;
+  }
+  return sections;
+}
+
+// Covers the new mwm with the chunks: every section is a chunk which is patched against the old
+// section with the same tag, if there is one. The bytes between the sections (the header, the
+// padding and the table of contents) are raw chunks. When any of the files is not a container,
+// the whole new file is patched against the whole old one.
+std::vector<Chunk> PlanChunks(std::string const & oldMwmPath, std::string const & newMwmPath)
+{
+  uint64_t const oldSize = FileReader(oldMwmPath).Size();
+  uint64_t const newSize = FileReader(newMwmPath).Size();
+  auto const oldSections = ReadSections(oldMwmPath, oldSize);
+  auto const newSections = ReadSections(newMwmPath, newSize);
+
+  std::vector<Chunk> chunks;
+  auto const addChunk = [&chunks](ChunkType type, uint64_t offset, uint64_t size) -> Chunk & {
+    auto & chunk = chunks.emplace_back();
+    chunk.m_type = type;
+    chunk.m_newOffset = offset;
+    chunk.m_size = size;
+    return chunk;
+  };
+
+  if (oldSections.empty() || newSections.empty())
+  {
+    if (newSize != 0)
+      addChunk(ChunkType::Patch, 0, newSize).m_oldSize = oldSize;
+    return chunks;
+  }
+
+  std::map<std::string, FilesContainerBase::TagInfo> oldSectionsByTag;
+  for (auto const & section : oldSections)
+    oldSectionsByTag.emplace(section.m_tag, section);
+
+  uint64_t pos = 0;
+  for (auto const & section : newSections)
+  {
+    if (pos < section.m_offset)
+      addChunk(ChunkType::Raw, pos, section.m_offset - pos);
+
+    auto const it = oldSectionsByTag.find(section.m_tag);
+    if (it == oldSectionsByTag.cend())
+    {
+      addChunk(ChunkType::Raw, section.m_offset, section.m_size);
+    }
+    else
+    {
+      auto & chunk = addChunk(ChunkType::Patch, section.m_offset, section.m_size);
+      chunk.m_oldOffset = it->second.m_offset;
+      chunk.m_oldSize = it->second.m_size;
+    }
+    pos = section.m_offset + section.m_size;
+  }
+
+  if (pos < newSize)
+    addChunk(ChunkType::Raw, pos, newSize - pos);
+  return chunks;
+}
+
+// Makes the data of |chunk|. A patched chunk becomes a copied one when the old range is the same,
+// and a raw one when the patch is larger than the deflated bytes.
+bool MakeChunk(std::string const & oldMwmPath, std::string const & newMwmPath, Chunk & chunk,
+               std::vector<uint8_t> & data)
+{
+  std::vector<uint8_t> newBuf(base::checked_cast<size_t>(chunk.m_size));
+  FileReader(newMwmPath).Read(chunk.m_newOffset, newBuf.data(), newBuf.size());
+
+  using Deflate = coding::ZLib::Deflate;
+  Deflate const deflate(Deflate::Format::ZLib, Deflate::Level::BestCompression);
+
+  if (chunk.m_type == ChunkType::Patch)
+  {
+    FileReader const oldFile(oldMwmPath);
+    auto oldReader = oldFile.SubReader(chunk.m_oldOffset, chunk.m_oldSize);
+    if (chunk.m_oldSize == chunk.m_size)
+    {
+      std::vector<uint8_t> oldBuf(newBuf.size());
+      oldReader.Read(0, oldBuf.data(), oldBuf.size());
+      if (oldBuf == newBuf)
+      {
+        chunk.m_type = ChunkType::Copy;
+        chunk.m_crc = CalculateCrc(0, oldBuf.data(), oldBuf.size());
+        return true;
+      }
+    }
+
+    std::vector<uint8_t> patch;
+    MemWriter<std::vector<uint8_t>> patchWriter(patch);
+    MemReader newReader(newBuf.data(), newBuf.size());
+    auto const status = bsdiff::CreateBinaryPatch(oldReader, newReader, patchWriter);
+    if (status != bsdiff::BSDiffStatus::OK)
+    {
+      LOG(LERROR, ("Could not create patch with bsdiff:", status));
+      return false;
+    }
+    deflate(patch.data(), patch.size(), back_inserter(data));
+  }
+
+  std::vector<uint8_t> raw;
+  deflate(newBuf.data(), newBuf.size(), back_inserter(raw));
+  if (chunk.m_type == ChunkType::Raw || raw.size() <= data.size())
+  {
+    chunk.m_type = ChunkType::Raw;
+    chunk.m_oldOffset = 0;
+    chunk.m_oldSize = 0;
+    data.swap(raw);
+  }
+  chunk.m_dataSize = data.size();
+  return true;
+}
+
+void WriteChunkRecords(std::vector<Chunk> const & chunks, FileWriter & writer)
+{
+  for (auto const & chunk : chunks)
+  {
+    WriteToSink(writer, static_cast<uint8_t>(chunk.m_type));
+    WriteToSink(writer, chunk.m_size);
+    WriteToSink(writer, chunk.m_oldOffset);
+    WriteToSink(writer, chunk.m_oldSize);
+    WriteToSink(writer, chunk.m_crc);
+    WriteToSink(writer, chunk.m_dataOffset);
+    WriteToSink(writer, chunk.m_dataSize);
+  }
+}
+
+bool MakeDiffVersion1(std::string const & oldMwmPath, std::string const & newMwmPath,
+                      FileWriter & diffFileWriter, size_t threadsCount)
+{
+  auto chunks = PlanChunks(oldMwmPath, newMwmPath);
+
+  WriteToSink(diffFileWriter, static_cast<uint32_t>(DiffVersion::V1));
+  WriteToSink(diffFileWriter, base::checked_cast<uint32_t>(chunks.size()));
+  // The records are rewritten when the data of all the chunks is written.
+  uint64_t const recordsPos = diffFileWriter.Pos();
+  WriteChunkRecords(chunks, diffFileWriter);
+  uint64_t const dataPos = diffFileWriter.Pos();
+
+  // Every chunk is written as soon as it's made, so only the chunks which are being made
+  // are kept in memory.
+  std::mutex mutex;
+  bool const ok = ForEachIndex(chunks.size(), threadsCount, [&](size_t i) {
+    std::vector<uint8_t> data;
+    if (!MakeChunk(oldMwmPath, newMwmPath, chunks[i], data))
+      return false;
+
+    std::lock_guard lock(mutex);
+    chunks[i].m_dataOffset = diffFileWriter.Pos() - dataPos;
+    diffFileWriter.Write(data.data(), data.size());
+    return true;
+  });
+  if (!ok)
+    return false;
+
+  uint64_t const endPos = diffFileWriter.Pos();
+  diffFileWriter.Seek(recordsPos);
+  WriteChunkRecords(chunks, diffFileWriter);
+  diffFileWriter.Seek(endPos);
+  return true;
+}
+
+// Writes |chunk| to its place in the new mwm. Chunks do not overlap, so they are applied
+// concurrently, each one with its own readers and writer.
+bool ApplyChunk(Chunk const & chunk, std::string const & oldMwmPath, std::string const & newMwmPath,
+                std::string const & diffPath, uint64_t dataPos,
+                base::Cancellable const & cancellable)
+{
+  if (cancellable.IsCancelled())
+    return false;
+
+  FileReader const oldFile(oldMwmPath);
+  BufferedFileWriter newWriter(newMwmPath, FileWriter::OP_WRITE_EXISTING);
+  newWriter.Seek(chunk.m_newOffset);
+
+  if (chunk.m_type == ChunkType::Copy)
+  {
+    std::vector<uint8_t> buf(static_cast<size_t>(std::min<uint64_t>(kCopyBlockSize, chunk.m_size)));
+    uint32_t crc = 0;
+    for (uint64_t pos = 0; pos < chunk.m_size; pos += buf.size())
+    {
+      if (cancellable.IsCancelled())
+        return false;
+
+      auto const size = static_cast<size_t>(std::min<uint64_t>(buf.size(), chunk.m_size - pos));
+      oldFile.Read(chunk.m_oldOffset + pos, buf.data(), size);
+      crc = CalculateCrc(crc, buf.data(), size);
+      newWriter.Write(buf.data(), size);
+    }
+
+    if (crc != chunk.m_crc)
+    {
+      LOG(LERROR, ("The old mwm does not match the diff"));
+      return false;
+    }
+    return true;
+  }
+
+  std::vector<uint8_t> deflatedData(base::checked_cast<size_t>(chunk.m_dataSize));
+  FileReader(diffPath).Read(dataPos + chunk.m_dataOffset, deflatedData.data(),
+                            deflatedData.size());
+
+  using Inflate = coding::ZLib::Inflate;
+  Inflate const inflate(Inflate::Format::ZLib);
+  std::vector<uint8_t> data;
+  if (!inflate(deflatedData.data(), deflatedData.size(), back_inserter(data)))
+  {
+    LOG(LERROR, ("Could not inflate mwm diff chunk"));
+    return false;
+  }
+
+  if (chunk.m_type == ChunkType::Raw)
+  {
+    if (data.size() != chunk.m_size)
+    {
+      LOG(LERROR, ("Wrong size of mwm diff chunk:", data.size(), chunk.m_size));
+      return false;
+    }
+    newWriter.Write(data.data(), data.size());
+    return true;
+  }
+
+  // See the comment in ApplyDiffVersion0.
+  MemReaderWithExceptions patchReader(data.data(), data.size());
+  auto oldReader = oldFile.SubReader(chunk.m_oldOffset, chunk.m_oldSize);
+  auto const status = bsdiff::ApplyBinaryPatch(oldReader, newWriter, patchReader, cancellable);
+  if (status == bsdiff::BSDiffStatus::CANCELLED)
+    return false;
+
+  if (status != bsdiff::BSDiffStatus::OK)
+  {
+    LOG(LERROR, ("Could not apply patch with bsdiff:", status));
+    return false;
+  }
+
+  if (newWriter.Pos() != chunk.m_newOffset + chunk.m_size)
+  {
+    LOG(LERROR, ("Wrong size of mwm diff chunk:", newWriter.Pos() - chunk.m_newOffset,
+                 chunk.m_size));
+    return false;
+  }
+  return true;
+}
+
+generator::mwm_diff::DiffApplicationResult ApplyDiffVersion1(
+    std::string const & oldMwmPath, std::string const & newMwmPath, std::string const & diffPath,
+    ReaderSource<FileReader> & diffFileSource, base::Cancellable const & cancellable,
+    size_t threadsCount)
+{
+  using generator::mwm_diff::DiffApplicationResult;
+
+  auto const chunksCount = ReadPrimitiveFromSource<uint32_t>(diffFileSource);
+  if (chunksCount > diffFileSource.Size() / kChunkRecordSize)
+  {
+    LOG(LERROR, ("Wrong number of mwm diff chunks:", chunksCount));
+    return DiffApplicationResult::Failed;
+  }
+
+  uint64_t const oldSize = FileReader(oldMwmPath).Size();
+  std::vector<Chunk> chunks(chunksCount);
+  uint64_t newSize = 0;
+  uint64_t dataSize = 0;
+  for (auto & chunk : chunks)
+  {
+    chunk.m_type = static_cast<ChunkType>(ReadPrimitiveFromSource<uint8_t>(diffFileSource));
+    chunk.m_size = ReadPrimitiveFromSource<uint64_t>(diffFileSource);
+    chunk.m_oldOffset = ReadPrimitiveFromSource<uint64_t>(diffFileSource);
+    chunk.m_oldSize = ReadPrimitiveFromSource<uint64_t>(diffFileSource);
+    chunk.m_crc = ReadPrimitiveFromSource<uint32_t>(diffFileSource);
+    chunk.m_dataOffset = ReadPrimitiveFromSource<uint64_t>(diffFileSource);
+    chunk.m_dataSize = ReadPrimitiveFromSource<uint64_t>(diffFileSource);
+    if (!IsValid(chunk, oldSize))
+    {
+      LOG(LERROR, ("Wrong mwm diff chunk at", newSize));
+      return DiffApplicationResult::Failed;
+    }
+
+    chunk.m_newOffset = newSize;
+    newSize += chunk.m_size;
+    dataSize += chunk.m_dataSize;
+  }
+
+  if (dataSize != diffFileSource.Size())
+  {
+    LOG(LERROR, ("Wrong size of mwm diff data:", diffFileSource.Size(), dataSize));
+    return DiffApplicationResult::Failed;
+  }
+
+  for (auto const & chunk : chunks)
+  {
+    if (chunk.m_dataOffset > dataSize || chunk.m_dataSize > dataSize - chunk.m_dataOffset)
+    {
+      LOG(LERROR, ("Wrong data of mwm diff chunk at", chunk.m_newOffset));
+      return DiffApplicationResult::Failed;
+    }
+  }
+
+  {
+    // The chunks are written to the new mwm in any order.
+    FileWriter newWriter(newMwmPath);
+  }
+
+  uint64_t const dataPos = diffFileSource.Pos();
+  bool const ok = ForEachIndex(chunks.size(), threadsCount, [&](size_t i) {
+    return ApplyChunk(chunks[i], oldMwmPath, newMwmPath, diffPath, dataPos, cancellable);
+  });
+  if (ok)
+    return DiffApplicationResult::Ok;
+
+  if (cancellable.IsCancelled())
+  {
+    LOG(LDEBUG, ("Diff application has been cancelled"));
+    return DiffApplicationResult::Cancelled;
+  }
+  return DiffApplicationResult::Failed;
+}
 }  // namespace
 
 namespace generator
 {
 namespace mwm_diff
 {
-bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, std::string const & diffPath)
+bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
+              std::string const & diffPath, DiffVersion version, size_t threadsCount)
 {
   try
   {
@@ -105,12 +572,11 @@ bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, st
     FileReader newReader(newMwmPath);
     FileWriter diffFileWriter(diffPath);
 
-    switch (VERSION_LATEST)
+    switch (version)
     {
-    case VERSION_V0: return MakeDiffVersion0(oldReader, newReader, diffFileWriter);
-    default:
-      LOG(LERROR,
-          ("Making mwm diffs with diff format version", VERSION_LATEST, "is not implemented"));
+    case DiffVersion::V0: return MakeDiffVersion0(oldReader, newReader, diffFileWriter);
+    case DiffVersion::V1:
+      return MakeDiffVersion1(oldMwmPath, newMwmPath, diffFileWriter, threadsCount);
     }
   }
   catch (Reader::Exception const & e)
@@ -128,21 +594,27 @@ bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, st
 }
 
 DiffApplicationResult ApplyDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
-                                std::string const & diffPath, base::Cancellable const & cancellable)
+                                std::string const & diffPath, base::Cancellable const & cancellable,
+                                size_t threadsCount)
 {
   try
   {
-    FileReader oldReader(oldMwmPath);
-    BufferedFileWriter newWriter(newMwmPath);
     FileReader diffFileReader(diffPath);
 
     ReaderSource<FileReader> diffFileSource(diffFileReader);
     auto const version = ReadPrimitiveFromSource<uint32_t>(diffFileSource);
 
-    switch (version)
+    switch (static_cast<DiffVersion>(version))
     {
-    case VERSION_V0:
+    case DiffVersion::V0:
+    {
+      FileReader oldReader(oldMwmPath);
+      BufferedFileWriter newWriter(newMwmPath);
       return ApplyDiffVersion0(oldReader, newWriter, diffFileSource, cancellable);
+    }
+    case DiffVersion::V1:
+      return ApplyDiffVersion1(oldMwmPath, newMwmPath, diffPath, diffFileSource, cancellable,
+                               threadsCount);
     default:
       LOG(LERROR, ("Unknown version format of mwm diff:", version));
       return DiffApplicationResult::Failed;
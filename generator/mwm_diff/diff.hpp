@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace base
@@ -18,12 +20,25 @@ enum class DiffApplicationResult
   Cancelled,
 };
 
+// Format version of the made diffs.
+enum class DiffVersion : uint32_t
+{
+  // bsdiff+gzip of the whole mwm. The apps apply only this version so far, so it's the default.
+  V0 = 0,
+  // The mwm is diffed section by section, see diff.cpp.
+  V1 = 1,
+};
+
 // Makes a diff that, when applied to the mwm at |oldMwmPath|, will
 // result in the mwm at |newMwmPath|. The diff is stored at |diffPath|.
 // It is assumed that the files at |oldMwmPath| and |newMwmPath| are valid mwms.
+// The V1 diff is made section by section: the sections which are the same in both
+// mwms are only referenced, the others are patched against the old sections with
+// the same tags. The sections are processed on |threadsCount| threads.
 // Returns true on success and false on failure.
 bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
-              std::string const & diffPath);
+              std::string const & diffPath, DiffVersion version = DiffVersion::V0,
+              size_t threadsCount = 1);
 
 // Applies the diff at |diffPath| to the mwm at |oldMwmPath|. The resulting
 // mwm is stored at |newMwmPath|.
@@ -31,9 +46,11 @@ bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
 // at |diffPath| is a valid mwmdiff.
 // The application process can be stopped via |cancellable| in which case
 // it is up to the caller to clean the partially written file at |diffPath|.
+// The sections of the new mwm are restored on |threadsCount| threads, each of them
+// is written to its place in the file.
 DiffApplicationResult ApplyDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
                                 std::string const & diffPath,
-                                base::Cancellable const & cancellable);
+                                base::Cancellable const & cancellable, size_t threadsCount = 1);
 
 std::string DebugPrint(DiffApplicationResult const & result);
 }  // namespace mwm_diff
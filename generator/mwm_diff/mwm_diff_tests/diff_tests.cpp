@@ -4,8 +4,11 @@
 
 #include "platform/platform.hpp"
 
+#include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/files_container.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/reader.hpp"
 
 #include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
@@ -13,6 +16,8 @@
 
 #include <vector>
 
+#include "defines.hpp"
+
 namespace generator::diff_tests
 {
 using namespace mwm_diff;
@@ -55,6 +60,9 @@ UNIT_TEST(IncrementalUpdates_Smoke)
   }
 
   TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath), ());
+  // The apps apply only the version 0 diffs, so it's made by default.
+  TEST_EQUAL(ReadPrimitiveFromPos<uint32_t>(FileReader(diffPath), 0),
+             static_cast<uint32_t>(DiffVersion::V0), ());
   TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable), DiffApplicationResult::Ok,
              ());
 
@@ -88,4 +96,60 @@ UNIT_TEST(IncrementalUpdates_Smoke)
   TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
              DiffApplicationResult::Failed, ());
 }
+
+UNIT_TEST(IncrementalUpdates_Sections)
+{
+  base::ScopedLogAbortLevelChanger ignoreLogError(base::LogLevel::LCRITICAL);
+
+  string const oldMwmPath = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass.mwm");
+  string const newMwmPath1 = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass-new1.mwm");
+  string const newMwmPath2 = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass-new2.mwm");
+  string const diffPath = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass.mwmdiff");
+
+  SCOPE_GUARD(cleanup, [&] {
+    FileWriter::DeleteFileX(newMwmPath1);
+    FileWriter::DeleteFileX(newMwmPath2);
+    FileWriter::DeleteFileX(diffPath);
+  });
+
+  TEST(base::CopyFileX(oldMwmPath, newMwmPath1), ());
+  {
+    // Change one section, replace another one and add a new one.
+    vector<uint8_t> features;
+    {
+      auto const reader = FilesContainerR(oldMwmPath).GetReader(FEATURES_FILE_TAG);
+      features.resize(reader.Size());
+      reader.Read(0, features.data(), features.size());
+    }
+    for (size_t i = features.size() / 2; i < features.size() / 2 + 100; ++i)
+      features[i] ^= 0x5A;
+
+    FilesContainerW writer(newMwmPath1, FileWriter::OP_WRITE_EXISTING);
+    writer.DeleteSection(FEATURES_FILE_TAG);
+    writer.DeleteSection(SEARCH_INDEX_FILE_TAG);
+    writer.Write(features, FEATURES_FILE_TAG);
+    writer.Write(vector<uint8_t>(1000, 1), SEARCH_INDEX_FILE_TAG);
+    writer.Write(vector<uint8_t>(1000, 2), "new_section");
+  }
+
+  base::Cancellable cancellable;
+  for (size_t threadsCount : {1, 4})
+  {
+    TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath, DiffVersion::V1, threadsCount), ());
+    // Only the changed sections are stored in the diff.
+    TEST_LESS(base::ReadFile(diffPath).size(), base::ReadFile(newMwmPath1).size() / 10, ());
+
+    TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable, threadsCount),
+               DiffApplicationResult::Ok, ());
+    TEST(base::IsEqualFiles(newMwmPath1, newMwmPath2), (threadsCount));
+  }
+
+  // The diff does not match another old mwm.
+  TEST_EQUAL(ApplyDiff(newMwmPath1, newMwmPath2, diffPath, cancellable, 4 /* threadsCount */),
+             DiffApplicationResult::Failed, ());
+
+  cancellable.Cancel();
+  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable, 4 /* threadsCount */),
+             DiffApplicationResult::Cancelled, ());
+}
 }  // namespace generator::diff_tests
@@ -2,29 +2,40 @@
 
 #include "base/cancellable.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <cstring>
+#include <thread>
 
 int main(int argc, char ** argv)
 {
   if (argc < 5)
   {
     std::cout <<
-        "Usage: " << argv[0] << " make|apply olderMWMDir newerMWMDir diffDir\n"
+        "Usage: " << argv[0] << " make|apply olderMWMDir newerMWMDir diffDir [--v1]\n"
         "make\n"
         "  Creates the diff between newer and older MWM versions at `diffDir`\n"
+        "  --v1 makes the section by section diff, it's not applied by the released apps\n"
         "apply\n"
         "  Applies the diff at `diffDir` to the mwm at `olderMWMDir` and stores result at `newerMWMDir`.\n"
         "WARNING: THERE IS NO MWM VALIDITY CHECK!\n";
     return -1;
   }
   char const * olderMWMDir{argv[2]}, * newerMWMDir{argv[3]}, * diffDir{argv[4]};
+  size_t const threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
   if (0 == std::strcmp(argv[1], "make"))
-    return generator::mwm_diff::MakeDiff(olderMWMDir, newerMWMDir, diffDir);
+  {
+    using generator::mwm_diff::DiffVersion;
+    auto const version =
+        argc > 5 && 0 == std::strcmp(argv[5], "--v1") ? DiffVersion::V1 : DiffVersion::V0;
+    return generator::mwm_diff::MakeDiff(olderMWMDir, newerMWMDir, diffDir, version,
+                                         threadsCount);
+  }
 
   // apply
   base::Cancellable cancellable;
-  auto const res = generator::mwm_diff::ApplyDiff(olderMWMDir, newerMWMDir, diffDir, cancellable);
+  auto const res = generator::mwm_diff::ApplyDiff(olderMWMDir, newerMWMDir, diffDir, cancellable,
+                                                   threadsCount);
   if (res == generator::mwm_diff::DiffApplicationResult::Ok)
     return 0;
 
@@ -5,6 +5,7 @@
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <exception>
 #include <functional>
@@ -13,6 +14,7 @@
 #include <iterator>
 #include <sstream>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace osm
@@ -623,4 +625,156 @@ public:
   }
 };
 
+// Splits o5m input into ranges between resets. Delta coded values and the string table start
+// from scratch at a reset, so every range is decoded by O5MSource on its own, e.g. concurrently.
+// Datasets other than nodes, ways and relations are dropped from the ranges.
+class O5MRangeSplitter
+{
+public:
+  O5MRangeSplitter(TReadFunc reader, size_t rangeSize, size_t maxRangeSize)
+    : m_reader(std::move(reader)), m_rangeSize(rangeSize), m_maxRangeSize(maxRangeSize)
+    , m_buffer(kBufferSize), m_range(std::begin(kRangeHeader), std::end(kRangeHeader))
+  {
+  }
+
+  // Reads the next range of at least |rangeSize| bytes, unless the input ends before.
+  // Returns false at the end of the input and when there is no reset within |maxRangeSize|
+  // bytes, see HasRest().
+  bool Read(std::vector<uint8_t> & range)
+  {
+    while (!m_eof && !m_hasRest)
+    {
+      uint8_t type;
+      bool const read = ReadBytes(&type, 1);
+      if (!m_started)
+      {
+        if (!read || type != base::Underlying(O5MSource::EntityType::Reset))
+          throw std::runtime_error("Incorrect o5m start");
+        m_started = true;
+      }
+
+      if (!read || type == base::Underlying(O5MSource::EntityType::End))
+      {
+        m_eof = true;
+        if (m_range.size() == std::size(kRangeHeader))
+          return false;
+        return TakeRange(range);
+      }
+
+      if (type == base::Underlying(O5MSource::EntityType::Reset))
+      {
+        if (m_range.size() - std::size(kRangeHeader) >= m_rangeSize)
+        {
+          TakeRange(range);
+          return true;
+        }
+        // A range starts with a reset anyway.
+        if (m_range.size() != std::size(kRangeHeader))
+          m_range.push_back(type);
+        continue;
+      }
+
+      // Datasets 0xf0-0xff are a single byte.
+      if (type >= 0xf0)
+        continue;
+
+      // Dataset: type, length, data.
+      size_t const start = m_range.size();
+      m_range.push_back(type);
+      uint64_t length = 0;
+      uint8_t byte;
+      uint32_t shift = 0;
+      do
+      {
+        CHECK(ReadBytes(&byte, 1), ("Truncated o5m dataset."));
+        m_range.push_back(byte);
+        length |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        shift += 7;
+      } while (byte & 0x80);
+
+      m_range.resize(m_range.size() + length);
+      CHECK(ReadBytes(m_range.data() + m_range.size() - length, length), ("Truncated o5m dataset."));
+
+      auto const entityType = O5MSource::EntityType(type);
+      if (entityType != O5MSource::EntityType::Node && entityType != O5MSource::EntityType::Way &&
+          entityType != O5MSource::EntityType::Relation)
+      {
+        m_range.resize(start);
+      }
+
+      m_hasRest = m_range.size() > m_maxRangeSize;
+    }
+    return false;
+  }
+
+  // True when the splitting is stopped because there are too few resets in the input.
+  bool HasRest() const { return m_hasRest; }
+
+  // Returns the rest of the input for O5MSource: the unfinished range and the unread input.
+  TReadFunc GetRestReader()
+  {
+    CHECK(m_hasRest, ());
+    std::vector<uint8_t> head = std::move(m_range);
+    head.insert(head.end(), m_buffer.begin() + m_bufferPos, m_buffer.begin() + m_bufferSize);
+    m_bufferPos = m_bufferSize = 0;
+
+    return [head = std::move(head), pos = size_t(0), reader = m_reader](uint8_t * buffer,
+                                                                         size_t size) mutable {
+      if (pos == head.size())
+        return reader(buffer, size);
+
+      size = std::min(size, head.size() - pos);
+      memcpy(buffer, head.data() + pos, size);
+      pos += size;
+      return size;
+    };
+  }
+
+private:
+  // Ranges are decoded as separate o5m files: reset, header, datasets, end.
+  static uint8_t constexpr kRangeHeader[] = {0xff, 0xe0, 0x04, 'o', '5', 'm', '2'};
+  static size_t constexpr kBufferSize = 1024 * 1024;
+
+  bool TakeRange(std::vector<uint8_t> & range)
+  {
+    m_range.push_back(base::Underlying(O5MSource::EntityType::End));
+    range.swap(m_range);
+    m_range.assign(std::begin(kRangeHeader), std::end(kRangeHeader));
+    return true;
+  }
+
+  bool ReadBytes(uint8_t * dest, size_t size)
+  {
+    while (size != 0)
+    {
+      if (m_bufferPos == m_bufferSize)
+      {
+        m_bufferPos = 0;
+        m_bufferSize = m_reader(m_buffer.data(), m_buffer.size());
+        if (m_bufferSize == 0)
+          return false;
+      }
+
+      size_t const n = std::min(size, m_bufferSize - m_bufferPos);
+      memcpy(dest, m_buffer.data() + m_bufferPos, n);
+      m_bufferPos += n;
+      dest += n;
+      size -= n;
+    }
+    return true;
+  }
+
+  TReadFunc m_reader;
+  size_t const m_rangeSize;
+  size_t const m_maxRangeSize;
+
+  std::vector<uint8_t> m_buffer;
+  size_t m_bufferPos = 0;
+  size_t m_bufferSize = 0;
+
+  std::vector<uint8_t> m_range;
+  bool m_started = false;
+  bool m_eof = false;
+  bool m_hasRest = false;
+};
 }  // namespace osm
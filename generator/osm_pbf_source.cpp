@@ -0,0 +1,556 @@
+#include "generator/osm_pbf_source.hpp"
+
+#include "coding/zlib.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace osm
+{
+namespace pbf
+{
+namespace
+{
+// Sizes limits from the format definition.
+uint32_t constexpr kMaxBlobHeaderSize = 64 * 1024;
+uint32_t constexpr kMaxBlobSize = 32 * 1024 * 1024;
+
+enum class WireType
+{
+  Varint = 0,
+  Fixed64 = 1,
+  LengthDelimited = 2,
+  Fixed32 = 5
+};
+
+// Minimal reader of the protobuf wire format, see
+// https://protobuf.dev/programming-guides/encoding/.
+class ProtoReader
+{
+public:
+  explicit ProtoReader(std::string_view data) : m_data(data) {}
+
+  // Reads the key of the next field, returns false at the end of the message.
+  bool Next()
+  {
+    if (m_pos == m_data.size())
+      return false;
+
+    auto const key = ReadVarint();
+    m_field = static_cast<uint32_t>(key >> 3);
+    m_wireType = static_cast<WireType>(key & 7);
+    return true;
+  }
+
+  uint32_t Field() const { return m_field; }
+
+  uint64_t Varint()
+  {
+    CHECK(m_wireType == WireType::Varint, ("Field", m_field, "is not a varint."));
+    return ReadVarint();
+  }
+
+  int64_t Int64() { return static_cast<int64_t>(Varint()); }
+  int64_t Sint64() { return DecodeZigZag(Varint()); }
+
+  std::string_view Bytes()
+  {
+    CHECK(m_wireType == WireType::LengthDelimited, ("Field", m_field, "is not length delimited."));
+    auto const size = ReadVarint();
+    CHECK_LESS_OR_EQUAL(size, m_data.size() - m_pos, ("Truncated field", m_field));
+    auto const bytes = m_data.substr(m_pos, static_cast<size_t>(size));
+    m_pos += bytes.size();
+    return bytes;
+  }
+
+  // Reads a repeated varint field which may be packed or not.
+  template <typename Fn>
+  void ForEachVarint(Fn && fn)
+  {
+    if (m_wireType == WireType::Varint)
+    {
+      fn(ReadVarint());
+      return;
+    }
+
+    ProtoReader packed(Bytes());
+    while (packed.m_pos < packed.m_data.size())
+      fn(packed.ReadVarint());
+  }
+
+  void Skip()
+  {
+    switch (m_wireType)
+    {
+    case WireType::Varint: ReadVarint(); break;
+    case WireType::Fixed64: Advance(8); break;
+    case WireType::LengthDelimited: Bytes(); break;
+    case WireType::Fixed32: Advance(4); break;
+    default: CHECK(false, ("Unsupported wire type of field", m_field));
+    }
+  }
+
+  static int64_t DecodeZigZag(uint64_t value)
+  {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+private:
+  uint64_t ReadVarint()
+  {
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+      CHECK_LESS(m_pos, m_data.size(), ("Truncated varint"));
+      auto const byte = static_cast<uint8_t>(m_data[m_pos++]);
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        return value;
+    }
+    CHECK(false, ("Too long varint"));
+    return value;
+  }
+
+  void Advance(size_t size)
+  {
+    CHECK_LESS_OR_EQUAL(size, m_data.size() - m_pos, ("Truncated field", m_field));
+    m_pos += size;
+  }
+
+  std::string_view m_data;
+  size_t m_pos = 0;
+  uint32_t m_field = 0;
+  WireType m_wireType = WireType::Varint;
+};
+
+template <typename T>
+void ReadDeltas(ProtoReader & reader, std::vector<T> & values)
+{
+  // Unpacked values continue the sequence.
+  int64_t value = values.empty() ? 0 : values.back();
+  reader.ForEachVarint([&](uint64_t delta) {
+    value += ProtoReader::DecodeZigZag(delta);
+    values.push_back(value);
+  });
+}
+
+template <typename T>
+void ReadValues(ProtoReader & reader, std::vector<T> & values)
+{
+  reader.ForEachVarint([&](uint64_t value) { values.push_back(static_cast<T>(value)); });
+}
+
+class BlockDecoder
+{
+public:
+  explicit BlockDecoder(std::vector<OsmElement> & elements) : m_elements(elements) {}
+
+  void Decode(std::string_view block)
+  {
+    // Granularity and offsets follow the groups, so the groups are decoded afterwards.
+    std::vector<std::string_view> groups;
+    ProtoReader reader(block);
+    while (reader.Next())
+    {
+      switch (reader.Field())
+      {
+      case 1: ReadStringTable(reader.Bytes()); break;
+      case 2: groups.push_back(reader.Bytes()); break;
+      case 17: m_granularity = reader.Int64(); break;
+      case 19: m_latOffset = reader.Int64(); break;
+      case 20: m_lonOffset = reader.Int64(); break;
+      default: reader.Skip(); break;
+      }
+    }
+
+    for (auto const group : groups)
+      DecodeGroup(group);
+  }
+
+private:
+  void ReadStringTable(std::string_view table)
+  {
+    ProtoReader reader(table);
+    while (reader.Next())
+    {
+      if (reader.Field() == 1)
+        m_strings.push_back(reader.Bytes());
+      else
+        reader.Skip();
+    }
+  }
+
+  std::string_view GetString(uint64_t index) const
+  {
+    CHECK_LESS(index, m_strings.size(), ("Wrong string index"));
+    return m_strings[static_cast<size_t>(index)];
+  }
+
+  // Coordinates are stored in nanodegrees. Division keeps them equal to the ones of o5m
+  // and xml sources, which are 100-nanodegree integers divided by 1e7.
+  double ToDegrees(int64_t offset, int64_t value) const
+  {
+    return static_cast<double>(offset + m_granularity * value) / 1e9;
+  }
+
+  void DecodeGroup(std::string_view group)
+  {
+    ProtoReader reader(group);
+    while (reader.Next())
+    {
+      switch (reader.Field())
+      {
+      case 1: DecodeNode(reader.Bytes()); break;
+      case 2: DecodeDenseNodes(reader.Bytes()); break;
+      case 3: DecodeWay(reader.Bytes()); break;
+      case 4: DecodeRelation(reader.Bytes()); break;
+      // Changesets are skipped.
+      default: reader.Skip(); break;
+      }
+    }
+  }
+
+  void AddTags(OsmElement & element) const
+  {
+    CHECK_EQUAL(m_keys.size(), m_vals.size(), ("Keys and values mismatch, id:", element.m_id));
+    for (size_t i = 0; i < m_keys.size(); ++i)
+      element.AddTag(GetString(m_keys[i]), GetString(m_vals[i]));
+  }
+
+  OsmElement & AddElement(OsmElement::EntityType type, int64_t id)
+  {
+    auto & element = m_elements.emplace_back();
+    element.m_type = type;
+    element.m_id = static_cast<uint64_t>(id);
+    return element;
+  }
+
+  void DecodeNode(std::string_view message)
+  {
+    int64_t id = 0;
+    int64_t lat = 0;
+    int64_t lon = 0;
+    m_keys.clear();
+    m_vals.clear();
+
+    ProtoReader reader(message);
+    while (reader.Next())
+    {
+      switch (reader.Field())
+      {
+      case 1: id = reader.Sint64(); break;
+      case 2: ReadValues(reader, m_keys); break;
+      case 3: ReadValues(reader, m_vals); break;
+      case 8: lat = reader.Sint64(); break;
+      case 9: lon = reader.Sint64(); break;
+      default: reader.Skip(); break;
+      }
+    }
+
+    auto & element = AddElement(OsmElement::EntityType::Node, id);
+    element.m_lat = ToDegrees(m_latOffset, lat);
+    element.m_lon = ToDegrees(m_lonOffset, lon);
+    AddTags(element);
+    element.Validate();
+  }
+
+  void DecodeDenseNodes(std::string_view message)
+  {
+    m_ids.clear();
+    m_lats.clear();
+    m_lons.clear();
+    m_keysVals.clear();
+
+    ProtoReader reader(message);
+    while (reader.Next())
+    {
+      switch (reader.Field())
+      {
+      case 1: ReadDeltas(reader, m_ids); break;
+      case 8: ReadDeltas(reader, m_lats); break;
+      case 9: ReadDeltas(reader, m_lons); break;
+      case 10: ReadValues(reader, m_keysVals); break;
+      default: reader.Skip(); break;
+      }
+    }
+
+    CHECK(m_ids.size() == m_lats.size() && m_ids.size() == m_lons.size(),
+          ("Dense nodes mismatch:", m_ids.size(), m_lats.size(), m_lons.size()));
+
+    // Tags of all the nodes are stored as key, value, ..., 0 per node.
+    // There are no tags at all when none of the nodes has tags.
+    size_t tag = 0;
+    for (size_t i = 0; i < m_ids.size(); ++i)
+    {
+      auto & element = AddElement(OsmElement::EntityType::Node, m_ids[i]);
+      element.m_lat = ToDegrees(m_latOffset, m_lats[i]);
+      element.m_lon = ToDegrees(m_lonOffset, m_lons[i]);
+
+      while (tag < m_keysVals.size() && m_keysVals[tag] != 0)
+      {
+        CHECK_LESS(tag + 1, m_keysVals.size(), ("Dense node tags mismatch, id:", element.m_id));
+        element.AddTag(GetString(m_keysVals[tag]), GetString(m_keysVals[tag + 1]));
+        tag += 2;
+      }
+      ++tag;
+      element.Validate();
+    }
+  }
+
+  void DecodeWay(std::string_view message)
+  {
+    int64_t id = 0;
+    m_keys.clear();
+    m_vals.clear();
+    m_refs.clear();
+
+    ProtoReader reader(message);
+    while (reader.Next())
+    {
+      switch (reader.Field())
+      {
+      case 1: id = reader.Int64(); break;
+      case 2: ReadValues(reader, m_keys); break;
+      case 3: ReadValues(reader, m_vals); break;
+      case 8: ReadDeltas(reader, m_refs); break;
+      default: reader.Skip(); break;
+      }
+    }
+
+    auto & element = AddElement(OsmElement::EntityType::Way, id);
+    element.NodesRef().reserve(m_refs.size());
+    for (auto const ref : m_refs)
+      element.AddNd(static_cast<uint64_t>(ref));
+    AddTags(element);
+    element.Validate();
+  }
+
+  void DecodeRelation(std::string_view message)
+  {
+    int64_t id = 0;
+    m_keys.clear();
+    m_vals.clear();
+    m_roles.clear();
+    m_refs.clear();
+    m_types.clear();
+
+    ProtoReader reader(message);
+    while (reader.Next())
+    {
+      switch (reader.Field())
+      {
+      case 1: id = reader.Int64(); break;
+      case 2: ReadValues(reader, m_keys); break;
+      case 3: ReadValues(reader, m_vals); break;
+      case 8: ReadValues(reader, m_roles); break;
+      case 9: ReadDeltas(reader, m_refs); break;
+      case 10: ReadValues(reader, m_types); break;
+      default: reader.Skip(); break;
+      }
+    }
+
+    CHECK(m_refs.size() == m_roles.size() && m_refs.size() == m_types.size(),
+          ("Relation members mismatch, id:", id));
+
+    auto & element = AddElement(OsmElement::EntityType::Relation, id);
+    for (size_t i = 0; i < m_refs.size(); ++i)
+    {
+      auto type = OsmElement::EntityType::Unknown;
+      switch (m_types[i])
+      {
+      case 0: type = OsmElement::EntityType::Node; break;
+      case 1: type = OsmElement::EntityType::Way; break;
+      case 2: type = OsmElement::EntityType::Relation; break;
+      }
+      element.AddMember(static_cast<uint64_t>(m_refs[i]), type, std::string(GetString(m_roles[i])));
+    }
+    AddTags(element);
+    element.Validate();
+  }
+
+  std::vector<OsmElement> & m_elements;
+
+  std::vector<std::string_view> m_strings;
+  int64_t m_granularity = 100;
+  int64_t m_latOffset = 0;
+  int64_t m_lonOffset = 0;
+
+  // Buffers which are reused by all the elements of the block.
+  std::vector<uint32_t> m_keys;
+  std::vector<uint32_t> m_vals;
+  std::vector<int64_t> m_ids;
+  std::vector<int64_t> m_lats;
+  std::vector<int64_t> m_lons;
+  std::vector<uint32_t> m_keysVals;
+  std::vector<int64_t> m_refs;
+  std::vector<uint32_t> m_roles;
+  std::vector<uint32_t> m_types;
+};
+
+// Returns the uncompressed data of the Blob message.
+std::string Uncompress(std::string_view blob)
+{
+  std::string_view raw;
+  std::string_view zlibData;
+  uint64_t rawSize = 0;
+
+  ProtoReader reader(blob);
+  while (reader.Next())
+  {
+    switch (reader.Field())
+    {
+    case 1: raw = reader.Bytes(); break;
+    case 2: rawSize = reader.Varint(); break;
+    case 3: zlibData = reader.Bytes(); break;
+    case 4: case 5: case 6: case 7:
+      CHECK(false, ("Only zlib compressed pbf blobs are supported."));
+      break;
+    default: reader.Skip(); break;
+    }
+  }
+
+  if (zlibData.empty())
+    return std::string(raw);
+
+  CHECK_LESS_OR_EQUAL(rawSize, kMaxBlobSize, ());
+  std::string data;
+  data.reserve(static_cast<size_t>(rawSize));
+  coding::ZLib::Inflate const inflate(coding::ZLib::Inflate::Format::ZLib);
+  CHECK(inflate(zlibData.data(), zlibData.size(), std::back_inserter(data)),
+        ("Can't inflate pbf blob."));
+  CHECK_EQUAL(data.size(), rawSize, ("Broken pbf blob."));
+  return data;
+}
+
+void CheckHeaderBlock(std::string_view block)
+{
+  ProtoReader reader(block);
+  while (reader.Next())
+  {
+    // Required features.
+    if (reader.Field() == 4)
+    {
+      auto const feature = reader.Bytes();
+      CHECK(feature == "OsmSchema-V0.6" || feature == "DenseNodes",
+            ("Unsupported pbf feature:", std::string(feature)));
+    }
+    else
+    {
+      reader.Skip();
+    }
+  }
+}
+}  // namespace
+
+void DecodePrimitiveBlock(std::string_view block, std::vector<OsmElement> & elements)
+{
+  BlockDecoder(elements).Decode(block);
+}
+}  // namespace pbf
+
+// PbfSource ---------------------------------------------------------------------------------------
+PbfSource::PbfSource(ReadFunc && reader, size_t threadsCount)
+  : m_reader(std::move(reader))
+  , m_maxPendingBlocks(2 * threadsCount)
+  , m_pool(threadsCount)
+{
+}
+
+bool PbfSource::Read(std::vector<OsmElement> & elements)
+{
+  do
+  {
+    ReadAhead();
+    if (m_pendingBlocks.empty())
+      return false;
+
+    elements = m_pendingBlocks.front().get();
+    m_pendingBlocks.pop();
+  } while (elements.empty());
+
+  return true;
+}
+
+void PbfSource::ReadAhead()
+{
+  std::string type;
+  std::string blob;
+  while (!m_eof && m_pendingBlocks.size() < m_maxPendingBlocks)
+  {
+    if (!ReadBlob(type, blob))
+    {
+      m_eof = true;
+      break;
+    }
+
+    if (type == "OSMHeader")
+    {
+      pbf::CheckHeaderBlock(pbf::Uncompress(blob));
+      continue;
+    }
+
+    // Unknown blobs must be skipped according to the format.
+    if (type != "OSMData")
+      continue;
+
+    m_pendingBlocks.push(m_pool.Submit([blob = std::move(blob)]() {
+      std::vector<OsmElement> elements;
+      pbf::DecodePrimitiveBlock(pbf::Uncompress(blob), elements);
+      return elements;
+    }));
+    blob.clear();
+  }
+}
+
+bool PbfSource::ReadBlob(std::string & type, std::string & blob)
+{
+  uint8_t sizeBytes[4];
+  auto const read = m_reader(sizeBytes, sizeof(sizeBytes));
+  if (read == 0)
+    return false;
+  CHECK(ReadExactly(sizeBytes + read, sizeof(sizeBytes) - read), ("Truncated pbf blob header size."));
+
+  uint32_t const headerSize = (uint32_t(sizeBytes[0]) << 24) | (uint32_t(sizeBytes[1]) << 16) |
+                              (uint32_t(sizeBytes[2]) << 8) | uint32_t(sizeBytes[3]);
+  CHECK_LESS_OR_EQUAL(headerSize, pbf::kMaxBlobHeaderSize, ("Wrong pbf blob header size."));
+
+  std::string header(headerSize, '\0');
+  CHECK(ReadExactly(header.data(), header.size()), ("Truncated pbf blob header."));
+
+  uint64_t blobSize = 0;
+  type.clear();
+  pbf::ProtoReader reader(header);
+  while (reader.Next())
+  {
+    switch (reader.Field())
+    {
+    case 1: type = reader.Bytes(); break;
+    case 3: blobSize = reader.Varint(); break;
+    default: reader.Skip(); break;
+    }
+  }
+  CHECK_LESS_OR_EQUAL(blobSize, pbf::kMaxBlobSize, ("Wrong pbf blob size."));
+
+  blob.resize(static_cast<size_t>(blobSize));
+  CHECK(ReadExactly(blob.data(), blob.size()), ("Truncated pbf blob."));
+  return true;
+}
+
+bool PbfSource::ReadExactly(void * buffer, size_t size)
+{
+  auto * p = static_cast<uint8_t *>(buffer);
+  while (size != 0)
+  {
+    auto const read = m_reader(p, size);
+    if (read == 0)
+      return false;
+    p += read;
+    size -= read;
+  }
+  return true;
+}
+}  // namespace osm
@@ -0,0 +1,54 @@
+// See PBF Format definition at https://wiki.openstreetmap.org/wiki/PBF_Format
+#pragma once
+
+#include "generator/osm_element.hpp"
+
+#include "base/thread_pool_computational.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace osm
+{
+namespace pbf
+{
+// Decodes a PrimitiveBlock message to |elements| in the order of the block.
+void DecodePrimitiveBlock(std::string_view block, std::vector<OsmElement> & elements);
+}  // namespace pbf
+
+// Reads OSM PBF files. Blobs are read by the calling thread, then they are decompressed and
+// decoded on a thread pool, so the reading scales with the number of threads. Elements are
+// returned in the order of the file.
+//
+// Only zlib compressed and raw blobs are supported. That's what all the planet and extract
+// dumps use.
+class PbfSource
+{
+public:
+  using ReadFunc = std::function<size_t(uint8_t *, size_t)>;
+
+  PbfSource(ReadFunc && reader, size_t threadsCount);
+
+  // Returns elements of the next block which has any, false at the end of the input.
+  bool Read(std::vector<OsmElement> & elements);
+
+private:
+  // Reads the next blob of |type|, returns false at the end of the input.
+  bool ReadBlob(std::string & type, std::string & blob);
+  bool ReadExactly(void * buffer, size_t size);
+  void ReadAhead();
+
+  ReadFunc m_reader;
+  size_t const m_maxPendingBlocks;
+  bool m_eof = false;
+  std::queue<std::future<std::vector<OsmElement>>> m_pendingBlocks;
+  // The pool is the last member, so the tasks are finished before the other members are gone.
+  base::ComputationalThreadPool m_pool;
+};
+}  // namespace osm
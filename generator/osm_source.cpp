@@ -9,9 +9,15 @@
 
 #include "base/assert.hpp"
 #include "base/stl_helpers.hpp"
+#include "base/thread_pool_computational.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <future>
 #include <memory>
+#include <queue>
+#include <vector>
 
 #include "defines.hpp"
 
@@ -100,44 +106,10 @@ void AddElementToCache(cache::IntermediateDataWriter & cache, OsmElement && elem
   }
 }
 
-void ProcessOsmElementsFromXML(SourceReader & stream, std::function<void(OsmElement &&)> const & processor)
-{
-  ProcessorOsmElementsFromXml processorOsmElementsFromXml(stream);
-  OsmElement element;
-  while (processorOsmElementsFromXml.TryRead(element))
-  {
-    processor(std::move(element));
-    // It is safe to use `element` here as `Clear` will restore the state after the move.
-    element.Clear();
-  }
-}
-
-void ProcessOsmElementsFromO5M(SourceReader & stream, std::function<void(OsmElement &&)> const & processor)
-{
-  ProcessorOsmElementsFromO5M processorOsmElementsFromO5M(stream);
-  OsmElement element;
-  while (processorOsmElementsFromO5M.TryRead(element))
-  {
-    processor(std::move(element));
-    // It is safe to use `element` here as `Clear` will restore the state after the move.
-    element.Clear();
-  }
-}
-
-ProcessorOsmElementsFromO5M::ProcessorOsmElementsFromO5M(SourceReader & stream)
-  : m_stream(stream)
-  , m_dataset([&](uint8_t * buffer, size_t size) {
-      return m_stream.Read(reinterpret_cast<char *>(buffer), size);
-  })
-  , m_pos(m_dataset.begin())
+namespace
 {
-}
-
-bool ProcessorOsmElementsFromO5M::TryRead(OsmElement & element)
+void ReadO5MEntity(osm::O5MSource::Entity const & entity, OsmElement & element)
 {
-  if (m_pos == m_dataset.end())
-    return false;
-
   using Type = osm::O5MSource::EntityType;
   auto const translate = [](Type t) -> OsmElement::EntityType {
     switch (t)
@@ -154,7 +126,6 @@ bool ProcessorOsmElementsFromO5M::TryRead(OsmElement & element)
   // iterating in loop. Furthermore, into Tags() method calls Nodes.Skip() and Members.Skip(),
   // thus first call of Nodes (Members) after Tags() will not return any results.
   // So don not reorder the "for" loops (!).
-  auto const & entity = *m_pos;
   element.m_id = entity.id;
   switch (entity.type)
   {
@@ -186,7 +157,216 @@ bool ProcessorOsmElementsFromO5M::TryRead(OsmElement & element)
     element.AddTag(tag.key, tag.value);
 
   element.Validate();
-  ++m_pos;
+}
+
+// Converts nodes to mercator on a thread pool, in batches. The converted batches are stored
+// on the calling thread in the order of the nodes, so the storages see the ids in the file order.
+class ParallelNodesWriter
+{
+public:
+  ParallelNodesWriter(cache::PointStorageWriterInterface & nodes, size_t threadsCount)
+    : m_nodes(nodes), m_maxPendingBatches(2 * threadsCount), m_pool(threadsCount)
+  {
+  }
+
+  void Add(OsmElement const & node)
+  {
+    m_batch.push_back({node.m_id, node.m_lat, node.m_lon});
+    if (m_batch.size() == kBatchSize)
+      Flush();
+  }
+
+  // Stores all the added nodes.
+  void Finish()
+  {
+    Flush();
+    while (!m_pendingBatches.empty())
+      StoreFront();
+  }
+
+private:
+  static size_t constexpr kBatchSize = 64 * 1024;
+
+  struct Node
+  {
+    uint64_t m_id;
+    double m_lat;
+    double m_lon;
+  };
+
+  void Flush()
+  {
+    if (m_batch.empty())
+      return;
+
+    if (m_pendingBatches.size() == m_maxPendingBatches)
+      StoreFront();
+
+    m_pendingBatches.push(m_pool.Submit([batch = std::move(m_batch)]() mutable {
+      for (auto & node : batch)
+      {
+        auto const pt = mercator::FromLatLon(node.m_lat, node.m_lon);
+        node.m_lat = pt.y;
+        node.m_lon = pt.x;
+      }
+      return std::move(batch);
+    }));
+    m_batch = {};
+    m_batch.reserve(kBatchSize);
+  }
+
+  void StoreFront()
+  {
+    for (auto const & node : m_pendingBatches.front().get())
+      m_nodes.AddPoint(node.m_id, node.m_lat, node.m_lon);
+    m_pendingBatches.pop();
+  }
+
+  cache::PointStorageWriterInterface & m_nodes;
+  size_t const m_maxPendingBatches;
+  std::vector<Node> m_batch;
+  std::queue<std::future<std::vector<Node>>> m_pendingBatches;
+  base::ComputationalThreadPool m_pool;
+};
+}  // namespace
+
+void ProcessOsmElementsFromXML(SourceReader & stream, std::function<void(OsmElement &&)> const & processor)
+{
+  ProcessorOsmElementsFromXml processorOsmElementsFromXml(stream);
+  OsmElement element;
+  while (processorOsmElementsFromXml.TryRead(element))
+  {
+    processor(std::move(element));
+    // It is safe to use `element` here as `Clear` will restore the state after the move.
+    element.Clear();
+  }
+}
+
+void ProcessOsmElementsFromO5M(SourceReader & stream, std::function<void(OsmElement &&)> const & processor,
+                               size_t threadsCount)
+{
+  ProcessorOsmElementsFromO5M processorOsmElementsFromO5M(stream, threadsCount);
+  OsmElement element;
+  while (processorOsmElementsFromO5M.TryRead(element))
+  {
+    processor(std::move(element));
+    // It is safe to use `element` here as `Clear` will restore the state after the move.
+    element.Clear();
+  }
+}
+
+void ProcessOsmElementsFromPbf(SourceReader & stream, std::function<void(OsmElement &&)> const & processor,
+                               size_t threadsCount)
+{
+  ProcessorOsmElementsFromPbf processorOsmElementsFromPbf(stream, threadsCount);
+  OsmElement element;
+  while (processorOsmElementsFromPbf.TryRead(element))
+  {
+    processor(std::move(element));
+    // It is safe to use `element` here as `Clear` will restore the state after the move.
+    element.Clear();
+  }
+}
+
+ProcessorOsmElementsFromO5M::ProcessorOsmElementsFromO5M(SourceReader & stream, size_t threadsCount,
+                                                         size_t rangeSize, size_t maxRangeSize)
+  : m_stream(stream)
+{
+  auto reader = [this](uint8_t * buffer, size_t size) {
+    return m_stream.Read(reinterpret_cast<char *>(buffer), size);
+  };
+
+  if (threadsCount <= 1)
+  {
+    m_dataset = std::make_unique<osm::O5MSource>(reader);
+    m_pos.emplace(m_dataset->begin());
+    return;
+  }
+
+  m_splitter = std::make_unique<osm::O5MRangeSplitter>(reader, rangeSize, maxRangeSize);
+  m_maxPendingRanges = 2 * threadsCount;
+  m_pool = std::make_unique<base::ComputationalThreadPool>(threadsCount);
+}
+
+bool ProcessorOsmElementsFromO5M::TryRead(OsmElement & element)
+{
+  if (m_splitter)
+  {
+    if (TryReadFromRanges(element))
+      return true;
+    if (!m_splitter->HasRest())
+      return false;
+
+    LOG(LWARNING, ("Too few resets in the o5m input, the rest of it is decoded sequentially."));
+    m_dataset = std::make_unique<osm::O5MSource>(m_splitter->GetRestReader());
+    m_pos.emplace(m_dataset->begin());
+    m_splitter.reset();
+  }
+
+  if (*m_pos == m_dataset->end())
+    return false;
+
+  ReadO5MEntity(**m_pos, element);
+  ++*m_pos;
+  return true;
+}
+
+bool ProcessorOsmElementsFromO5M::TryReadFromRanges(OsmElement & element)
+{
+  while (m_elementsPos == m_elements.size())
+  {
+    ReadAhead();
+    if (m_pendingRanges.empty())
+      return false;
+
+    m_elements = m_pendingRanges.front().get();
+    m_pendingRanges.pop();
+    m_elementsPos = 0;
+  }
+
+  element = std::move(m_elements[m_elementsPos++]);
+  return true;
+}
+
+void ProcessorOsmElementsFromO5M::ReadAhead()
+{
+  std::vector<uint8_t> range;
+  while (m_pendingRanges.size() < m_maxPendingRanges && m_splitter->Read(range))
+  {
+    m_pendingRanges.push(m_pool->Submit([range = std::move(range)]() {
+      osm::O5MSource dataset([&range, pos = size_t(0)](uint8_t * buffer, size_t size) mutable {
+        size = std::min(size, range.size() - pos);
+        memcpy(buffer, range.data() + pos, size);
+        pos += size;
+        return size;
+      });
+
+      std::vector<OsmElement> elements;
+      for (auto const & entity : dataset)
+        ReadO5MEntity(entity, elements.emplace_back());
+      return elements;
+    }));
+    range.clear();
+  }
+}
+
+ProcessorOsmElementsFromPbf::ProcessorOsmElementsFromPbf(SourceReader & stream, size_t threadsCount)
+  : m_source([&stream](uint8_t * buffer, size_t size) {
+      return stream.Read(reinterpret_cast<char *>(buffer), size);
+    }, threadsCount)
+{
+}
+
+bool ProcessorOsmElementsFromPbf::TryRead(OsmElement & element)
+{
+  if (m_pos == m_elements.size())
+  {
+    if (!m_source.Read(m_elements))
+      return false;
+    m_pos = 0;
+  }
+
+  element = std::move(m_elements[m_pos++]);
   return true;
 }
 
@@ -231,6 +411,9 @@ bool GenerateIntermediateData(feature::GenerateInfo & info)
   auto nodes =
       cache::CreatePointStorageWriter(info.m_nodeStorageType, info.GetCacheFileName(NODES_FILE));
   cache::IntermediateDataWriter cache(*nodes, info);
+  std::unique_ptr<ParallelNodesWriter> nodesWriter;
+  if (info.m_threadsCount > 1)
+    nodesWriter = std::make_unique<ParallelNodesWriter>(*nodes, info.m_threadsCount);
   TownsDumper towns;
   SourceReader reader = info.m_osmFileName.empty() ? SourceReader() : SourceReader(info.m_osmFileName);
 
@@ -239,7 +422,10 @@ bool GenerateIntermediateData(feature::GenerateInfo & info)
   auto const processor = [&](OsmElement && element)
   {
     towns.CheckElement(element);
-    AddElementToCache(cache, std::move(element));
+    if (nodesWriter && element.IsNode())
+      nodesWriter->Add(element);
+    else
+      AddElementToCache(cache, std::move(element));
   };
 
   switch (info.m_osmFileType)
@@ -248,10 +434,15 @@ bool GenerateIntermediateData(feature::GenerateInfo & info)
     ProcessOsmElementsFromXML(reader, processor);
     break;
   case feature::GenerateInfo::OsmSourceType::O5M:
-    ProcessOsmElementsFromO5M(reader, processor);
+    ProcessOsmElementsFromO5M(reader, processor, info.m_threadsCount);
+    break;
+  case feature::GenerateInfo::OsmSourceType::PBF:
+    ProcessOsmElementsFromPbf(reader, processor, info.m_threadsCount);
     break;
   }
 
+  if (nodesWriter)
+    nodesWriter->Finish();
   cache.SaveIndex();
   towns.Dump(info.GetIntermediateFileName(TOWNS_FILE));
   LOG(LINFO, ("Added points count =", nodes->GetNumProcessedPoints()));
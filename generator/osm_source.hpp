@@ -3,17 +3,23 @@
 #include "generator/generate_info.hpp"
 #include "generator/intermediate_data.hpp"
 #include "generator/osm_o5m_source.hpp"
+#include "generator/osm_pbf_source.hpp"
 #include "generator/osm_xml_source.hpp"
 #include "generator/translator_interface.hpp"
 
 #include "coding/parse_xml.hpp"
 
+#include "base/thread_pool_computational.hpp"
+
 #include <functional>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <sstream>
 #include <string>
+#include <vector>
 
 struct OsmElement;
 class FeatureParams;
@@ -47,8 +53,11 @@ public:
 
 bool GenerateIntermediateData(feature::GenerateInfo & info);
 
-void ProcessOsmElementsFromO5M(SourceReader & stream, std::function<void (OsmElement &&)> const & processor);
+void ProcessOsmElementsFromO5M(SourceReader & stream, std::function<void (OsmElement &&)> const & processor,
+                               size_t threadsCount = 1);
 void ProcessOsmElementsFromXML(SourceReader & stream, std::function<void (OsmElement &&)> const & processor);
+void ProcessOsmElementsFromPbf(SourceReader & stream, std::function<void (OsmElement &&)> const & processor,
+                               size_t threadsCount);
 
 class ProcessorOsmElementsInterface
 {
@@ -58,18 +67,57 @@ public:
   virtual bool TryRead(OsmElement & element) = 0;
 };
 
+// When |threadsCount| > 1 ranges of the input between o5m resets are decoded concurrently,
+// see osm::O5MRangeSplitter. Elements are returned in the order of the input anyway.
+// The input is decoded sequentially from the first range without resets
+// within kMaxRangeSize bytes on.
 class ProcessorOsmElementsFromO5M : public ProcessorOsmElementsInterface
 {
 public:
-  explicit ProcessorOsmElementsFromO5M(SourceReader & stream);
+  static size_t constexpr kRangeSize = 1024 * 1024;
+  static size_t constexpr kMaxRangeSize = 256 * 1024 * 1024;
+
+  explicit ProcessorOsmElementsFromO5M(SourceReader & stream, size_t threadsCount = 1,
+                                       size_t rangeSize = kRangeSize,
+                                       size_t maxRangeSize = kMaxRangeSize);
 
   // ProcessorOsmElementsInterface overrides:
   bool TryRead(OsmElement & element) override;
 
 private:
+  void ReadAhead();
+  bool TryReadFromRanges(OsmElement & element);
+
   SourceReader & m_stream;
-  osm::O5MSource m_dataset;
-  osm::O5MSource::Iterator m_pos;
+
+  // Sequential decoding.
+  std::unique_ptr<osm::O5MSource> m_dataset;
+  // Iterators are not assignable.
+  std::optional<osm::O5MSource::Iterator> m_pos;
+
+  // Concurrent decoding of the ranges.
+  std::unique_ptr<osm::O5MRangeSplitter> m_splitter;
+  size_t m_maxPendingRanges = 0;
+  std::queue<std::future<std::vector<OsmElement>>> m_pendingRanges;
+  std::vector<OsmElement> m_elements;
+  size_t m_elementsPos = 0;
+  // The pool is the last member, so the tasks are finished before the other members are gone.
+  std::unique_ptr<base::ComputationalThreadPool> m_pool;
+};
+
+// Blobs are decoded on |threadsCount| threads, see osm::PbfSource.
+class ProcessorOsmElementsFromPbf : public ProcessorOsmElementsInterface
+{
+public:
+  ProcessorOsmElementsFromPbf(SourceReader & stream, size_t threadsCount);
+
+  // ProcessorOsmElementsInterface overrides:
+  bool TryRead(OsmElement & element) override;
+
+private:
+  osm::PbfSource m_source;
+  std::vector<OsmElement> m_elements;
+  size_t m_pos = 0;
 };
 
 class ProcessorOsmElementsFromXml : public ProcessorOsmElementsInterface
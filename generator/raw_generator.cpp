@@ -9,6 +9,7 @@
 #include "generator/osm_source.hpp"
 #include "generator/processor_factory.hpp"
 #include "generator/raw_generator_writer.hpp"
+#include "generator/stage_profiler.hpp"
 #include "generator/translator_factory.hpp"
 #include "generator/translators_pool.hpp"
 
@@ -86,6 +87,7 @@ RawGenerator::RawGenerator(feature::GenerateInfo & genInfo, size_t threadsCount,
   , m_cache(std::make_shared<generator::cache::IntermediateData>(m_intermediateDataObjectsCache, genInfo))
   , m_queue(std::make_shared<FeatureProcessorQueue>())
   , m_translators(std::make_shared<TranslatorCollection>())
+  , m_finalProcessors(threadsCount)
 {
 }
 
@@ -118,38 +120,40 @@ void RawGenerator::GenerateCountries(bool isTests/* = false*/)
   /// and dispatches FB into Coastline, World, Country, City processors.
   /// Now we have at least 2x similar work in OsmElement->GetNameAndType->FeatureBuilder (for Country and World).
 
-  m_translators->Append(CreateTranslator(TranslatorType::Country, processor, m_cache, m_genInfo,
-                                         isTests ? nullptr : affiliation));
+  m_translators->Append(ProfileTranslator(CreateTranslator(
+      TranslatorType::Country, processor, m_cache, m_genInfo, isTests ? nullptr : affiliation)));
 
-  m_finalProcessors.emplace(CreateCountryFinalProcessor(affiliation, false));
-  m_finalProcessors.emplace(CreatePlacesFinalProcessor(affiliation));
+  m_countryFinalProcessor = CreateCountryFinalProcessor(affiliation, false);
+  m_placesFinalProcessor = CreatePlacesFinalProcessor(affiliation);
 }
 
 void RawGenerator::GenerateWorld(bool cutBordersByWater/* = true */)
 {
   auto processor = CreateProcessor(ProcessorType::World, m_queue, m_genInfo.m_popularPlacesFilename);
-  m_translators->Append(CreateTranslator(TranslatorType::World, processor, m_cache, m_genInfo));
-  m_finalProcessors.emplace(CreateWorldFinalProcessor(cutBordersByWater));
+  m_translators->Append(
+      ProfileTranslator(CreateTranslator(TranslatorType::World, processor, m_cache, m_genInfo)));
+  m_worldFinalProcessor = CreateWorldFinalProcessor(cutBordersByWater);
 }
 
 void RawGenerator::GenerateCoasts()
 {
   auto processor = CreateProcessor(ProcessorType::Coastline, m_queue);
-  m_translators->Append(CreateTranslator(TranslatorType::Coastline, processor, m_cache));
-  m_finalProcessors.emplace(CreateCoslineFinalProcessor());
+  m_translators->Append(
+      ProfileTranslator(CreateTranslator(TranslatorType::Coastline, processor, m_cache)));
+  m_coastlineFinalProcessor = CreateCoslineFinalProcessor();
 }
 
 void RawGenerator::GenerateCustom(std::shared_ptr<TranslatorInterface> const & translator)
 {
-  m_translators->Append(translator);
+  m_translators->Append(ProfileTranslator(translator));
 }
 
 void RawGenerator::GenerateCustom(
     std::shared_ptr<TranslatorInterface> const & translator,
     std::shared_ptr<FinalProcessorIntermediateMwmInterface> const & finalProcessor)
 {
-  m_translators->Append(translator);
-  m_finalProcessors.emplace(finalProcessor);
+  m_translators->Append(ProfileTranslator(translator));
+  m_finalProcessors.Add(finalProcessor);
 }
 
 bool RawGenerator::Execute()
@@ -162,15 +166,31 @@ bool RawGenerator::Execute()
   m_queue.reset();
   m_intermediateDataObjectsCache.Clear();
 
-  while (!m_finalProcessors.empty())
+  AddFinalProcessors();
+  m_finalProcessors.Run();
+  LOG(LINFO, ("Final processing is finished."));
+  return true;
+}
+
+void RawGenerator::AddFinalProcessors()
+{
+  // Coastline and Places don't wait for the other processors. Country and World read
+  // the coastlines and the features which Places appends to the country and World files.
+  std::vector<FinalProcessorPtr> coastsAndPlaces;
+  for (auto const & processor : {m_coastlineFinalProcessor, m_placesFinalProcessor})
   {
-    auto const finalProcessor = m_finalProcessors.top();
-    m_finalProcessors.pop();
-    finalProcessor->Process();
+    if (!processor)
+      continue;
+
+    m_finalProcessors.Add(processor, {} /* dependencies */);
+    coastsAndPlaces.emplace_back(processor);
   }
 
-  LOG(LINFO, ("Final processing is finished."));
-  return true;
+  for (auto const & processor : {m_countryFinalProcessor, m_worldFinalProcessor})
+  {
+    if (processor)
+      m_finalProcessors.Add(processor, coastsAndPlaces);
+  }
 }
 
 RawGenerator::FinalProcessorPtr RawGenerator::CreateCoslineFinalProcessor()
@@ -188,6 +208,7 @@ RawGenerator::FinalProcessorPtr RawGenerator::CreateCountryFinalProcessor(
 {
   auto finalProcessor = std::make_shared<CountryFinalProcessor>(affiliations, m_genInfo.m_tmpDir, m_threadsCount);
   finalProcessor->SetIsolinesDir(m_genInfo.m_isolinesDir);
+  finalProcessor->SetFeaturesBlockOptions(GetFeaturesBlockOptions());
   finalProcessor->SetMiniRoundabouts(m_genInfo.GetIntermediateFileName(MINI_ROUNDABOUTS_FILENAME));
   finalProcessor->SetAddrInterpolation(m_genInfo.GetIntermediateFileName(ADDR_INTERPOL_FILENAME));
   if (addAds)
@@ -223,9 +244,18 @@ RawGenerator::FinalProcessorPtr RawGenerator::CreatePlacesFinalProcessor(Affilia
   auto finalProcessor = std::make_shared<FinalProcessorCities>(affiliations, m_genInfo.m_tmpDir, m_threadsCount);
   finalProcessor->SetCityBoundariesFiles(m_genInfo.GetIntermediateFileName(CITY_BOUNDARIES_COLLECTOR_FILENAME),
                                          m_genInfo.m_citiesBoundariesFilename);
+  finalProcessor->SetFeaturesBlockOptions(GetFeaturesBlockOptions());
   return finalProcessor;
 }
 
+feature::FeaturesBlockOptions RawGenerator::GetFeaturesBlockOptions() const
+{
+  feature::FeaturesBlockOptions options;
+  options.m_quantize = m_genInfo.m_quantizeIntermediateFeatures;
+  options.m_compress = m_genInfo.m_compressIntermediateFeatures;
+  return options;
+}
+
 bool RawGenerator::GenerateFilteredFeatures()
 {
   SourceReader reader =
@@ -235,16 +265,20 @@ bool RawGenerator::GenerateFilteredFeatures()
   switch (m_genInfo.m_osmFileType)
   {
   case feature::GenerateInfo::OsmSourceType::O5M:
-    sourceProcessor = std::make_unique<ProcessorOsmElementsFromO5M>(reader);
+    sourceProcessor = std::make_unique<ProcessorOsmElementsFromO5M>(reader, m_threadsCount);
     break;
   case feature::GenerateInfo::OsmSourceType::XML:
     sourceProcessor = std::make_unique<ProcessorOsmElementsFromXml>(reader);
     break;
+  case feature::GenerateInfo::OsmSourceType::PBF:
+    sourceProcessor = std::make_unique<ProcessorOsmElementsFromPbf>(reader, m_threadsCount);
+    break;
   }
   CHECK(sourceProcessor, ());
 
   TranslatorsPool translators(m_translators, m_threadsCount);
-  RawGeneratorWriter rawGeneratorWriter(m_queue, m_genInfo.m_tmpDir);
+  RawGeneratorWriter rawGeneratorWriter(m_queue, m_genInfo.m_tmpDir, GetFeaturesBlockOptions(),
+                                        m_threadsCount);
   rawGeneratorWriter.Run();
 
   Stats stats(100 * m_threadsCount /* logCallCountThreshold */);
@@ -2,15 +2,16 @@
 
 #include "generator/affiliation.hpp"
 #include "generator/composite_id.hpp"
+#include "generator/feature_builder.hpp"
 #include "generator/features_processing_helpers.hpp"
 #include "generator/final_processor_interface.hpp"
+#include "generator/final_processor_scheduler.hpp"
 #include "generator/generate_info.hpp"
 #include "generator/intermediate_data.hpp"
 #include "generator/translator_collection.hpp"
 #include "generator/translator_interface.hpp"
 
 #include <memory>
-#include <queue>
 #include <string>
 #include <vector>
 
@@ -35,18 +36,16 @@ public:
   void ForceReloadCache();
 
 private:
-  using FinalProcessorPtr = std::shared_ptr<FinalProcessorIntermediateMwmInterface>;
-
-  struct FinalProcessorPtrCmp
-  {
-    bool operator()(FinalProcessorPtr const & l, FinalProcessorPtr const & r) { return *l < *r; }
-  };
+  using FinalProcessorPtr = FinalProcessorScheduler::FinalProcessorPtr;
 
+  // Adds the processors of the Generate* calls to the scheduler with their dependencies.
+  void AddFinalProcessors();
   FinalProcessorPtr CreateCoslineFinalProcessor();
   FinalProcessorPtr CreateCountryFinalProcessor(AffiliationInterfacePtr const & affiliations, bool needMixNodes);
   FinalProcessorPtr CreateWorldFinalProcessor(bool cutBordersByWater);
   FinalProcessorPtr CreatePlacesFinalProcessor(AffiliationInterfacePtr const & affiliations);
 
+  feature::FeaturesBlockOptions GetFeaturesBlockOptions() const;
   bool GenerateFilteredFeatures();
 
   feature::GenerateInfo & m_genInfo;
@@ -56,8 +55,11 @@ private:
   std::shared_ptr<cache::IntermediateData> m_cache;
   std::shared_ptr<FeatureProcessorQueue> m_queue;
   std::shared_ptr<TranslatorCollection> m_translators;
-  std::priority_queue<FinalProcessorPtr, std::vector<FinalProcessorPtr>, FinalProcessorPtrCmp>
-      m_finalProcessors;
+  FinalProcessorPtr m_countryFinalProcessor;
+  FinalProcessorPtr m_placesFinalProcessor;
+  FinalProcessorPtr m_worldFinalProcessor;
+  FinalProcessorPtr m_coastlineFinalProcessor;
+  FinalProcessorScheduler m_finalProcessors;
   std::vector<std::string> m_names;
   //std::unordered_set<CompositeId> m_hierarchyNodesSet;
 };
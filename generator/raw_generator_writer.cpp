@@ -1,17 +1,29 @@
 #include "generator/raw_generator_writer.hpp"
 
+#include "coding/byte_stream.hpp"
 #include "coding/varint.hpp"
 
 #include "base/file_name_utils.hpp"
 
 #include <iterator>
+#include <utility>
 
 namespace generator
 {
+namespace
+{
+// Encoded blocks of a country which wait to be written.
+size_t constexpr kMaxPendingBlocks = 2;
+}  // namespace
+
 RawGeneratorWriter::RawGeneratorWriter(std::shared_ptr<FeatureProcessorQueue> const & queue,
-                                       std::string const & path)
-  : m_queue(queue), m_path(path)
+                                       std::string const & path,
+                                       feature::FeaturesBlockOptions const & blockOptions,
+                                       size_t threadsCount)
+  : m_queue(queue), m_path(path), m_blockOptions(blockOptions)
 {
+  if (m_blockOptions.IsEnabled())
+    m_pool = std::make_unique<base::ComputationalThreadPool>(threadsCount);
 }
 
 RawGeneratorWriter::~RawGeneratorWriter() { ShutdownAndJoin(); }
@@ -26,7 +38,10 @@ void RawGeneratorWriter::Run()
       // As a sign of the end of tasks, we use an empty message. We have the right to do that,
       // because there is only one reader.
       if (!chunk.has_value())
+      {
+        FlushBlocks();
         return;
+      }
 
       Write(*chunk);
     }
@@ -65,10 +80,54 @@ void RawGeneratorWriter::Write(std::vector<ProcessedData> const & vecChunks)
 
       auto & writer = writerIt->second;
       auto const & buffer = chunk.m_buffer;
-      WriteVarUint(*writer, static_cast<uint32_t>(buffer.size()));
-      writer->Write(buffer.data(), buffer.size());
+      if (!m_blockOptions.IsEnabled())
+      {
+        WriteVarUint(*writer, static_cast<uint32_t>(buffer.size()));
+        writer->Write(buffer.data(), buffer.size());
+        continue;
+      }
+
+      auto & blocks = m_blocks[affiliation];
+      PushBackByteSink<feature::FeatureBuilder::Buffer> sink(blocks.m_records);
+      WriteVarUint(sink, static_cast<uint32_t>(buffer.size()));
+      sink.Write(buffer.data(), buffer.size());
+      if (blocks.m_records.size() >= feature::FeaturesBlockWriter::kBlockSize)
+        SubmitBlock(*writer, blocks);
+    }
+  }
+}
+
+void RawGeneratorWriter::SubmitBlock(FileWriter & writer, Blocks & blocks)
+{
+  blocks.m_pendingBlocks.push(
+      m_pool->Submit([records = std::move(blocks.m_records), options = m_blockOptions]() {
+        return feature::MakeFeaturesBlock(records, options);
+      }));
+  blocks.m_records.clear();
+
+  while (blocks.m_pendingBlocks.size() > kMaxPendingBlocks)
+  {
+    auto const block = blocks.m_pendingBlocks.front().get();
+    writer.Write(block.data(), block.size());
+    blocks.m_pendingBlocks.pop();
+  }
+}
+
+void RawGeneratorWriter::FlushBlocks()
+{
+  for (auto & [affiliation, blocks] : m_blocks)
+  {
+    auto & writer = *m_writers.at(affiliation);
+    if (!blocks.m_records.empty())
+      SubmitBlock(writer, blocks);
+
+    for (; !blocks.m_pendingBlocks.empty(); blocks.m_pendingBlocks.pop())
+    {
+      auto const block = blocks.m_pendingBlocks.front().get();
+      writer.Write(block.data(), block.size());
     }
   }
+  m_blocks.clear();
 }
 
 void RawGeneratorWriter::ShutdownAndJoin()
@@ -3,7 +3,12 @@
 #include "generator/feature_builder.hpp"
 #include "generator/features_processing_helpers.hpp"
 
+#include "base/thread_pool_computational.hpp"
+
+#include <cstddef>
+#include <future>
 #include <memory>
+#include <queue>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -14,8 +19,12 @@ namespace generator
 class RawGeneratorWriter
 {
 public:
+  // Features are written as blocks if |blockOptions| are enabled, the blocks are encoded on
+  // |threadsCount| threads.
   RawGeneratorWriter(std::shared_ptr<FeatureProcessorQueue> const & queue,
-                     std::string const & path);
+                     std::string const & path,
+                     feature::FeaturesBlockOptions const & blockOptions = {},
+                     size_t threadsCount = 1);
   ~RawGeneratorWriter();
 
   void Run();
@@ -26,11 +35,23 @@ private:
   using FeatureBuilderWriter =
       feature::FeatureBuilderWriter<feature::serialization_policy::MaxAccuracy>;
 
+  struct Blocks
+  {
+    // Features of the current block.
+    feature::FeatureBuilder::Buffer m_records;
+    std::queue<std::future<feature::FeatureBuilder::Buffer>> m_pendingBlocks;
+  };
+
   void Write(std::vector<ProcessedData> const & vecChanks);
+  void SubmitBlock(FileWriter & writer, Blocks & blocks);
+  void FlushBlocks();
 
   std::thread m_thread;
   std::shared_ptr<FeatureProcessorQueue> m_queue;
   std::string m_path;
   std::unordered_map<std::string, std::unique_ptr<FileWriter>> m_writers;
+  feature::FeaturesBlockOptions m_blockOptions;
+  std::unordered_map<std::string, Blocks> m_blocks;
+  std::unique_ptr<base::ComputationalThreadPool> m_pool;
 };
 }  // namespace generator
@@ -21,6 +21,7 @@
 #include "indexer/scales_patch.hpp"
 #include "indexer/search_string_utils.hpp"
 #include "indexer/trie_builder.hpp"
+#include "indexer/types_postings.hpp"
 
 #include "platform/platform.hpp"
 
@@ -122,24 +123,22 @@ void GetCategoryTypes(CategoriesHolder const & categories, std::pair<int, int> s
   }
 }
 
+using NameTokensStats = base::TopStatsCounter<std::string>;
+
 template <class ContT>
 class FeatureNameInserter
 {
   String2StringMap const & m_suffixes;
 
-  base::TopStatsCounter<std::string> m_stats;
+  NameTokensStats & m_stats;
 
 public:
-  explicit FeatureNameInserter(ContT & keyValuePairs)
+  FeatureNameInserter(ContT & keyValuePairs, NameTokensStats & stats)
     : m_suffixes(GetDACHStreets())
+    , m_stats(stats)
     , m_keyValuePairs(keyValuePairs)
   {
   }
-  ~FeatureNameInserter()
-  {
-    LOG(LINFO, ("Top street's name tokens:"));
-    m_stats.PrintTop(10);
-  }
 
   void SetFeature(uint32_t index, SynonymsHolder const * synonyms, bool hasStreetType)
   {
@@ -285,12 +284,12 @@ template <class ContT>
 class FeatureInserter
 {
 public:
-  FeatureInserter(SynonymsHolder * synonyms, ContT & keyValuePairs,
+  FeatureInserter(SynonymsHolder * synonyms, ContT & keyValuePairs, NameTokensStats & stats,
                   CategoriesHolder const & catHolder, std::pair<int, int> const & scales)
     : m_synonyms(synonyms)
     , m_categories(catHolder)
     , m_scales(scales)
-    , m_inserter(keyValuePairs)
+    , m_inserter(keyValuePairs, stats)
   {
   }
 
@@ -390,7 +389,101 @@ void AddFeatureNameIndexPairs(FeaturesVectorTest const & features,
   if (header.GetType() == feature::DataHeader::MapType::World)
     synonyms = std::make_unique<SynonymsHolder>();
 
-  features.GetVector().ForEach(FeatureInserter(synonyms.get(), keyValuePairs, categoriesHolder, header.GetScaleRange()));
+  NameTokensStats stats;
+  features.GetVector().ForEach(FeatureInserter(synonyms.get(), keyValuePairs, stats, categoriesHolder,
+                                               header.GetScaleRange()));
+
+  LOG(LINFO, ("Top street's name tokens:"));
+  stats.PrintTop(10);
+}
+
+// Collects the pairs of |threadsCount| feature ranges in parallel, each range is read from its own
+// opening of the file and its pairs are sorted on the same thread. The sorted ranges are merged,
+// so |keyValuePairs| are exactly the same as the sorted pairs of AddFeatureNameIndexPairs().
+template <class ContT>
+void AddSortedFeatureNameIndexPairs(FilesContainerR const & container,
+                                    CategoriesHolder const & categoriesHolder,
+                                    uint32_t threadsCount, ContT & keyValuePairs)
+{
+  CHECK(keyValuePairs.empty(), ());
+
+  feature::DataHeader const header(container);
+  std::unique_ptr<SynonymsHolder> synonyms;
+  if (header.GetType() == feature::DataHeader::MapType::World)
+    synonyms = std::make_unique<SynonymsHolder>();
+
+  uint32_t featuresCount = 0;
+  {
+    FeaturesVectorTest features(container);
+    featuresCount = base::checked_cast<uint32_t>(features.GetVector().GetNumFeatures());
+  }
+
+  std::vector<ContT> threadsPairs(threadsCount);
+  std::vector<NameTokensStats> threadsStats(threadsCount);
+
+  // Thread working function.
+  auto const fn = [&](uint32_t threadIdx)
+  {
+    auto const fc = static_cast<uint64_t>(featuresCount);
+    auto const beg = static_cast<uint32_t>(fc * threadIdx / threadsCount);
+    auto const end = static_cast<uint32_t>(fc * (threadIdx + 1) / threadsCount);
+
+    auto & pairs = threadsPairs[threadIdx];
+    // The readers of |container| aren't thread-safe, so each thread opens the file itself.
+    FeaturesVectorTest features(container.GetFileName());
+    FeatureInserter inserter(synonyms.get(), pairs, threadsStats[threadIdx], categoriesHolder,
+                             header.GetScaleRange());
+
+    FeatureType ft;
+    for (uint32_t i = beg; i < end; ++i)
+    {
+      features.GetVector().GetByIndex(i, ft);
+      // The same id as FeaturesVector::ForEach() sets, it's used for the metadata loading.
+      ft.SetID(FeatureID(MwmSet::MwmId(), i));
+      inserter(ft, i);
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+  };
+
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < threadsCount; ++i)
+    threads.emplace_back(fn, i);
+
+  // Wait for thread's finish.
+  for (auto & t : threads)
+    t.join();
+
+  NameTokensStats stats;
+  for (auto const & threadStats : threadsStats)
+    stats.Merge(threadStats);
+  LOG(LINFO, ("Top street's name tokens:"));
+  stats.PrintTop(10);
+
+  // Merge the sorted ranges pairwise, |bounds| are the ends of the ranges.
+  std::vector<size_t> bounds = {0};
+  for (auto & pairs : threadsPairs)
+  {
+    keyValuePairs.insert(keyValuePairs.end(), std::make_move_iterator(pairs.begin()),
+                         std::make_move_iterator(pairs.end()));
+    ContT().swap(pairs);
+    bounds.push_back(keyValuePairs.size());
+  }
+
+  while (bounds.size() > 2)
+  {
+    std::vector<size_t> merged = {0};
+    for (size_t i = 2; i < bounds.size(); i += 2)
+    {
+      std::inplace_merge(keyValuePairs.begin() + bounds[i - 2], keyValuePairs.begin() + bounds[i - 1],
+                         keyValuePairs.begin() + bounds[i]);
+      merged.push_back(bounds[i]);
+    }
+    // The last range has no pair.
+    if (bounds.size() % 2 == 0)
+      merged.push_back(bounds.back());
+    bounds = std::move(merged);
+  }
 }
 
 void ReadAddressData(std::string const & filename, std::vector<feature::AddressData> & addrs)
@@ -458,7 +551,8 @@ std::optional<uint32_t> MatchObjectByName(std::string_view keyName, std::vector<
 }
 
 void BuildAddressTable(FilesContainerR & container, std::string const & addressDataFile,
-                       Writer & streetsWriter, Writer & placesWriter, uint32_t threadsCount)
+                       Writer & streetsWriter, Writer & placesWriter, Writer & street2housesWriter,
+                       uint32_t threadsCount)
 {
   std::vector<feature::AddressData> addrs;
   ReadAddressData(addressDataFile, addrs);
@@ -579,6 +673,16 @@ void BuildAddressTable(FilesContainerR & container, std::string const & addressD
   };
 
   LOG(LINFO, ("Saved streets entries number:", flushToWriter(streets, streetsWriter)));
+
+  {
+    search::StreetToHousesTableBuilder builder;
+    for (size_t i = 0; i < streets.size(); ++i)
+    {
+      if (streets[i] != kInvalidFeatureId)
+        builder.Put(base::asserted_cast<uint32_t>(i), streets[i]);
+    }
+    builder.Freeze(street2housesWriter);
+  }
   LOG(LINFO, ("Saved places entries number:", flushToWriter(places, placesWriter)));
 
   double matchedPercent = 100;
@@ -589,7 +693,8 @@ void BuildAddressTable(FilesContainerR & container, std::string const & addressD
 }  // namespace
 
 
-void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter);
+void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter, Writer & postingsWriter,
+                      uint32_t threadsCount);
 
 bool BuildSearchIndexFromDataFile(std::string const & country, feature::GenerateInfo const & info,
                                   bool forceRebuild, uint32_t threadsCount)
@@ -602,27 +707,35 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
     return true;
 
   auto const indexFilePath = filename + "." + SEARCH_INDEX_FILE_TAG EXTENSION_TMP;
+  auto const postingsFilePath = filename + "." + TYPES_POSTINGS_FILE_TAG EXTENSION_TMP;
   auto const streetsFilePath = filename + "." + FEATURE2STREET_FILE_TAG EXTENSION_TMP;
   auto const placesFilePath = filename + "." + FEATURE2PLACE_FILE_TAG EXTENSION_TMP;
+  auto const street2housesFilePath = filename + "." + STREET2FEATURE_FILE_TAG EXTENSION_TMP;
   SCOPE_GUARD(indexFileGuard, std::bind(&FileWriter::DeleteFileX, indexFilePath));
+  SCOPE_GUARD(postingsFileGuard, std::bind(&FileWriter::DeleteFileX, postingsFilePath));
   SCOPE_GUARD(streetsFileGuard, std::bind(&FileWriter::DeleteFileX, streetsFilePath));
   SCOPE_GUARD(placesFileGuard, std::bind(&FileWriter::DeleteFileX, placesFilePath));
+  SCOPE_GUARD(street2housesFileGuard, std::bind(&FileWriter::DeleteFileX, street2housesFilePath));
 
   try
   {
     {
       FileWriter writer(indexFilePath);
-      BuildSearchIndex(readContainer, writer);
-      LOG(LINFO, ("Search index size =", writer.Size()));
+      FileWriter postingsWriter(postingsFilePath);
+      BuildSearchIndex(readContainer, writer, postingsWriter, threadsCount);
+      LOG(LINFO, ("Search index size =", writer.Size(), "; Types postings size =", postingsWriter.Size()));
     }
 
     if (filename != WORLD_FILE_NAME && filename != WORLD_COASTS_FILE_NAME)
     {
       FileWriter streetsWriter(streetsFilePath);
       FileWriter placesWriter(placesFilePath);
+      FileWriter street2housesWriter(street2housesFilePath);
       auto const addrsFile = info.GetIntermediateFileName(country + DATA_FILE_EXTENSION, TEMP_ADDR_EXTENSION);
-      BuildAddressTable(readContainer, addrsFile, streetsWriter, placesWriter, threadsCount);
-      LOG(LINFO, ("Streets table size:", streetsWriter.Size(), "; Places table size:", placesWriter.Size()));
+      BuildAddressTable(readContainer, addrsFile, streetsWriter, placesWriter, street2housesWriter,
+                        threadsCount);
+      LOG(LINFO, ("Streets table size:", streetsWriter.Size(), "; Places table size:", placesWriter.Size(),
+                  "; Street to houses table size:", street2housesWriter.Size()));
     }
 
     // Separate scopes because FilesContainerW can't write two sections at once.
@@ -658,6 +771,14 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
       FilesContainerW writeContainer(readContainer.GetFileName(), FileWriter::OP_WRITE_EXISTING);
       writeContainer.Write(placesFilePath, FEATURE2PLACE_FILE_TAG);
     }
+    {
+      FilesContainerW writeContainer(readContainer.GetFileName(), FileWriter::OP_WRITE_EXISTING);
+      writeContainer.Write(street2housesFilePath, STREET2FEATURE_FILE_TAG);
+    }
+    {
+      FilesContainerW writeContainer(readContainer.GetFileName(), FileWriter::OP_WRITE_EXISTING);
+      writeContainer.Write(postingsFilePath, TYPES_POSTINGS_FILE_TAG);
+    }
   }
   catch (Reader::Exception const & e)
   {
@@ -673,7 +794,8 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
   return true;
 }
 
-void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter)
+void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter, Writer & postingsWriter,
+                      uint32_t threadsCount)
 {
   using Key = strings::UniString;
   using Value = Uint64IndexValue;
@@ -683,18 +805,46 @@ void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter)
 
   auto const & categoriesHolder = GetDefaultCategories();
 
-  FeaturesVectorTest features(container);
   SingleValueSerializer<Value> serializer;
 
   std::vector<std::pair<Key, Value>> searchIndexKeyValuePairs;
-  AddFeatureNameIndexPairs(features, categoriesHolder, searchIndexKeyValuePairs);
-
-  std::sort(searchIndexKeyValuePairs.begin(), searchIndexKeyValuePairs.end());
+  if (threadsCount > 1)
+  {
+    AddSortedFeatureNameIndexPairs(container, categoriesHolder, threadsCount,
+                                   searchIndexKeyValuePairs);
+  }
+  else
+  {
+    FeaturesVectorTest features(container);
+    AddFeatureNameIndexPairs(features, categoriesHolder, searchIndexKeyValuePairs);
+    std::sort(searchIndexKeyValuePairs.begin(), searchIndexKeyValuePairs.end());
+  }
   LOG(LINFO, ("End sorting strings:", timer.ElapsedSeconds()));
 
   trie::Build<Writer, Key, ValueList<Value>, SingleValueSerializer<Value>>(
       indexWriter, serializer, searchIndexKeyValuePairs);
 
   LOG(LINFO, ("End building search index, elapsed seconds:", timer.ElapsedSeconds()));
+
+  // Categories branch keys are |kCategoriesLang| + "!type:<type index>".
+  /// @see search::FeatureTypeToString.
+  std::string_view constexpr typePrefix = "!type:";
+
+  search::TypesPostingsBuilder postingsBuilder;
+  for (auto const & [key, value] : searchIndexKeyValuePairs)
+  {
+    if (key.empty() || key[0] != search::kCategoriesLang)
+      continue;
+
+    auto const s = strings::ToUtf8(Key(key.begin() + 1, key.end()));
+    uint32_t typeIndex;
+    if (!s.starts_with(typePrefix) || !strings::to_uint(s.substr(typePrefix.size()), typeIndex))
+      continue;
+
+    postingsBuilder.Put(typeIndex, base::asserted_cast<uint32_t>(value.m_featureId));
+  }
+  postingsBuilder.Freeze(postingsWriter);
+
+  LOG(LINFO, ("End building types postings, elapsed seconds:", timer.ElapsedSeconds()));
 }
 }  // namespace indexer
@@ -3,13 +3,18 @@
 #include "platform/platform.hpp"
 
 #include "coding/endianness.hpp"
+#include "coding/mmap_reader.hpp"
 #include "coding/zip_reader.hpp"
 
 #include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
+#include "base/thread_pool_computational.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iomanip>
+#include <numeric>
 #include <sstream>
 
 namespace generator
@@ -42,6 +47,20 @@ std::string GetSrtmContFileName(std::string const & dir, std::string const & bas
 {
   return base::JoinPath(dir, base + ".SRTMGL1.hgt.zip");
 }
+
+// Returns the fractional row and column of |coord| in its tile.
+std::pair<double, double> GetSamplePosition(ms::LatLon const & coord)
+{
+  double ln = coord.m_lon - static_cast<int>(coord.m_lon);
+  if (ln < 0)
+    ln += 1;
+  double lt = coord.m_lat - static_cast<int>(coord.m_lat);
+  if (lt < 0)
+    lt += 1;
+  lt = 1 - lt;  // from North to South
+
+  return {kArcSecondsInDegree * lt, kArcSecondsInDegree * ln};
+}
 }  // namespace
 
 // SrtmTile ----------------------------------------------------------------------------------------
@@ -50,11 +69,14 @@ SrtmTile::SrtmTile()
   Invalidate();
 }
 
-SrtmTile::SrtmTile(SrtmTile && rhs) : m_data(std::move(rhs.m_data)), m_valid(rhs.m_valid)
+SrtmTile::SrtmTile(SrtmTile && rhs)
+  : m_data(std::move(rhs.m_data)), m_mmap(std::move(rhs.m_mmap)), m_valid(rhs.m_valid)
 {
   rhs.Invalidate();
 }
 
+SrtmTile::~SrtmTile() = default;
+
 void SrtmTile::Init(std::string const & dir, ms::LatLon const & coord)
 {
   Invalidate();
@@ -90,12 +112,13 @@ void SrtmTile::Init(std::string const & dir, ms::LatLon const & coord)
   }
   else
   {
-    GetPlatform().GetReader(file)->ReadAsString(m_data);
+    m_mmap = std::make_unique<MmapReader>(GetPlatform().ReadPathForFile(file),
+                                          MmapReader::Advice::Random);
   }
 
-  if (m_data.size() != kSrtmTileSize)
+  if (Size() * sizeof(geometry::Altitude) != kSrtmTileSize)
   {
-    LOG(LWARNING, ("Bad decompressed SRTM file size:", cont, m_data.size()));
+    LOG(LWARNING, ("Bad decompressed SRTM file size:", cont, Size() * sizeof(geometry::Altitude)));
     Invalidate();
     return;
   }
@@ -108,21 +131,35 @@ geometry::Altitude SrtmTile::GetHeight(ms::LatLon const & coord) const
   if (!IsValid())
     return geometry::kInvalidAltitude;
 
-  double ln = coord.m_lon - static_cast<int>(coord.m_lon);
-  if (ln < 0)
-    ln += 1;
-  double lt = coord.m_lat - static_cast<int>(coord.m_lat);
-  if (lt < 0)
-    lt += 1;
-  lt = 1 - lt;  // from North to South
+  auto const [row, col] = GetSamplePosition(coord);
+  return GetSample(static_cast<size_t>(std::round(row)), static_cast<size_t>(std::round(col)));
+}
 
-  auto const row = static_cast<size_t>(std::round(kArcSecondsInDegree * lt));
-  auto const col = static_cast<size_t>(std::round(kArcSecondsInDegree * ln));
+geometry::Altitude SrtmTile::GetBilinearHeight(ms::LatLon const & coord) const
+{
+  if (!IsValid())
+    return geometry::kInvalidAltitude;
 
-  size_t const ix = row * (kArcSecondsInDegree + 1) + col;
+  auto const [row, col] = GetSamplePosition(coord);
+  auto const row0 = static_cast<size_t>(row);
+  auto const col0 = static_cast<size_t>(col);
+  auto const row1 = std::min(row0 + 1, kArcSecondsInDegree);
+  auto const col1 = std::min(col0 + 1, kArcSecondsInDegree);
+
+  geometry::Altitude const h00 = GetSample(row0, col0);
+  geometry::Altitude const h01 = GetSample(row0, col1);
+  geometry::Altitude const h10 = GetSample(row1, col0);
+  geometry::Altitude const h11 = GetSample(row1, col1);
+  for (auto const h : {h00, h01, h10, h11})
+  {
+    if (h == geometry::kInvalidAltitude)
+      return GetHeight(coord);
+  }
 
-  CHECK_LESS(ix, Size(), (coord));
-  return ReverseByteOrder(Data()[ix]);
+  double const dr = row - row0;
+  double const dc = col - col0;
+  double const h = (1 - dr) * ((1 - dc) * h00 + dc * h01) + dr * ((1 - dc) * h10 + dc * h11);
+  return static_cast<geometry::Altitude>(std::lround(h));
 }
 
 // static
@@ -168,55 +205,160 @@ std::string SrtmTile::GetBase(ms::LatLon const & coord)
   return ss.str();
 }
 
+geometry::Altitude const * SrtmTile::Data() const
+{
+  if (m_mmap)
+    return reinterpret_cast<geometry::Altitude const *>(m_mmap->Data());
+  return reinterpret_cast<geometry::Altitude const *>(m_data.data());
+}
+
+size_t SrtmTile::Size() const
+{
+  auto const size = m_mmap ? static_cast<size_t>(m_mmap->Size()) : m_data.size();
+  return size / sizeof(geometry::Altitude);
+}
+
+geometry::Altitude SrtmTile::GetSample(size_t row, size_t col) const
+{
+  size_t const ix = row * (kArcSecondsInDegree + 1) + col;
+  CHECK_LESS(ix, Size(), (row, col));
+  return ReverseByteOrder(Data()[ix]);
+}
+
 void SrtmTile::Invalidate()
 {
   m_data.clear();
   m_data.shrink_to_fit();
+  m_mmap.reset();
   m_valid = false;
 }
 
 // SrtmTileManager ---------------------------------------------------------------------------------
-SrtmTileManager::SrtmTileManager(std::string const & dir) : m_dir(dir) {}
+SrtmTileManager::SrtmTileManager(std::string const & dir, uint64_t maxCacheBytes)
+  : m_dir(dir), m_maxCacheBytes(maxCacheBytes)
+{
+}
+
 geometry::Altitude SrtmTileManager::GetHeight(ms::LatLon const & coord)
 {
-  auto const key = GetKey(coord);
+  return GetTile(coord)->GetHeight(coord);
+}
 
-  auto it = m_tiles.find(key);
-  if (it == m_tiles.end())
+void SrtmTileManager::GetHeights(std::vector<ms::LatLon> const & coords,
+                                 std::vector<geometry::Altitude> & heights, size_t threadsCount)
+{
+  heights.assign(coords.size(), geometry::kInvalidAltitude);
+
+  std::vector<LatLonKey> keys;
+  keys.reserve(coords.size());
+  for (auto const & coord : coords)
+    keys.push_back(GetKey(coord));
+
+  std::vector<size_t> order(coords.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&keys](size_t lhs, size_t rhs) {
+    return keys[lhs] < keys[rhs];
+  });
+
+  // Every task fills the heights of the coords of one tile.
+  auto const processTile = [&](size_t beg, size_t end) {
+    auto const tile = GetTile(coords[order[beg]]);
+    for (size_t i = beg; i < end; ++i)
+      heights[order[i]] = tile->GetBilinearHeight(coords[order[i]]);
+  };
+
+  std::vector<std::pair<size_t, size_t>> ranges;
+  for (size_t beg = 0, end = 0; beg < order.size(); beg = end)
   {
-    SrtmTile tile;
-    try
-    {
-      tile.Init(m_dir, coord);
-    }
-    catch (RootException const & e)
+    end = beg + 1;
+    while (end < order.size() && keys[order[end]] == keys[order[beg]])
+      ++end;
+    ranges.emplace_back(beg, end);
+  }
+
+  if (threadsCount <= 1 || ranges.size() <= 1)
+  {
+    for (auto const & [beg, end] : ranges)
+      processTile(beg, end);
+    return;
+  }
+
+  base::ComputationalThreadPool pool(std::min(threadsCount, ranges.size()));
+  std::vector<std::future<void>> results;
+  results.reserve(ranges.size());
+  for (auto const & [beg, end] : ranges)
+    results.emplace_back(pool.Submit(processTile, beg, end));
+  for (auto & result : results)
+    result.get();
+}
+
+std::shared_ptr<SrtmTile const> SrtmTileManager::GetTile(ms::LatLon const & coord)
+{
+  auto const key = GetKey(coord);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto const it = m_tiles.find(key);
+    if (it != m_tiles.end())
     {
-      std::string const base = SrtmTile::GetBase(coord);
-      LOG(LINFO, ("Can't init SRTM tile:", base, "reason:", e.Msg()));
+      m_lru.splice(m_lru.begin(), m_lru, it->second);
+      return it->second->m_tile;
     }
+  }
+
+  // The tile is loaded without the lock, so the threads load different tiles simultaneously.
+  auto tile = std::make_shared<SrtmTile>();
+  try
+  {
+    tile->Init(m_dir, coord);
+  }
+  catch (RootException const & e)
+  {
+    std::string const base = SrtmTile::GetBase(coord);
+    LOG(LINFO, ("Can't init SRTM tile:", base, "reason:", e.Msg()));
+  }
 
-    // It's OK to store even invalid tiles and return invalid height
-    // for them later.
-    it = m_tiles.emplace(key, std::move(tile)).first;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto const it = m_tiles.find(key);
+  if (it != m_tiles.end())
+  {
+    // Another thread has already loaded the tile.
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->m_tile;
   }
 
-  return it->second.GetHeight(coord);
+  // It's OK to store even invalid tiles and return invalid height
+  // for them later.
+  m_cacheBytes += tile->GetMemorySize();
+  m_lru.push_front({key, tile});
+  m_tiles.emplace(key, m_lru.begin());
+  Shrink();
+  return tile;
+}
+
+size_t SrtmTileManager::GetTilesCount() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_lru.size();
 }
 
 // static
 SrtmTileManager::LatLonKey SrtmTileManager::GetKey(ms::LatLon const & coord)
 {
-  auto const tileCenter = SrtmTile::GetCenter(coord);
-  return {static_cast<int32_t>(tileCenter.m_lat), static_cast<int32_t>(tileCenter.m_lon)};
+  // The south-west corner of the tile. Truncating the center would merge the tiles around
+  // the equator and the prime meridian.
+  return {static_cast<int32_t>(std::floor(coord.m_lat)),
+          static_cast<int32_t>(std::floor(coord.m_lon))};
 }
 
-SrtmTile const & SrtmTileManager::GetTile(ms::LatLon const & coord)
+void SrtmTileManager::Shrink()
 {
-  // Touch the tile to force its loading.
-  GetHeight(coord);
-  auto const key = GetKey(coord);
-  auto const it = m_tiles.find(key);
-  CHECK(it != m_tiles.end(), (coord));
-  return it->second;
+  // The most recent tile is kept even if it alone exceeds the limit.
+  while (m_cacheBytes > m_maxCacheBytes && m_lru.size() > 1)
+  {
+    auto const & lru = m_lru.back();
+    m_cacheBytes -= lru.m_tile->GetMemorySize();
+    m_tiles.erase(lru.m_key);
+    m_lru.pop_back();
+  }
 }
 }  // namespace generator
@@ -8,9 +8,17 @@
 
 #include "base/macros.hpp"
 
+#include <cstddef>
 #include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+class MmapReader;
 
 namespace generator
 {
@@ -19,47 +27,65 @@ class SrtmTile
 public:
   SrtmTile();
   SrtmTile(SrtmTile && rhs);
+  ~SrtmTile();
 
   void Init(std::string const & dir, ms::LatLon const & coord);
 
   inline bool IsValid() const { return m_valid; }
   // Returns height in meters at |coord| or kInvalidAltitude.
   geometry::Altitude GetHeight(ms::LatLon const & coord) const;
+  // Returns height in meters at |coord| interpolated between the four nearest samples,
+  // the height of the nearest sample if any of them is a void, or kInvalidAltitude.
+  geometry::Altitude GetBilinearHeight(ms::LatLon const & coord) const;
+
+  // Returns the size of the heights in memory, decompressed or mapped.
+  size_t GetMemorySize() const { return Size() * sizeof(geometry::Altitude); }
 
   static std::string GetBase(ms::LatLon const & coord);
   static ms::LatLon GetCenter(ms::LatLon const & coord);
   static std::string GetPath(std::string const & dir, std::string const & base);
 
 private:
-  inline geometry::Altitude const * Data() const
-  {
-    return reinterpret_cast<geometry::Altitude const *>(m_data.data());
-  };
-
-  inline size_t Size() const { return m_data.size() / sizeof(geometry::Altitude); }
+  geometry::Altitude const * Data() const;
+  size_t Size() const;
+  geometry::Altitude GetSample(size_t row, size_t col) const;
   void Invalidate();
 
+  // Zipped tiles are decompressed to |m_data|, uncompressed ones are mapped to memory.
   std::string m_data;
+  std::unique_ptr<MmapReader> m_mmap;
   bool m_valid;
 
   DISALLOW_COPY(SrtmTile);
 };
 
+// Cache of the SRTM tiles which is safe to use from several threads. When the tiles take more
+// memory than the limit, the least recently used ones are evicted.
 class SrtmTileManager
 {
 public:
-  explicit SrtmTileManager(std::string const & dir);
+  static uint64_t constexpr kDefaultMaxCacheBytes = uint64_t{2} << 30;
+
+  explicit SrtmTileManager(std::string const & dir,
+                           uint64_t maxCacheBytes = kDefaultMaxCacheBytes);
 
   geometry::Altitude GetHeight(ms::LatLon const & coord);
 
-  SrtmTile const & GetTile(ms::LatLon const & coord);
+  // Fills |heights| with SrtmTile::GetBilinearHeight() at |coords|. The coords are grouped
+  // by tiles, so every tile is looked up once, and the tiles are processed on |threadsCount|
+  // threads.
+  void GetHeights(std::vector<ms::LatLon> const & coords, std::vector<geometry::Altitude> & heights,
+                  size_t threadsCount = 1);
+
+  // The tile is kept alive while it is referenced, even if it is evicted from the cache.
+  std::shared_ptr<SrtmTile const> GetTile(ms::LatLon const & coord);
+
+  size_t GetTilesCount() const;
 
 private:
   using LatLonKey = std::pair<int32_t, int32_t>;
   static LatLonKey GetKey(ms::LatLon const & coord);
 
-  std::string m_dir;
-
   struct Hash
   {
     size_t operator()(LatLonKey const & key) const
@@ -68,7 +94,24 @@ private:
     }
   };
 
-  std::unordered_map<LatLonKey, SrtmTile, Hash> m_tiles;
+  struct Entry
+  {
+    LatLonKey m_key;
+    std::shared_ptr<SrtmTile const> m_tile;
+  };
+
+  // Removes the least recently used tiles until the cache fits into the limit.
+  // Must be called with |m_mutex| locked.
+  void Shrink();
+
+  std::string m_dir;
+  uint64_t const m_maxCacheBytes;
+
+  mutable std::mutex m_mutex;
+  // The most recently used tile is at the front.
+  std::list<Entry> m_lru;
+  std::unordered_map<LatLonKey, std::list<Entry>::iterator, Hash> m_tiles;
+  uint64_t m_cacheBytes = 0;
 
   DISALLOW_COPY(SrtmTileManager);
 };
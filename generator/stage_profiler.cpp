@@ -0,0 +1,350 @@
+#include "generator/stage_profiler.hpp"
+
+#include "generator/collector_collection.hpp"
+#include "generator/filter_collection.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include "std/target_os.hpp"
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <typeinfo>
+#include <vector>
+
+#if !defined(OMIM_OS_WINDOWS)
+#include <sys/resource.h>
+#endif
+
+#include "cppjansson/cppjansson.hpp"
+
+#include <boost/core/demangle.hpp>
+
+namespace generator
+{
+namespace
+{
+double constexpr kBytesInMiB = 1024.0 * 1024.0;
+
+template <typename T>
+std::string GetStageName(T const & stage)
+{
+  return boost::core::demangle(typeid(stage).name());
+}
+
+double GetCpuSeconds() { return static_cast<double>(std::clock()) / CLOCKS_PER_SEC; }
+
+}  // namespace
+
+// StageMetrics ------------------------------------------------------------------------------------
+void StageMetrics::Add(StageMetrics const & other)
+{
+  m_seconds += other.m_seconds;
+  m_elementsCount += other.m_elementsCount;
+}
+
+// StageProfiler -----------------------------------------------------------------------------------
+// static
+StageProfiler & StageProfiler::Instance()
+{
+  static StageProfiler profiler;
+  return profiler;
+}
+
+void StageProfiler::Enable()
+{
+  m_timer.Reset();
+  m_cpuSecondsOnEnable = GetCpuSeconds();
+  m_enabled = true;
+}
+
+void StageProfiler::Add(Kind kind, std::string const & name, StageMetrics const & metrics)
+{
+  if (!m_enabled)
+    return;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_stages[{kind, name}].Add(metrics);
+}
+
+std::string StageProfiler::GetJsonReport() const
+{
+  using Stage = std::pair<std::pair<Kind, std::string>, StageMetrics>;
+  std::vector<Stage> stages;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stages.assign(m_stages.cbegin(), m_stages.cend());
+  }
+
+  // The slowest stages of every kind go first.
+  std::stable_sort(stages.begin(), stages.end(), [](Stage const & lhs, Stage const & rhs) {
+    if (lhs.first.first != rhs.first.first)
+      return lhs.first.first < rhs.first.first;
+    return lhs.second.m_seconds > rhs.second.m_seconds;
+  });
+
+  auto stagesArray = base::NewJSONArray();
+  for (auto const & [key, metrics] : stages)
+  {
+    auto stage = base::NewJSONObject();
+    ToJSONObject(*stage, "kind", DebugPrint(key.first));
+    ToJSONObject(*stage, "name", key.second);
+    ToJSONObject(*stage, "seconds", metrics.m_seconds);
+    ToJSONObject(*stage, "elements", metrics.m_elementsCount);
+    ToJSONArray(*stagesArray, stage);
+  }
+
+  auto root = base::NewJSONObject();
+  ToJSONObject(*root, "wallSeconds", m_timer.ElapsedSeconds());
+  ToJSONObject(*root, "cpuSeconds", GetCpuSeconds() - m_cpuSecondsOnEnable);
+  ToJSONObject(*root, "processPeakMemoryMiB", GetPeakMemoryBytes() / kBytesInMiB);
+  ToJSONObject(*root, "stages", std::move(stagesArray));
+  return base::DumpToString(root, JSON_INDENT(2));
+}
+
+void StageProfiler::SaveJsonReport(std::string const & path) const
+{
+  std::ofstream os(path);
+  if (!os.is_open())
+  {
+    LOG(LERROR, ("Can't open", path, "to save the stages report."));
+    return;
+  }
+
+  os << GetJsonReport() << std::endl;
+  LOG(LINFO, ("Stages report is saved to", path));
+}
+
+// static
+uint64_t StageProfiler::GetPeakMemoryBytes()
+{
+#if defined(OMIM_OS_WINDOWS)
+  return 0;
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#if defined(OMIM_OS_MAC)
+  // Bytes on Mac OS, kilobytes on Linux.
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+std::string DebugPrint(StageProfiler::Kind kind)
+{
+  switch (kind)
+  {
+  case StageProfiler::Kind::Translator: return "translator";
+  case StageProfiler::Kind::Filter: return "filter";
+  case StageProfiler::Kind::Collector: return "collector";
+  case StageProfiler::Kind::FinalProcessor: return "final_processor";
+  }
+  UNREACHABLE();
+}
+
+// SharedStageMetrics ------------------------------------------------------------------------------
+SharedStageMetrics::SharedStageMetrics(StageProfiler::Kind kind, std::string const & name)
+  : m_kind(kind), m_name(name)
+{
+}
+
+SharedStageMetrics::~SharedStageMetrics()
+{
+  StageMetrics metrics;
+  metrics.m_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::duration(m_ticks)).count();
+  metrics.m_elementsCount = m_elementsCount;
+  StageProfiler::Instance().Add(m_kind, m_name, metrics);
+}
+
+void SharedStageMetrics::Add(std::chrono::steady_clock::duration duration, uint64_t elementsCount)
+{
+  m_ticks.fetch_add(duration.count(), std::memory_order_relaxed);
+  m_elementsCount.fetch_add(elementsCount, std::memory_order_relaxed);
+}
+
+// ProfiledTranslator ------------------------------------------------------------------------------
+ProfiledTranslator::ProfiledTranslator(std::shared_ptr<TranslatorInterface> const & translator)
+  : m_translator(translator), m_name(GetStageName(*translator))
+{
+}
+
+ProfiledTranslator::~ProfiledTranslator()
+{
+  StageProfiler::Instance().Add(StageProfiler::Kind::Translator, m_name, m_metrics);
+}
+
+std::shared_ptr<TranslatorInterface> ProfiledTranslator::Clone() const
+{
+  return std::make_shared<ProfiledTranslator>(m_translator->Clone());
+}
+
+void ProfiledTranslator::Emit(OsmElement const & element)
+{
+  StageTimer timer(m_metrics);
+  ++m_metrics.m_elementsCount;
+  m_translator->Emit(element);
+}
+
+void ProfiledTranslator::Finish()
+{
+  StageTimer timer(m_metrics);
+  m_translator->Finish();
+}
+
+bool ProfiledTranslator::Save()
+{
+  StageTimer timer(m_metrics);
+  return m_translator->Save();
+}
+
+void ProfiledTranslator::Merge(TranslatorInterface const & other)
+{
+  StageTimer timer(m_metrics);
+  m_translator->Merge(*dynamic_cast<ProfiledTranslator const &>(other).m_translator);
+}
+
+// ProfiledFilter ----------------------------------------------------------------------------------
+ProfiledFilter::ProfiledFilter(std::shared_ptr<FilterInterface> const & filter)
+  : ProfiledFilter(filter, std::make_shared<SharedStageMetrics>(StageProfiler::Kind::Filter,
+                                                                GetStageName(*filter)))
+{
+}
+
+ProfiledFilter::ProfiledFilter(std::shared_ptr<FilterInterface> const & filter,
+                               std::shared_ptr<SharedStageMetrics> const & metrics)
+  : m_filter(filter), m_metrics(metrics)
+{
+}
+
+std::shared_ptr<FilterInterface> ProfiledFilter::Clone() const
+{
+  return std::make_shared<ProfiledFilter>(m_filter->Clone(), m_metrics);
+}
+
+template <typename Element>
+bool ProfiledFilter::IsAcceptedImpl(Element const & element) const
+{
+  auto const start = std::chrono::steady_clock::now();
+  bool const isAccepted = m_filter->IsAccepted(element);
+  m_metrics->Add(std::chrono::steady_clock::now() - start, 1 /* elementsCount */);
+  return isAccepted;
+}
+
+bool ProfiledFilter::IsAccepted(OsmElement const & element) const
+{
+  return IsAcceptedImpl(element);
+}
+
+bool ProfiledFilter::IsAccepted(feature::FeatureBuilder const & feature) const
+{
+  return IsAcceptedImpl(feature);
+}
+
+// ProfiledCollector -------------------------------------------------------------------------------
+ProfiledCollector::ProfiledCollector(std::shared_ptr<CollectorInterface> const & collector)
+  : m_collector(collector), m_name(GetStageName(*collector))
+{
+}
+
+ProfiledCollector::~ProfiledCollector()
+{
+  StageProfiler::Instance().Add(StageProfiler::Kind::Collector, m_name, m_metrics);
+}
+
+std::shared_ptr<CollectorInterface> ProfiledCollector::Clone(IDRInterfacePtr const & cache) const
+{
+  return std::make_shared<ProfiledCollector>(m_collector->Clone(cache));
+}
+
+void ProfiledCollector::Collect(OsmElement const & element)
+{
+  StageTimer timer(m_metrics);
+  ++m_metrics.m_elementsCount;
+  m_collector->Collect(element);
+}
+
+void ProfiledCollector::CollectRelation(RelationElement const & element)
+{
+  StageTimer timer(m_metrics);
+  ++m_metrics.m_elementsCount;
+  m_collector->CollectRelation(element);
+}
+
+void ProfiledCollector::CollectFeature(feature::FeatureBuilder const & feature,
+                                       OsmElement const & element)
+{
+  StageTimer timer(m_metrics);
+  ++m_metrics.m_elementsCount;
+  m_collector->CollectFeature(feature, element);
+}
+
+void ProfiledCollector::Finish()
+{
+  StageTimer timer(m_metrics);
+  m_collector->Finish();
+}
+
+void ProfiledCollector::Merge(CollectorInterface const & other)
+{
+  StageTimer timer(m_metrics);
+  m_collector->Merge(*dynamic_cast<ProfiledCollector const &>(other).m_collector);
+}
+
+void ProfiledCollector::Save()
+{
+  StageTimer timer(m_metrics);
+  m_collector->Save();
+}
+
+void ProfiledCollector::OrderCollectedData()
+{
+  StageTimer timer(m_metrics);
+  m_collector->OrderCollectedData();
+}
+
+// Functions ---------------------------------------------------------------------------------------
+std::shared_ptr<TranslatorInterface> ProfileTranslator(
+    std::shared_ptr<TranslatorInterface> const & translator)
+{
+  if (!StageProfiler::Instance().IsEnabled())
+    return translator;
+  return std::make_shared<ProfiledTranslator>(translator);
+}
+
+std::shared_ptr<FilterInterface> ProfileFilters(std::shared_ptr<FilterInterface> const & filter)
+{
+  if (!StageProfiler::Instance().IsEnabled())
+    return filter;
+
+  auto const * collection = dynamic_cast<FilterCollection const *>(filter.get());
+  if (!collection)
+    return std::make_shared<ProfiledFilter>(filter);
+
+  auto profiled = std::make_shared<FilterCollection>();
+  for (auto const & f : collection->GetCollection())
+    profiled->Append(std::make_shared<ProfiledFilter>(f));
+  return profiled;
+}
+
+std::shared_ptr<CollectorInterface> ProfileCollectors(
+    std::shared_ptr<CollectorInterface> const & collector)
+{
+  if (!StageProfiler::Instance().IsEnabled())
+    return collector;
+
+  auto const * collection = dynamic_cast<CollectorCollection const *>(collector.get());
+  if (!collection)
+    return std::make_shared<ProfiledCollector>(collector);
+
+  auto profiled = std::make_shared<CollectorCollection>();
+  for (auto const & c : collection->GetCollection())
+    profiled->Append(std::make_shared<ProfiledCollector>(c));
+  return profiled;
+}
+}  // namespace generator
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "generator/collector_interface.hpp"
+#include "generator/filter_interface.hpp"
+#include "generator/translator_interface.hpp"
+
+#include "base/timer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace generator
+{
+// Metrics of a generator stage: a translator, a filter, a collector or a final processor.
+struct StageMetrics
+{
+  void Add(StageMetrics const & other);
+
+  // Time spent inside the stage, summed over all the threads. The threads don't wait inside
+  // the stages, so it's the CPU time the stage took.
+  double m_seconds = 0.0;
+  // Osm elements, relations and feature builders passed to the stage.
+  uint64_t m_elementsCount = 0;
+};
+
+// Collects the metrics of the generator stages from all the threads and makes a JSON report.
+// Profiling is off by default: the stages are not wrapped and nothing is measured then.
+// Memory is not measured by stages: they run at once on the same threads and share the heap.
+// The report has the peak memory of the whole process only.
+class StageProfiler
+{
+public:
+  enum class Kind
+  {
+    Translator,
+    Filter,
+    Collector,
+    FinalProcessor
+  };
+
+  static StageProfiler & Instance();
+
+  void Enable();
+  bool IsEnabled() const { return m_enabled; }
+
+  // Adds |metrics| to the metrics of the stage, the stages are identified by kind and name.
+  void Add(Kind kind, std::string const & name, StageMetrics const & metrics);
+
+  // Returns the metrics of the stages along with the wall time and the CPU time since
+  // the profiling was enabled, and the peak memory of the process.
+  std::string GetJsonReport() const;
+  void SaveJsonReport(std::string const & path) const;
+
+  static uint64_t GetPeakMemoryBytes();
+
+private:
+  StageProfiler() = default;
+
+  std::atomic<bool> m_enabled = false;
+  base::Timer m_timer;
+  double m_cpuSecondsOnEnable = 0.0;
+
+  mutable std::mutex m_mutex;
+  std::map<std::pair<Kind, std::string>, StageMetrics> m_stages;
+};
+
+std::string DebugPrint(StageProfiler::Kind kind);
+
+// Adds the time of the scope to |metrics|.
+class StageTimer
+{
+public:
+  explicit StageTimer(StageMetrics & metrics)
+    : m_metrics(metrics), m_start(std::chrono::steady_clock::now())
+  {
+  }
+
+  ~StageTimer()
+  {
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - m_start;
+    m_metrics.m_seconds += elapsed.count();
+  }
+
+private:
+  StageMetrics & m_metrics;
+  std::chrono::steady_clock::time_point const m_start;
+};
+
+// Metrics of a stage which are gathered from several threads at once. They are added to
+// the profiler on destruction.
+class SharedStageMetrics
+{
+public:
+  SharedStageMetrics(StageProfiler::Kind kind, std::string const & name);
+  ~SharedStageMetrics();
+
+  void Add(std::chrono::steady_clock::duration duration, uint64_t elementsCount);
+
+private:
+  StageProfiler::Kind m_kind;
+  std::string m_name;
+  std::atomic<int64_t> m_ticks = 0;
+  std::atomic<uint64_t> m_elementsCount = 0;
+};
+
+// The wrappers below measure the calls of the wrapped stages. Every thread has its own clones
+// of the stages, so the metrics are gathered without locks. They are added to the profiler
+// when the wrapper is destroyed. The filters are const, so their clones share the metrics.
+class ProfiledTranslator : public TranslatorInterface
+{
+public:
+  explicit ProfiledTranslator(std::shared_ptr<TranslatorInterface> const & translator);
+  ~ProfiledTranslator() override;
+
+  // TranslatorInterface overrides:
+  std::shared_ptr<TranslatorInterface> Clone() const override;
+
+  void Emit(OsmElement const & element) override;
+  void Finish() override;
+  bool Save() override;
+
+  void Merge(TranslatorInterface const & other) override;
+
+private:
+  std::shared_ptr<TranslatorInterface> m_translator;
+  std::string m_name;
+  StageMetrics m_metrics;
+};
+
+class ProfiledFilter : public FilterInterface
+{
+public:
+  explicit ProfiledFilter(std::shared_ptr<FilterInterface> const & filter);
+  ProfiledFilter(std::shared_ptr<FilterInterface> const & filter,
+                 std::shared_ptr<SharedStageMetrics> const & metrics);
+
+  // FilterInterface overrides:
+  std::shared_ptr<FilterInterface> Clone() const override;
+
+  bool IsAccepted(OsmElement const & element) const override;
+  bool IsAccepted(feature::FeatureBuilder const & feature) const override;
+
+private:
+  template <typename Element>
+  bool IsAcceptedImpl(Element const & element) const;
+
+  std::shared_ptr<FilterInterface> m_filter;
+  std::shared_ptr<SharedStageMetrics> m_metrics;
+};
+
+class ProfiledCollector : public CollectorInterface
+{
+public:
+  explicit ProfiledCollector(std::shared_ptr<CollectorInterface> const & collector);
+  ~ProfiledCollector() override;
+
+  // CollectorInterface overrides:
+  std::shared_ptr<CollectorInterface> Clone(IDRInterfacePtr const & cache = {}) const override;
+
+  void Collect(OsmElement const & element) override;
+  void CollectRelation(RelationElement const & element) override;
+  void CollectFeature(feature::FeatureBuilder const & feature, OsmElement const & element) override;
+  void Finish() override;
+
+  void Merge(CollectorInterface const & other) override;
+
+protected:
+  void Save() override;
+  void OrderCollectedData() override;
+
+private:
+  std::shared_ptr<CollectorInterface> m_collector;
+  std::string m_name;
+  StageMetrics m_metrics;
+};
+
+// Return the stage wrapped for profiling if it's enabled and the stage as is otherwise.
+// The filters and the collectors of the collections are wrapped one by one.
+std::shared_ptr<TranslatorInterface> ProfileTranslator(
+    std::shared_ptr<TranslatorInterface> const & translator);
+std::shared_ptr<FilterInterface> ProfileFilters(std::shared_ptr<FilterInterface> const & filter);
+std::shared_ptr<CollectorInterface> ProfileCollectors(
+    std::shared_ptr<CollectorInterface> const & collector);
+}  // namespace generator
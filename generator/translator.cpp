@@ -3,6 +3,7 @@
 #include "generator/collector_collection.hpp"
 #include "generator/filter_collection.hpp"
 #include "generator/osm_element.hpp"
+#include "generator/stage_profiler.hpp"
 
 
 namespace generator
@@ -32,10 +33,13 @@ Translator::Translator(std::shared_ptr<FeatureProcessorInterface> const & proces
 
 void Translator::SetCollector(std::shared_ptr<CollectorInterface> const & collector)
 {
-  m_collector = collector;
+  m_collector = ProfileCollectors(collector);
 }
 
-void Translator::SetFilter(std::shared_ptr<FilterInterface> const & filter) { m_filter = filter; }
+void Translator::SetFilter(std::shared_ptr<FilterInterface> const & filter)
+{
+  m_filter = ProfileFilters(filter);
+}
 
 void Translator::Emit(OsmElement const & src)
 {
@@ -4,8 +4,13 @@
 
 #include "platform/mwm_version.hpp"
 
+#include "base/assert.hpp"
+
 #include <algorithm>
+#include <atomic>
+#include <exception>
 #include <limits>
+#include <thread>
 
 using platform::CountryFile;
 using platform::LocalCountryFile;
@@ -53,16 +58,26 @@ public:
       covering::Intervals const & intervals = cov.Get<RectId::DEPTH_LEVELS>(lastScale);
       ScaleIndex<ModelReaderPtr> index(mwmValue->m_cont.GetReader(INDEX_FILE_TAG), mwmValue->m_factory);
 
-      // iterate through intervals
-      for (auto const & i : intervals)
+      auto const processValue = [&](uint64_t /* key */, uint32_t value)
+      {
+        if (checkUnique(value))
+          m_fn(value, *src);
+      };
+
+      if (cov.GetMode() == covering::Spiral)
       {
-        index.ForEachInIntervalAndScale(i.first, i.second, scale, [&](uint64_t /* key */, uint32_t value)
+        // Spiral intervals are ordered by the distance to the center and reading
+        // may be stopped after any of them, so they are walked one by one.
+        for (auto const & i : intervals)
         {
-          if (checkUnique(value))
-            m_fn(value, *src);
-        });
-        if (m_stop())
-          break;
+          index.ForEachInIntervalAndScale(i.first, i.second, scale, processValue);
+          if (m_stop())
+            break;
+        }
+      }
+      else
+      {
+        index.ForEachInIntervalsAndScale(intervals, scale, processValue);
       }
     }
 
@@ -79,9 +94,10 @@ private:
   DataSource::StopSearchCallback m_stop;
 };
 
-void ReadFeatureType(std::function<void(FeatureType &)> const & fn, FeatureSource & src, uint32_t index)
+// |original| is reused for all untouched features, so there are no allocations per feature.
+void ReadFeatureType(std::function<void(FeatureType &)> const & fn, FeatureSource & src, uint32_t index,
+                     FeatureType & original)
 {
-  std::unique_ptr<FeatureType> ft;
   switch (src.GetFeatureStatus(index))
   {
   case FeatureStatus::Deleted:
@@ -89,17 +105,109 @@ void ReadFeatureType(std::function<void(FeatureType &)> const & fn, FeatureSourc
   case FeatureStatus::Created:
   case FeatureStatus::Modified:
   {
-    ft = src.GetModifiedFeature(index);
-    break;
+    auto ft = src.GetModifiedFeature(index);
+    CHECK(ft, ());
+    fn(*ft);
+    return;
   }
   case FeatureStatus::Untouched:
   {
-    ft = src.GetOriginalFeature(index);
-    break;
+    src.GetOriginalFeature(index, original);
+    fn(original);
+    return;
   }
   }
-  CHECK(ft, ());
-  fn(*ft);
+}
+
+// Thread-safe CheckUniqueIndexes for the tasks which read the same mwm.
+class ConcurrentUniqueIndexes
+{
+public:
+  explicit ConcurrentUniqueIndexes(size_t size) : m_bits((size + 63) / 64) {}
+
+  // Returns true for the first call with |index| from any thread.
+  bool operator()(uint32_t index)
+  {
+    if (index / 64 >= m_bits.size())
+      return true;
+    uint64_t const mask = uint64_t{1} << (index % 64);
+    return (m_bits[index / 64].fetch_or(mask, std::memory_order_relaxed) & mask) == 0;
+  }
+
+private:
+  std::vector<std::atomic<uint64_t>> m_bits;
+};
+
+struct ParallelReadTask
+{
+  MwmSet::MwmId m_mwmId;
+  covering::Intervals m_intervals;
+  // Shared by all tasks of a split mwm: a feature stored under the keys of several
+  // tasks is read by the first of them. Null when the mwm is read by a single task.
+  std::shared_ptr<ConcurrentUniqueIndexes> m_unique;
+  // Edited features are read by the first task of an mwm only.
+  bool m_readEdited = false;
+  int m_scale = 0;
+};
+
+// Splits |intervals| into at most |maxParts| parts with about the same total length of intervals.
+std::vector<covering::Intervals> SplitIntervals(covering::Intervals const & intervals, size_t maxParts)
+{
+  uint64_t total = 0;
+  for (auto const & i : intervals)
+    total += static_cast<uint64_t>(i.second - i.first);
+
+  if (maxParts <= 1 || total == 0)
+    return {intervals};
+
+  uint64_t const partLength = (total + maxParts - 1) / maxParts;
+  std::vector<covering::Intervals> parts(1);
+  uint64_t length = 0;
+  for (auto const & i : intervals)
+  {
+    for (auto begin = i.first; begin < i.second;)
+    {
+      auto const take = std::min(static_cast<uint64_t>(i.second - begin), partLength - length);
+      auto const end = begin + static_cast<int64_t>(take);
+      parts.back().emplace_back(begin, end);
+      begin = end;
+      length += take;
+      if (length == partLength)
+      {
+        parts.emplace_back();
+        length = 0;
+      }
+    }
+  }
+
+  if (parts.back().empty())
+    parts.pop_back();
+  return parts;
+}
+
+void ReadParallelTask(FeatureSourceFactory const & factory, MwmSet::MwmHandle const & handle,
+                      ParallelReadTask const & task, m2::RectD const & rect,
+                      DataSource::FeatureCallback const & fn)
+{
+  MwmValue const * mwmValue = handle.GetValue();
+  if (!mwmValue)
+    return;
+
+  auto src = factory(handle);
+  FeatureType ft;
+  ScaleIndex<ModelReaderPtr> index(mwmValue->m_cont.GetReader(INDEX_FILE_TAG), mwmValue->m_factory);
+  CheckUniqueIndexes checkUnique;
+  index.ForEachInIntervalsAndScale(task.m_intervals, task.m_scale, [&](uint64_t /* key */, uint32_t value)
+  {
+    if (task.m_unique ? (*task.m_unique)(value) : checkUnique(value))
+      ReadFeatureType(fn, *src, value, ft);
+  });
+
+  if (task.m_readEdited)
+  {
+    src->ForEachAdditionalFeature(rect, task.m_scale,
+                                  [&](uint32_t i) { ReadFeatureType(fn, *src, i, ft); });
+  }
 }
 }  //  namespace
 
@@ -139,7 +247,16 @@ std::unique_ptr<FeatureType> FeaturesLoaderGuard::GetFeatureByIndex(uint32_t ind
   if (ft)
     return ft;
 
-  return GetOriginalFeatureByIndex(index);
+  if (!m_cache || !m_handle.IsAlive())
+    return GetOriginalFeatureByIndex(index);
+
+  if (auto const parsed = m_cache->Get(FeatureID(GetId(), index)))
+    return m_source->GetOriginalFeature(*parsed);
+
+  ft = GetOriginalFeatureByIndex(index);
+  if (ft)
+    m_cache->Put(*ft);
+  return ft;
 }
 
 std::unique_ptr<FeatureType> FeaturesLoaderGuard::GetOriginalFeatureByIndex(uint32_t index) const
@@ -178,6 +295,21 @@ std::unique_ptr<MwmValue> DataSource::CreateValue(MwmInfo & info) const
   return p;
 }
 
+DataSource::~DataSource()
+{
+  if (m_featureCache)
+    RemoveObserver(*m_featureCache);
+}
+
+void DataSource::EnableFeatureCache(size_t maxBytes)
+{
+  if (m_featureCache)
+    RemoveObserver(*m_featureCache);
+
+  m_featureCache = std::make_unique<FeatureCache>(maxBytes);
+  CHECK(AddObserver(*m_featureCache), ());
+}
+
 std::pair<MwmSet::MwmId, MwmSet::RegResult> DataSource::RegisterMap(LocalCountryFile const & localFile)
 {
   return Register(localFile);
@@ -217,6 +349,90 @@ void DataSource::ForEachInIntervals(ReaderCallback const & fn, covering::Coverin
     fn(GetMwmHandleById(worldID[1]), cov, scale);
 }
 
+void DataSource::ForEachInIntervalsParallel(FeatureCallbackMaker const & makeCallback,
+                                            covering::CoveringMode mode, m2::RectD const & rect,
+                                            int scale, size_t threadsCount) const
+{
+  CHECK_GREATER(threadsCount, 0, ());
+  CHECK_NOT_EQUAL(mode, covering::Spiral, ());
+
+  std::vector<std::shared_ptr<MwmInfo>> mwms;
+  GetMwmsInfo(mwms);
+
+  std::vector<ParallelReadTask> tasks;
+  for (auto const & info : mwms)
+  {
+    if (info->m_minScale > scale || scale > info->m_maxScale || !rect.IsIntersect(info->m_bordersRect))
+      continue;
+
+    auto const handle = GetMwmHandleById(MwmId(info));
+    MwmValue const * mwmValue = handle.GetValue();
+    if (!mwmValue)
+      continue;
+
+    // The full cover is a single interval of the whole key space which can't be split
+    // by keys. The covering of the mwm borders has all the features of the mwm too.
+    bool const isFullCover = mode == covering::FullCover;
+    m2::RectD const coverRect = isFullCover ? info->m_bordersRect : rect;
+    covering::CoveringGetter cov(coverRect, isFullCover ? covering::ViewportWithLowLevels : mode);
+
+    // Use last coding scale for covering (see index_builder.cpp).
+    auto const lastScale = mwmValue->GetHeader().GetLastScale();
+    auto parts = SplitIntervals(cov.Get<RectId::DEPTH_LEVELS>(lastScale), threadsCount);
+
+    std::shared_ptr<ConcurrentUniqueIndexes> unique;
+    if (parts.size() > 1)
+      unique = std::make_shared<ConcurrentUniqueIndexes>((*m_factory)(handle)->GetNumFeatures());
+
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+      ParallelReadTask task;
+      task.m_mwmId = handle.GetId();
+      task.m_intervals = std::move(parts[i]);
+      task.m_unique = unique;
+      task.m_readEdited = i == 0;
+      task.m_scale = std::min(scale, lastScale);
+      tasks.push_back(std::move(task));
+    }
+  }
+
+  std::vector<FeatureCallback> callbacks;
+  callbacks.reserve(threadsCount);
+  for (size_t i = 0; i < threadsCount; ++i)
+    callbacks.push_back(makeCallback(i));
+
+  // Tasks are taken one by one, so the threads which got small mwms take more of them.
+  std::atomic<size_t> nextTask(0);
+  std::vector<std::exception_ptr> errors(threadsCount);
+  auto const work = [&](size_t threadIdx)
+  {
+    try
+    {
+      for (size_t i = nextTask++; i < tasks.size(); i = nextTask++)
+        ReadParallelTask(*m_factory, GetMwmHandleById(tasks[i].m_mwmId), tasks[i], rect, callbacks[threadIdx]);
+    }
+    catch (...)
+    {
+      errors[threadIdx] = std::current_exception();
+      nextTask = tasks.size();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(threadsCount - 1);
+  for (size_t i = 1; i < threadsCount; ++i)
+    threads.emplace_back(work, i);
+  work(0);
+  for (auto & thread : threads)
+    thread.join();
+
+  for (auto const & error : errors)
+  {
+    if (error)
+      std::rethrow_exception(error);
+  }
+}
+
 void DataSource::ForEachFeatureIDInRect(FeatureIdCallback const & f, m2::RectD const & rect, int scale,
                                         covering::CoveringMode mode /* = covering::ViewportWithLowLevels */) const
 {
@@ -232,8 +448,9 @@ void DataSource::ForEachFeatureIDInRect(FeatureIdCallback const & f, m2::RectD c
 
 void DataSource::ForEachInRect(FeatureCallback const & f, m2::RectD const & rect, int scale) const
 {
-  auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-    ReadFeatureType(f, src, index);
+  FeatureType ft;
+  auto readFeatureType = [&f, &ft](uint32_t index, FeatureSource & src) {
+    ReadFeatureType(f, src, index, ft);
   };
 
   ReadMWMFunctor readFunctor(*m_factory, readFeatureType);
@@ -245,8 +462,9 @@ void DataSource::ForClosestToPoint(FeatureCallback const & f, StopSearchCallback
 {
   auto const rect = mercator::RectByCenterXYAndSizeInMeters(center, sizeM);
 
-  auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-    ReadFeatureType(f, src, index);
+  FeatureType ft;
+  auto readFeatureType = [&f, &ft](uint32_t index, FeatureSource & src) {
+    ReadFeatureType(f, src, index, ft);
   };
   ReadMWMFunctor readFunctor(*m_factory, readFeatureType, stop);
   ForEachInIntervals(readFunctor, covering::CoveringMode::Spiral, rect, scale);
@@ -254,14 +472,28 @@ void DataSource::ForClosestToPoint(FeatureCallback const & f, StopSearchCallback
 
 void DataSource::ForEachInScale(FeatureCallback const & f, int scale) const
 {
-  auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-    ReadFeatureType(f, src, index);
+  FeatureType ft;
+  auto readFeatureType = [&f, &ft](uint32_t index, FeatureSource & src) {
+    ReadFeatureType(f, src, index, ft);
   };
 
   ReadMWMFunctor readFunctor(*m_factory, readFeatureType);
   ForEachInIntervals(readFunctor, covering::FullCover, m2::RectD::GetInfiniteRect(), scale);
 }
 
+void DataSource::ForEachInRectParallel(FeatureCallbackMaker const & makeCallback, m2::RectD const & rect,
+                                       int scale, size_t threadsCount) const
+{
+  ForEachInIntervalsParallel(makeCallback, covering::ViewportWithLowLevels, rect, scale, threadsCount);
+}
+
+void DataSource::ForEachInScaleParallel(FeatureCallbackMaker const & makeCallback, int scale,
+                                        size_t threadsCount) const
+{
+  ForEachInIntervalsParallel(makeCallback, covering::FullCover, m2::RectD::GetInfiniteRect(), scale,
+                             threadsCount);
+}
+
 void DataSource::ForEachInRectForMWM(FeatureCallback const & f, m2::RectD const & rect, int scale,
                                      MwmId const & id) const
 {
@@ -269,8 +501,9 @@ void DataSource::ForEachInRectForMWM(FeatureCallback const & f, m2::RectD const
   if (handle.IsAlive())
   {
     covering::CoveringGetter cov(rect, covering::ViewportWithLowLevels);
-    auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-      ReadFeatureType(f, src, index);
+    FeatureType ft;
+    auto readFeatureType = [&f, &ft](uint32_t index, FeatureSource & src) {
+      ReadFeatureType(f, src, index, ft);
     };
 
     ReadMWMFunctor readFunctor(*m_factory, readFeatureType);
@@ -282,6 +515,7 @@ void DataSource::ReadFeatures(FeatureCallback const & fn, std::vector<FeatureID>
 {
   ASSERT(is_sorted(features.begin(), features.end()), ());
 
+  FeatureType original;
   auto fidIter = features.begin();
   auto const endIter = features.end();
   while (fidIter != endIter)
@@ -298,14 +532,17 @@ void DataSource::ReadFeatures(FeatureCallback const & fn, std::vector<FeatureID>
         ASSERT_NOT_EQUAL(
             FeatureStatus::Deleted, fts,
             ("Deleted feature was cached. It should not be here. Please review your code."));
-        std::unique_ptr<FeatureType> ft;
         if (fts == FeatureStatus::Modified || fts == FeatureStatus::Created)
-          ft = src->GetModifiedFeature(fidIter->m_index);
+        {
+          auto ft = src->GetModifiedFeature(fidIter->m_index);
+          CHECK(ft, ());
+          fn(*ft);
+        }
         else
-          ft = src->GetOriginalFeature(fidIter->m_index);
-
-        CHECK(ft, ());
-        fn(*ft);
+        {
+          src->GetOriginalFeature(fidIter->m_index, original);
+          fn(original);
+        }
       } while (++fidIter != endIter && id == fidIter->m_mwmId);
     }
     else
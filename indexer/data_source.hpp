@@ -1,5 +1,6 @@
 #pragma once
 
+#include "indexer/feature_cache.hpp"
 #include "indexer/feature_covering.hpp"
 #include "indexer/feature_source.hpp"
 #include "indexer/mwm_set.hpp"
@@ -15,6 +16,9 @@ public:
   using FeatureCallback = std::function<void(FeatureType &)>;
   using FeatureIdCallback = std::function<void(FeatureID const &)>;
   using StopSearchCallback = std::function<bool(void)>;
+  using FeatureCallbackMaker = std::function<FeatureCallback(size_t threadIdx)>;
+
+  ~DataSource() override;
 
   /// Registers a new map.
   std::pair<MwmId, RegResult> RegisterMap(platform::LocalCountryFile const & localFile);
@@ -38,6 +42,18 @@ public:
   void ForEachInScale(FeatureCallback const & f, int scale) const;
   void ForEachInRectForMWM(FeatureCallback const & f, m2::RectD const & rect, int scale,
                            MwmId const & id) const;
+
+  /// Parallel versions of ForEachInRect() and ForEachInScale() for batch jobs which read
+  /// a lot of features. Mwms, and big mwms split into ranges of covering intervals, are read
+  /// by |threadsCount| threads. Thread |i| calls the callback made by |makeCallback(i)|,
+  /// so the callbacks may keep per-thread state without locking and the caller reduces it
+  /// after the call returns. Every feature is reported once, in no particular order.
+  /// The first exception thrown by a callback is rethrown after all threads are stopped.
+  void ForEachInRectParallel(FeatureCallbackMaker const & makeCallback, m2::RectD const & rect,
+                             int scale, size_t threadsCount) const;
+  void ForEachInScaleParallel(FeatureCallbackMaker const & makeCallback, int scale,
+                              size_t threadsCount) const;
+
   // "features" must be sorted using FeatureID::operator< as predicate.
   void ReadFeatures(FeatureCallback const & fn, std::vector<FeatureID> const & features) const;
 
@@ -51,6 +67,11 @@ public:
     return (*m_factory)(handle);
   }
 
+  /// Enables the cache of decoded features used by FeaturesLoaderGuard::GetFeatureByIndex(),
+  /// see FeatureCache. Must be called before the data source is used by other threads.
+  void EnableFeatureCache(size_t maxBytes);
+  FeatureCache * GetFeatureCache() const { return m_featureCache.get(); }
+
 protected:
   using ReaderCallback = std::function<void(MwmSet::MwmHandle const & handle,
                                             covering::CoveringGetter & cov, int scale)>;
@@ -59,6 +80,9 @@ protected:
 
   void ForEachInIntervals(ReaderCallback const & fn, covering::CoveringMode mode,
                           m2::RectD const & rect, int scale) const;
+  void ForEachInIntervalsParallel(FeatureCallbackMaker const & makeCallback,
+                                  covering::CoveringMode mode, m2::RectD const & rect, int scale,
+                                  size_t threadsCount) const;
 
   /// @name MwmSet overrides
   /// @{
@@ -68,6 +92,7 @@ protected:
 
 private:
   std::unique_ptr<FeatureSourceFactory> m_factory;
+  std::unique_ptr<FeatureCache> m_featureCache;
 };
 
 // DataSource which operates with features from mwm file and does not support features creation
@@ -86,7 +111,9 @@ class FeaturesLoaderGuard
 {
 public:
   FeaturesLoaderGuard(DataSource const & dataSource, DataSource::MwmId const & id)
-    : m_handle(dataSource.GetMwmHandleById(id)), m_source(dataSource.CreateFeatureSource(m_handle))
+    : m_handle(dataSource.GetMwmHandleById(id))
+    , m_source(dataSource.CreateFeatureSource(m_handle))
+    , m_cache(dataSource.GetFeatureCache())
   {
     // FeaturesLoaderGuard is always created in-place, so MWM should always be alive.
     ASSERT(id.IsAlive(), ());
@@ -109,4 +136,5 @@ public:
 private:
   MwmSet::MwmHandle m_handle;
   std::unique_ptr<FeatureSource> m_source;
+  FeatureCache * m_cache;
 };
@@ -198,6 +198,112 @@ FeatureType::FeatureType(SharedLoadInfo const * loadInfo, vector<uint8_t> && buf
   m_header = Header(m_data); // Parse the header and optional name/layer/addinfo.
 }
 
+vector<uint8_t> & FeatureType::ResetRecord(SharedLoadInfo const * loadInfo,
+                                           indexer::MetadataDeserializer * metadataDeserializer)
+{
+  CHECK(loadInfo, ());
+  m_loadInfo = loadInfo;
+  m_metadataDeserializer = metadataDeserializer;
+
+  m_header = 0;
+  m_id = {};
+  // Clear() keeps the memory of the strings.
+  m_params.name.Clear();
+  m_params.house.Clear();
+  m_params.ref.clear();
+  m_params.layer = feature::LAYER_EMPTY;
+  m_params.rank = 0;
+
+  m_center = {};
+  m_limitRect = {};
+  m_points.clear();
+  m_triangles.clear();
+  if (!m_metadata.Empty())
+    m_metadata = {};
+  m_metaIds.clear();
+
+  m_parsed.Reset();
+  m_offsets.Reset();
+  m_ptsSimpMask = 0;
+  m_innerStats = {};
+  return m_data;
+}
+
+void FeatureType::OnRecordLoaded() { m_header = Header(m_data); }
+
+void FeatureType::Parse(uint32_t fields, int scale)
+{
+  if (fields & FIELD_TYPES)
+    ParseTypes();
+  if (fields & FIELD_COMMON)
+    ParseCommon();
+  if (fields & FIELD_NAMES)
+    ParseNames();
+  if (fields & FIELD_GEOMETRY)
+  {
+    switch (GetGeomType())
+    {
+    case GeomType::Line: ParseGeometry(scale); break;
+    case GeomType::Area: ParseTriangles(scale); break;
+    default: ParseCommon(); break;
+    }
+  }
+  if (fields & FIELD_METADATA_IDS)
+    ParseMetaIds();
+}
+
+std::unique_ptr<FeatureType> FeatureType::CreateParsedCopy()
+{
+  ParseTypes();
+  ParseCommon();
+  ParseHeader2();
+
+  auto ft = std::unique_ptr<FeatureType>(new FeatureType());
+  CopyParsedTo(*ft);
+  return ft;
+}
+
+std::unique_ptr<FeatureType> FeatureType::CopyParsed(
+    SharedLoadInfo const * loadInfo, indexer::MetadataDeserializer * metadataDeserializer) const
+{
+  ASSERT(m_parsed.m_types && m_parsed.m_common && m_parsed.m_header2, (m_id));
+
+  auto ft = std::make_unique<FeatureType>(loadInfo, std::vector<uint8_t>(m_data),
+                                          metadataDeserializer);
+  CopyParsedTo(*ft);
+  return ft;
+}
+
+void FeatureType::CopyParsedTo(FeatureType & ft) const
+{
+  ft.m_header = m_header;
+  ft.m_types = m_types;
+  ft.m_id = m_id;
+  ft.m_params = m_params;
+  ft.m_center = m_center;
+  ft.m_limitRect = m_limitRect;
+  // The geometry is not filtered by scale yet, see ParseHeader2().
+  ft.m_points = m_points;
+  ft.m_triangles = m_triangles;
+  if (ft.m_data.empty())
+    ft.m_data = m_data;
+
+  ft.m_parsed.m_types = m_parsed.m_types;
+  ft.m_parsed.m_common = m_parsed.m_common;
+  ft.m_parsed.m_names = m_parsed.m_names;
+  ft.m_parsed.m_header2 = m_parsed.m_header2;
+  ft.m_offsets = m_offsets;
+  ft.m_ptsSimpMask = m_ptsSimpMask;
+  ft.m_innerStats = m_innerStats;
+}
+
+size_t FeatureType::GetParsedCopySize() const
+{
+  return sizeof(FeatureType) + m_data.size() + m_params.name.GetBuffer().size() +
+         m_params.ref.size() + m_params.house.Get().size() +
+         (m_points.size() + m_triangles.size()) * sizeof(m2::PointD);
+}
+
 std::unique_ptr<FeatureType> FeatureType::CreateFromMapObject(osm::MapObject const & emo)
 {
   auto ft = std::unique_ptr<FeatureType>(new FeatureType());
@@ -237,7 +343,7 @@ std::unique_ptr<FeatureType> FeatureType::CreateFromMapObject(osm::MapObject con
     ft->m_params.house.Clear();
   else
     ft->m_params.house.Set(house);
-  ft->m_parsed.m_common = true;
+  ft->m_parsed.m_common = ft->m_parsed.m_names = true;
 
   emo.AssignMetadata(ft->m_metadata);
   ft->m_parsed.m_metadata = true;
@@ -306,7 +412,14 @@ void FeatureType::ParseCommon()
   ParseTypes();
 
   ArrayByteSource source(m_data.data() + m_offsets.m_common);
-  uint8_t const h = Header(m_data);
+  uint8_t h = Header(m_data);
+  if (h & HEADER_MASK_HAS_NAME)
+  {
+    // Names are the biggest part of the common data and most of the readers don't need them,
+    // see ParseNames(). The string is stored as size - 1 and the bytes.
+    source.Advance(ReadVarUint<uint32_t>(source) + 1);
+    h &= ~HEADER_MASK_HAS_NAME;
+  }
   m_params.Read(source, h);
 
   if (GetGeomType() == GeomType::Point)
@@ -319,6 +432,21 @@ void FeatureType::ParseCommon()
   m_parsed.m_common = true;
 }
 
+void FeatureType::ParseNames()
+{
+  if (m_parsed.m_names)
+    return;
+
+  ParseCommon();
+  if (HasName())
+  {
+    // Names go first in the common part.
+    ArrayByteSource source(m_data.data() + m_offsets.m_common);
+    m_params.name.Read(source);
+  }
+  m_parsed.m_names = true;
+}
+
 m2::PointD FeatureType::GetCenter()
 {
   ASSERT_EQUAL(GetGeomType(), feature::GeomType::Point, ());
@@ -646,13 +774,14 @@ void FeatureType::ParseMetaIds()
 
 StringUtf8Multilang const & FeatureType::GetNames()
 {
-  ParseCommon();
+  ParseNames();
   return m_params.name;
 }
 
 std::string FeatureType::DebugString()
 {
   ParseGeometryAndTriangles(FeatureType::BEST_GEOMETRY);
+  ParseNames();
 
   std::string res = DebugPrint(m_id) + " " + DebugPrint(GetGeomType());
 
@@ -774,7 +903,7 @@ void FeatureType::GetPreferredNames(bool allowTranslit, int8_t deviceLang, featu
   if (!mwmInfo)
     return;
 
-  ParseCommon();
+  ParseNames();
 
   feature::GetPreferredNames({ GetNames(), mwmInfo->GetRegionData(), deviceLang, allowTranslit }, out);
 }
@@ -795,7 +924,7 @@ void FeatureType::GetReadableName(bool allowTranslit, int8_t deviceLang, feature
   if (!mwmInfo)
     return;
 
-  ParseCommon();
+  ParseNames();
 
   feature::GetReadableName({ GetNames(), mwmInfo->GetRegionData(), deviceLang, allowTranslit }, out);
 }
@@ -811,7 +940,7 @@ string_view FeatureType::GetName(int8_t lang)
   if (!HasName())
     return {};
 
-  ParseCommon();
+  ParseNames();
 
   // We don't store empty names. UPD: We do for coast features :)
   string_view name;
@@ -8,6 +8,7 @@
 #include "base/macros.hpp"
 
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -29,11 +30,14 @@ class MapObject;
 // Lazy feature loader. Loads needed data and caches it.
 class FeatureType
 {
-  FeatureType() = default;
-
 public:
   using GeometryOffsets = buffer_vector<uint32_t, feature::DataHeader::kMaxScalesCount>;
 
+  /// Creates an empty feature to be filled by FeaturesVector::GetByIndex(index, ft).
+  /// Such a feature may be reused for many records: the record buffer, names and geometry
+  /// buffers keep their memory, so there are no heap allocations for most of the features.
+  FeatureType() = default;
+
   FeatureType(feature::SharedLoadInfo const * loadInfo, std::vector<uint8_t> && buffer,
               indexer::MetadataDeserializer * metadataDeserializer);
 
@@ -54,7 +58,7 @@ public:
     if (!HasName())
       return false;
 
-    ParseCommon();
+    ParseNames();
     m_params.name.ForEach(std::forward<T>(fn));
     return true;
   }
@@ -87,6 +91,25 @@ public:
   void ParseTriangles(int scale);
   //@}
 
+  /// @name Explicit partial decoding.
+  //@{
+  /// Fields for Parse(). Getters parse everything they need lazily anyway, Parse() is for
+  /// the hot loops which know in advance what they read: it decodes exactly |fields|.
+  enum Field : uint32_t
+  {
+    FIELD_TYPES = 1 << 0,
+    /// Center of a point feature, layer, rank, house number and ref.
+    FIELD_COMMON = 1 << 1,
+    /// All names, see GetName(lang) for one language.
+    FIELD_NAMES = 1 << 2,
+    /// Points of a line or triangles of an area at the scale passed to Parse().
+    FIELD_GEOMETRY = 1 << 3,
+    FIELD_METADATA_IDS = 1 << 4,
+  };
+
+  void Parse(uint32_t fields, int scale = BEST_GEOMETRY);
+  //@}
+
   /// @name Geometry.
   //@{
   /// This constant values should be equal with feature::FeatureLoader implementation.
@@ -196,6 +219,7 @@ private:
   {
     bool m_types : 1;
     bool m_common : 1;
+    bool m_names : 1;
     bool m_header2 : 1;
     bool m_points : 1;
     bool m_triangles : 1;
@@ -205,7 +229,8 @@ private:
     ParsedFlags() { Reset(); }
     void Reset()
     {
-      m_types = m_common = m_header2 = m_points = m_triangles = m_metadata = m_metaIds = false;
+      m_types = m_common = m_names = m_header2 = m_points = m_triangles = m_metadata = m_metaIds =
+          false;
     }
   };
 
@@ -224,8 +249,32 @@ private:
     }
   };
 
+  friend class FeaturesVector;
+  friend class FeatureCache;
+
+  // Prepares the feature for the next record, see FeaturesVector::GetByIndex(index, ft).
+  // Returns the record buffer to be filled.
+  std::vector<uint8_t> & ResetRecord(feature::SharedLoadInfo const * loadInfo,
+                                     indexer::MetadataDeserializer * metadataDeserializer);
+  void OnRecordLoaded();
+
+  // Parses the fields which are needed at any scale: types, common fields except names
+  // and the geometry header with the inner geometry. Returns a copy of them and of the record
+  // which does not reference the mwm, see FeatureCache.
+  std::unique_ptr<FeatureType> CreateParsedCopy();
+  // Makes a feature of the mwm of |loadInfo| from a copy made by CreateParsedCopy().
+  // The names, the metadata and the geometry of the requested scale are parsed lazily
+  // like in a feature read from the mwm. Does not modify the copy, so it may be shared by threads.
+  std::unique_ptr<FeatureType> CopyParsed(feature::SharedLoadInfo const * loadInfo,
+                                          indexer::MetadataDeserializer * metadataDeserializer) const;
+  void CopyParsedTo(FeatureType & ft) const;
+  // Approximate memory used by a copy made by CreateParsedCopy().
+  size_t GetParsedCopySize() const;
+
   void ParseTypes();
+  // Parses the common part of the record except names, which are skipped.
   void ParseCommon();
+  void ParseNames();
   void ParseMetadata();
   void ParseMetaIds();
   void ParseGeometryAndTriangles(int scale);
@@ -0,0 +1,128 @@
+#include "indexer/feature_cache.hpp"
+
+#include "platform/local_country_file.hpp"
+
+#include "base/assert.hpp"
+
+#include <utility>
+
+using namespace std;
+
+FeatureCache::FeatureCache(size_t maxBytes) : m_maxShardBytes(maxBytes / kShardsCount)
+{
+  CHECK_GREATER(m_maxShardBytes, 0, (maxBytes));
+}
+
+shared_ptr<FeatureType const> FeatureCache::Get(FeatureID const & id)
+{
+  auto & shard = GetShard(id);
+  lock_guard<mutex> lock(shard.m_mutex);
+  auto const it = shard.m_index.find(id);
+  if (it == shard.m_index.end())
+  {
+    ++m_numMisses;
+    return {};
+  }
+
+  ++m_numHits;
+  shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, it->second);
+  // The feature is shared, so it may be copied without the lock while it is being evicted.
+  return it->second->m_feature;
+}
+
+void FeatureCache::Put(FeatureType & ft)
+{
+  shared_ptr<FeatureType const> feature = ft.CreateParsedCopy();
+
+  Entry entry;
+  entry.m_id = ft.GetID();
+  entry.m_size = feature->GetParsedCopySize();
+  entry.m_feature = std::move(feature);
+
+  auto & shard = GetShard(entry.m_id);
+  lock_guard<mutex> lock(shard.m_mutex);
+  auto const it = shard.m_index.find(entry.m_id);
+  if (it != shard.m_index.end())
+  {
+    // Another thread has already cached the feature.
+    shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, it->second);
+    return;
+  }
+
+  shard.m_size += entry.m_size;
+  shard.m_lru.push_front(std::move(entry));
+  shard.m_index.emplace(shard.m_lru.front().m_id, shard.m_lru.begin());
+  Shrink(shard);
+}
+
+void FeatureCache::Clear()
+{
+  for (auto & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard.m_mutex);
+    shard.m_index.clear();
+    shard.m_lru.clear();
+    shard.m_size = 0;
+  }
+}
+
+size_t FeatureCache::GetNumFeatures() const
+{
+  size_t num = 0;
+  for (auto const & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard.m_mutex);
+    num += shard.m_lru.size();
+  }
+  return num;
+}
+
+size_t FeatureCache::GetSizeBytes() const
+{
+  size_t size = 0;
+  for (auto const & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard.m_mutex);
+    size += shard.m_size;
+  }
+  return size;
+}
+
+void FeatureCache::OnMapDeregistered(platform::LocalCountryFile const & localFile)
+{
+  for (auto & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard.m_mutex);
+    for (auto it = shard.m_lru.begin(); it != shard.m_lru.end();)
+    {
+      auto const & info = it->m_id.m_mwmId.GetInfo();
+      if (info && info->GetLocalFile() == localFile)
+      {
+        shard.m_size -= it->m_size;
+        shard.m_index.erase(it->m_id);
+        it = shard.m_lru.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+}
+
+FeatureCache::Shard & FeatureCache::GetShard(FeatureID const & id)
+{
+  return m_shards[hash<FeatureID>()(id) % kShardsCount];
+}
+
+void FeatureCache::Shrink(Shard & shard)
+{
+  // The most recent feature is kept even if it alone exceeds the limit.
+  while (shard.m_size > m_maxShardBytes && shard.m_lru.size() > 1)
+  {
+    auto const & lru = shard.m_lru.back();
+    shard.m_size -= lru.m_size;
+    shard.m_index.erase(lru.m_id);
+    shard.m_lru.pop_back();
+  }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "indexer/feature.hpp"
+#include "indexer/feature_decl.hpp"
+#include "indexer/mwm_set.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace platform
+{
+class LocalCountryFile;
+}
+
+/// Memory-bounded LRU cache of decoded features shared by all the threads, see
+/// DataSource::EnableFeatureCache(). It is meant for the servers and the subsystems
+/// which decode the same features again and again within a short time.
+///
+/// Only the original mwm features are cached: edited features are served by the editor
+/// before the cache is consulted, so edits never make the cached features stale.
+/// Features of a deregistered mwm are dropped when the cache is notified as MwmSet::Observer.
+///
+/// The cache keeps the record of a feature and the fields which are needed at any scale,
+/// see FeatureType::CreateParsedCopy(). Features made from it parse the names, the metadata
+/// and the geometry of the requested scale lazily, like the features read from the mwm.
+class FeatureCache : public MwmSet::Observer
+{
+public:
+  explicit FeatureCache(size_t maxBytes);
+
+  /// Returns the parsed copy of the feature, nullptr if there is no such feature.
+  /// See FeatureSource::GetOriginalFeature() to make a feature from it.
+  std::shared_ptr<FeatureType const> Get(FeatureID const & id);
+
+  /// Caches the parsed copy of |ft|.
+  void Put(FeatureType & ft);
+
+  void Clear();
+
+  size_t GetNumFeatures() const;
+  size_t GetSizeBytes() const;
+  uint64_t GetNumHits() const { return m_numHits; }
+  uint64_t GetNumMisses() const { return m_numMisses; }
+
+  /// @name MwmSet::Observer overrides
+  /// @{
+  void OnMapDeregistered(platform::LocalCountryFile const & localFile) override;
+  /// @}
+
+private:
+  // Features are spread over the shards by id, so the threads rarely wait for each other.
+  static size_t constexpr kShardsCount = 16;
+
+  struct Entry
+  {
+    FeatureID m_id;
+    std::shared_ptr<FeatureType const> m_feature;
+    size_t m_size = 0;
+  };
+
+  struct Shard
+  {
+    mutable std::mutex m_mutex;
+    // The most recently used feature is at the front.
+    std::list<Entry> m_lru;
+    std::unordered_map<FeatureID, std::list<Entry>::iterator> m_index;
+    size_t m_size = 0;
+  };
+
+  Shard & GetShard(FeatureID const & id);
+  // Removes the least recently used features until the shard fits into the limit.
+  // Must be called with the shard mutex locked.
+  void Shrink(Shard & shard);
+
+  size_t const m_maxShardBytes;
+  std::array<Shard, kShardsCount> m_shards;
+
+  std::atomic<uint64_t> m_numHits = 0;
+  std::atomic<uint64_t> m_numMisses = 0;
+};
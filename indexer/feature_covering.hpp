@@ -105,6 +105,7 @@ public:
   CoveringGetter(m2::RectD const & r, CoveringMode mode) : m_rect(r), m_mode(mode) {}
 
   m2::RectD const & GetRect() const { return m_rect; }
+  CoveringMode GetMode() const { return m_mode; }
 
   template <int DEPTH_LEVELS>
   Intervals const & Get(int scale)
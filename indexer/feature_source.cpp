@@ -41,6 +41,22 @@ std::unique_ptr<FeatureType> FeatureSource::GetOriginalFeature(uint32_t index) c
   return ft;
 }
 
+void FeatureSource::GetOriginalFeature(uint32_t index, FeatureType & ft) const
+{
+  ASSERT(m_handle.IsAlive(), ());
+  ASSERT(m_vector, ());
+  m_vector->GetByIndex(index, ft);
+  ft.SetID({ GetMwmId(), index });
+}
+
+std::unique_ptr<FeatureType> FeatureSource::GetOriginalFeature(FeatureType const & parsed) const
+{
+  ASSERT(m_handle.IsAlive(), ());
+  ASSERT(m_vector, ());
+  ASSERT_EQUAL(parsed.GetID().m_mwmId, GetMwmId(), ());
+  return m_vector->GetByParsedCopy(parsed);
+}
+
 FeatureStatus FeatureSource::GetFeatureStatus(uint32_t index) const
 {
   return FeatureStatus::Untouched;
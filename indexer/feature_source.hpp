@@ -34,6 +34,10 @@ public:
   size_t GetNumFeatures() const;
 
   std::unique_ptr<FeatureType> GetOriginalFeature(uint32_t index) const;
+  // Loads the original feature into |ft| reusing its memory.
+  void GetOriginalFeature(uint32_t index, FeatureType & ft) const;
+  // Makes the original feature from its parsed copy, see FeatureCache.
+  std::unique_ptr<FeatureType> GetOriginalFeature(FeatureType const & parsed) const;
 
   MwmSet::MwmId const & GetMwmId() const { return m_handle.GetId(); }
 
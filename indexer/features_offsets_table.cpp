@@ -70,12 +70,12 @@ namespace feature
   {
     unique_ptr<FeaturesOffsetsTable> table(new FeaturesOffsetsTable());
 
-    table->m_file.Open(cont.GetFileName());
-    auto p = cont.GetAbsoluteOffsetAndSize(FEATURE_OFFSETS_FILE_TAG);
-    ASSERT(p.first % 4 == 0, (p.first)); // will get troubles in succinct otherwise
-    table->m_handle.Assign(table->m_file.Map(p.first, p.second, FEATURE_OFFSETS_FILE_TAG));
+    table->m_region = make_unique<MappedSectionRegion>(cont, FEATURE_OFFSETS_FILE_TAG);
+    auto const * data = table->m_region->ImmutableData();
+    // will get troubles in succinct otherwise
+    ASSERT(reinterpret_cast<uintptr_t>(data) % 4 == 0, (cont.GetFileName()));
 
-    succinct::mapper::map(table->m_table, table->m_handle.GetData<char>());
+    succinct::mapper::map(table->m_table, reinterpret_cast<char const *>(data));
     return table;
   }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "coding/files_container.hpp"
+#include "coding/memory_region.hpp"
 #include "coding/mmap_reader.hpp"
 
 #include "defines.hpp"
@@ -66,6 +67,7 @@ namespace feature
     /// Load table by full path to the table file.
     static std::unique_ptr<FeaturesOffsetsTable> Load(std::string const & filePath);
 
+    /// Queries the table right from the mapped mwm section, see MappedSectionRegion.
     static std::unique_ptr<FeaturesOffsetsTable> Load(FilesContainerR const & cont);
     static void Build(FilesContainerR const & cont, std::string const & storePath);
 
@@ -102,9 +104,7 @@ namespace feature
 
     succinct::elias_fano m_table;
     std::unique_ptr<MmapReader> m_pReader;
-
-    ::detail::MappedFile m_file;
-    ::detail::MappedFile::Handle m_handle;
+    std::unique_ptr<MemoryRegion> m_region;
   };
 
   // Builds feature offsets table in an mwm or rebuilds an existing
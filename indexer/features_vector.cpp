@@ -32,6 +32,18 @@ std::unique_ptr<FeatureType> FeaturesVector::GetByIndex(uint32_t index) const
   return std::make_unique<FeatureType>(&m_loadInfo, m_recordReader->ReadRecord(ftOffset), m_metaDeserializer);
 }
 
+void FeaturesVector::GetByIndex(uint32_t index, FeatureType & ft) const
+{
+  auto const ftOffset = m_table ? m_table->GetFeatureOffset(index) : index;
+  m_recordReader->ReadRecord(ftOffset, ft.ResetRecord(&m_loadInfo, m_metaDeserializer));
+  ft.OnRecordLoaded();
+}
+
+std::unique_ptr<FeatureType> FeaturesVector::GetByParsedCopy(FeatureType const & parsed) const
+{
+  return parsed.CopyParsed(&m_loadInfo, m_metaDeserializer);
+}
+
 size_t FeaturesVector::GetNumFeatures() const
 {
   return m_table ? m_table->size() : 0;
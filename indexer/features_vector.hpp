@@ -24,6 +24,10 @@ public:
                  indexer::MetadataDeserializer * metaDeserializer);
 
   std::unique_ptr<FeatureType> GetByIndex(uint32_t index) const;
+  /// Loads the feature into |ft| reusing its memory, see FeatureType::FeatureType().
+  void GetByIndex(uint32_t index, FeatureType & ft) const;
+  /// Makes a feature of this mwm from a copy made by FeatureType::CreateParsedCopy().
+  std::unique_ptr<FeatureType> GetByParsedCopy(FeatureType const & parsed) const;
 
   size_t GetNumFeatures() const;
 
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 class HouseToStreetTable
 {
@@ -57,3 +58,17 @@ public:
   };
   virtual std::optional<Result> Get(uint32_t houseId) const = 0;
 };
+
+// Inverse of HouseToStreetTable: street feature id -> ids of houses whose
+// address refers to this street. Uses the same section header.
+class StreetToHousesTable
+{
+public:
+  using Header = HouseToStreetTable::Header;
+
+  virtual ~StreetToHousesTable() = default;
+
+  // Replaces |houses| with the sorted ids of houses on |streetId|.
+  // Returns false when there are no such houses.
+  virtual bool Get(uint32_t streetId, std::vector<uint32_t> & houses) const = 0;
+};
@@ -1,5 +1,6 @@
 #include "testing/testing.hpp"
 
+#include "indexer/feature_covering.hpp"
 #include "indexer/interval_index.hpp"
 #include "indexer/interval_index_builder.hpp"
 
@@ -9,6 +10,9 @@
 #include "base/macros.hpp"
 #include "base/stl_helpers.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -291,3 +295,89 @@ UNIT_TEST(IntervalIndex_Simple5)
     TEST_EQUAL(values, vector<uint32_t>(expected, expected + ARRAY_SIZE(expected)), ());
   }
 }
+
+UNIT_TEST(IntervalIndex_ForEachInIntervals)
+{
+  vector<CellIdFeaturePairForTest> data;
+  data.push_back(CellIdFeaturePairForTest(0x0100ULL, 0));
+  data.push_back(CellIdFeaturePairForTest(0x0200ULL, 1));
+  data.push_back(CellIdFeaturePairForTest(0xA0B1C2D100ULL, 2));
+  data.push_back(CellIdFeaturePairForTest(0xA0B1C2D200ULL, 3));
+  data.push_back(CellIdFeaturePairForTest(0xA0B1C2D200ULL, 4));
+  data.push_back(CellIdFeaturePairForTest(0xA0B2C2D100ULL, 5));
+  vector<char> serialIndex;
+  MemWriter<vector<char> > writer(serialIndex);
+  BuildIntervalIndex(data.begin(), data.end(), writer, 40);
+  MemReader reader(&serialIndex[0], serialIndex.size());
+  IntervalIndex<MemReader, uint32_t> index(reader);
+
+  auto const getValues = [&index](vector<pair<int64_t, int64_t>> const & intervals) {
+    vector<uint32_t> values;
+    index.ForEachInIntervals(IndexValueInserter(values), intervals);
+    return values;
+  };
+
+  TEST_EQUAL(getValues({}), vector<uint32_t>{}, ());
+  TEST_EQUAL(getValues({{0, static_cast<int64_t>(index.KeyEnd())}}),
+             vector<uint32_t>({0, 1, 2, 3, 4, 5}), ());
+  // Unsorted, overlapping and adjacent intervals, values are reported in the order of keys once.
+  TEST_EQUAL(getValues({{0xA0B2C2D100LL, 0xA0B2C2D101LL},
+                        {0x0100, 0x0201},
+                        {0x0150, 0x0250},
+                        {0xA0B1C2D100LL, 0xA0B1C2D200LL},
+                        {0xA0B1C2D200LL, 0xA0B1C2D201LL}}),
+             vector<uint32_t>({0, 1, 2, 3, 4, 5}), ());
+  TEST_EQUAL(getValues({{0x0101, 0x0200}, {0xA0B1C2D101LL, 0xA0B1C2D200LL}}), vector<uint32_t>{},
+             ());
+  TEST_EQUAL(getValues({{0x0200, 0x0201}, {0xA0B1C2D200LL, 0xFFFFFFFFFFFFLL}}),
+             vector<uint32_t>({1, 3, 4, 5}), ());
+}
+
+UNIT_TEST(IntervalIndex_ForEachInIntervals_Random)
+{
+  // Keys and intervals are similar to the geometry index of a country mwm and
+  // the covering of a viewport: many short intervals spread over the key space.
+  uint32_t constexpr kKeyBits = 40;
+  uint64_t constexpr kKeyMask = (uint64_t{1} << kKeyBits) - 1;
+
+  mt19937_64 rng(0);
+
+  vector<CellIdFeaturePairForTest> data;
+  for (uint32_t i = 0; i < 10000; ++i)
+    data.emplace_back(max(rng() & kKeyMask, uint64_t{1}), i);
+  sort(data.begin(), data.end(), [](auto const & lhs, auto const & rhs) {
+    return lhs.GetCell() < rhs.GetCell();
+  });
+
+  vector<char> serialIndex;
+  MemWriter<vector<char> > writer(serialIndex);
+  BuildIntervalIndex(data.begin(), data.end(), writer, kKeyBits);
+  MemReader reader(&serialIndex[0], serialIndex.size());
+  IntervalIndex<MemReader, uint32_t> index(reader);
+
+  for (size_t i = 0; i < 20; ++i)
+  {
+    vector<pair<int64_t, int64_t>> intervals;
+    uint64_t const center = rng() & kKeyMask;
+    for (size_t j = 0; j < 300; ++j)
+    {
+      auto const beg = static_cast<int64_t>((center + (rng() % (uint64_t{1} << 32))) & kKeyMask);
+      intervals.emplace_back(beg, beg + static_cast<int64_t>(rng() % (uint64_t{1} << 28)) + 1);
+    }
+    intervals = covering::SortAndMergeIntervals(intervals);
+
+    vector<uint32_t> expected;
+    for (auto const & interval : intervals)
+    {
+      index.ForEach([&expected](uint64_t, uint32_t value) { expected.push_back(value); },
+                    interval.first, interval.second);
+    }
+
+    vector<uint32_t> values;
+    index.ForEachInIntervals([&values](uint64_t, uint32_t value) { values.push_back(value); },
+                             intervals);
+
+    TEST(!expected.empty(), (i));
+    TEST_EQUAL(values, expected, (i));
+  }
+}
@@ -5,10 +5,15 @@
 #include "indexer/indexer_tests/test_mwm_set.hpp"
 #include "indexer/mwm_set.hpp"
 
+#include "coding/reader.hpp"
+
+#include "base/exception.hpp"
 #include "base/macros.hpp"
 
 #include <initializer_list>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace mwm_set_test
 {
@@ -20,6 +25,21 @@ using tests::TestMwmSet;
 
 using MwmsInfo = unordered_map<string, shared_ptr<MwmInfo>>;
 
+class TooManyFilesMwmSet : public TestMwmSet
+{
+public:
+  bool m_tooManyFiles = false;
+
+protected:
+  // TestMwmSet overrides:
+  std::unique_ptr<MwmValue> CreateValue(MwmInfo & info) const override
+  {
+    if (m_tooManyFiles)
+      MYTHROW(Reader::TooManyFilesException, ("Can't open", info.GetCountryName()));
+    return TestMwmSet::CreateValue(info);
+  }
+};
+
 void GetMwmsInfo(MwmSet const & mwmSet, MwmsInfo & mwmsInfo)
 {
   vector<shared_ptr<MwmInfo>> mwmsInfoList;
@@ -169,4 +189,105 @@ UNIT_TEST(MwmSetLockAndIdTest)
   TEST(!handle.GetId().IsAlive(), ());
   TEST(!handle.GetId().GetInfo().get(), ());
 }
+
+UNIT_TEST(MwmSetCachedValuesTest)
+{
+  ScopedMwm mwm2("2.mwm");
+  TestMwmSet mwmSet;
+  auto const id = mwmSet.Register(LocalCountryFile::MakeForTesting("2")).first;
+
+  MwmValue const * value = nullptr;
+  {
+    auto const handle = mwmSet.GetMwmHandleById(id);
+    TEST(handle.IsAlive(), ());
+    value = handle.GetValue();
+  }
+  TEST_EQUAL(id.GetInfo()->GetNumRefs(), 0, ());
+
+  {
+    // The released value is taken from the cache.
+    auto const handle = mwmSet.GetMwmHandleById(id);
+    TEST_EQUAL(handle.GetValue(), value, ());
+    TEST_EQUAL(id.GetInfo()->GetNumRefs(), 1, ());
+  }
+
+  mwmSet.ClearCache();
+  TEST(mwmSet.Deregister(CountryFile("2")), ());
+  TEST(!mwmSet.GetMwmHandleById(id).IsAlive(), ());
+}
+
+UNIT_TEST(MwmSetConcurrentHandlesTest)
+{
+  ScopedMwm mwm2("2.mwm");
+  ScopedMwm mwm3("3.mwm");
+  TestMwmSet mwmSet;
+  vector<MwmSet::MwmId> const ids = {mwmSet.Register(LocalCountryFile::MakeForTesting("2")).first,
+                                     mwmSet.Register(LocalCountryFile::MakeForTesting("3")).first};
+
+  size_t constexpr kThreadsCount = 8;
+  size_t constexpr kIterations = 1000;
+  vector<thread> threads;
+  for (size_t t = 0; t < kThreadsCount; ++t)
+  {
+    threads.emplace_back([&mwmSet, &ids, t]() {
+      for (size_t i = 0; i < kIterations; ++i)
+      {
+        size_t const mwm = (i + t) % ids.size();
+        auto const handle = mwmSet.GetMwmHandleById(ids[mwm]);
+        // The second mwm is deregistered concurrently.
+        if (mwm == 0)
+          TEST(handle.IsAlive(), ());
+      }
+    });
+  }
+
+  // Deregistration is delayed until all the handles of the mwm are released.
+  mwmSet.Deregister(CountryFile("3"));
+
+  for (auto & thread : threads)
+    thread.join();
+
+  TEST_EQUAL(ids[0].GetInfo()->GetNumRefs(), 0, ());
+  TEST_EQUAL(ids[1].GetInfo()->GetNumRefs(), 0, ());
+  TEST(ids[0].IsAlive(), ());
+  TEST(!ids[1].IsAlive(), ());
+  TEST_LESS_OR_EQUAL(mwmSet.GetCacheCapacity(), MwmSet::kMaxCacheSize, ());
+}
+
+UNIT_TEST(MwmSetTooManyFilesTest)
+{
+  ScopedMwm mwm1("1.mwm");
+  ScopedMwm mwm2("2.mwm");
+  ScopedMwm mwm3("3.mwm");
+  ScopedMwm mwm4("4.mwm");
+  ScopedMwm mwm5("5.mwm");
+  TooManyFilesMwmSet mwmSet;
+
+  vector<MwmSet::MwmId> ids;
+  for (auto const name : {"1", "2", "3", "4", "5"})
+    ids.push_back(mwmSet.Register(LocalCountryFile::MakeForTesting(name)).first);
+
+  {
+    vector<MwmSet::MwmHandle> handles;
+    for (size_t i = 0; i < 4; ++i)
+      handles.push_back(mwmSet.GetMwmHandleById(ids[i]));
+  }
+  TEST_EQUAL(mwmSet.GetCacheCapacity(), 64, ());
+
+  // The cache of 4 values is halved.
+  mwmSet.m_tooManyFiles = true;
+  TEST(!mwmSet.GetMwmHandleById(ids[4]).IsAlive(), ());
+  TEST_EQUAL(mwmSet.GetCacheCapacity(), 2, ());
+
+  // And grows back.
+  mwmSet.m_tooManyFiles = false;
+  TEST(mwmSet.GetMwmHandleById(ids[4]).IsAlive(), ());
+  TEST_EQUAL(mwmSet.GetCacheCapacity(), 3, ());
+  for (size_t i = 0; i < 2 * MwmSet::kMaxCacheSize; ++i)
+  {
+    mwmSet.ClearCache();
+    TEST(mwmSet.GetMwmHandleById(ids[i % ids.size()]).IsAlive(), ());
+  }
+  TEST_EQUAL(mwmSet.GetCacheCapacity(), 64, ());
+}
 }  // namespace mwm_set_test
@@ -38,7 +38,7 @@ void TestTable(vector<uint8_t> const & ranks, search::RankTable const & table)
 
 void TestTable(vector<uint8_t> const & ranks, string const & path)
 {
-  // Tries to load table via file read.
+  // Tries to load table via the section mapping.
   {
     FilesContainerR rcont(path);
     auto table = search::RankTable::Load(rcont, SEARCH_RANKS_FILE_TAG);
@@ -46,6 +46,25 @@ void TestTable(vector<uint8_t> const & ranks, string const & path)
     TestTable(ranks, *table);
   }
 
+  // Tries to load table right from the mapping of the container.
+  {
+    auto const defaultParams = FilesContainerR::GetAccessParams();
+    SCOPE_GUARD(restoreParams, [&defaultParams]() { FilesContainerR::SetAccessParams(defaultParams); });
+
+    FilesContainerR::AccessParams params;
+    params.m_mode = FilesContainerR::AccessMode::Mmap;
+    FilesContainerR::SetAccessParams(params);
+
+    unique_ptr<search::RankTable> table;
+    {
+      FilesContainerR rcont(path);
+      table = search::RankTable::Load(rcont, SEARCH_RANKS_FILE_TAG);
+    }
+    // The table keeps the mapping when the container is closed.
+    TEST(table, ());
+    TestTable(ranks, *table);
+  }
+
   // Tries to load table via file mapping.
   {
     FilesMappingContainer mcont(path);
@@ -2,9 +2,11 @@
 
 #include "indexer/classificator_loader.hpp"
 #include "indexer/data_source.hpp"
+#include "indexer/scales.hpp"
 
 #include "platform/local_country_file.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -35,3 +37,147 @@ UNIT_TEST(ReadFeatures_Smoke)
     ft1->ForEachType([](auto const /* t */) {});
   }
 }
+
+UNIT_TEST(ReadFeatures_Reuse)
+{
+  classificator::Load();
+
+  FrozenDataSource dataSource;
+  auto const [id, res] = dataSource.RegisterMap(platform::LocalCountryFile::MakeForTesting("minsk-pass"));
+  TEST_EQUAL(res, MwmSet::RegResult::Success, ());
+
+  auto const handle = dataSource.GetMwmHandleById(id);
+  auto const source = dataSource.CreateFeatureSource(handle);
+
+  FeatureType reused;
+  int const scale = scales::GetUpperScale();
+  for (uint32_t i = 0; i < source->GetNumFeatures(); ++i)
+  {
+    auto expected = source->GetOriginalFeature(i);
+    source->GetOriginalFeature(i, reused);
+    reused.Parse(FeatureType::FIELD_TYPES | FeatureType::FIELD_COMMON | FeatureType::FIELD_GEOMETRY, scale);
+
+    TEST_EQUAL(reused.GetID(), expected->GetID(), ());
+    TEST_EQUAL(reused.GetGeomType(), expected->GetGeomType(), ());
+    TEST_EQUAL(reused.GetLayer(), expected->GetLayer(), ());
+    TEST_EQUAL(reused.GetRank(), expected->GetRank(), ());
+    TEST_EQUAL(reused.GetHouseNumber(), expected->GetHouseNumber(), ());
+    // Names are decoded on demand after the rest of the common data.
+    TEST_EQUAL(reused.GetNames(), expected->GetNames(), ());
+
+    vector<uint32_t> expectedTypes, types;
+    expected->ForEachType([&](uint32_t t) { expectedTypes.push_back(t); });
+    reused.ForEachType([&](uint32_t t) { types.push_back(t); });
+    TEST_EQUAL(types, expectedTypes, ());
+
+    TEST_EQUAL(reused.GetLimitRect(scale), expected->GetLimitRect(scale), ());
+    TEST_EQUAL(reused.DebugString(), expected->DebugString(), ());
+  }
+}
+
+UNIT_TEST(ReadFeatures_Parallel)
+{
+  classificator::Load();
+
+  FrozenDataSource dataSource;
+  dataSource.RegisterMap(platform::LocalCountryFile::MakeForTesting("minsk-pass"));
+
+  int const scale = scales::GetUpperScale();
+  vector<uint32_t> expected;
+  dataSource.ForEachInScale([&](FeatureType & ft) { expected.push_back(ft.GetID().m_index); }, scale);
+  sort(expected.begin(), expected.end());
+  TEST(!expected.empty(), ());
+
+  size_t const kThreadsCount = 4;
+  vector<vector<uint32_t>> perThread(kThreadsCount);
+  dataSource.ForEachInScaleParallel([&](size_t threadIdx) -> DataSource::FeatureCallback {
+    return [&ids = perThread[threadIdx]](FeatureType & ft) { ids.push_back(ft.GetID().m_index); };
+  }, scale, kThreadsCount);
+
+  vector<uint32_t> actual;
+  for (auto const & ids : perThread)
+    actual.insert(actual.end(), ids.begin(), ids.end());
+  sort(actual.begin(), actual.end());
+
+  // Every feature is read exactly once.
+  TEST(adjacent_find(actual.begin(), actual.end()) == actual.end(), ());
+  TEST_EQUAL(actual, expected, ());
+}
+
+UNIT_TEST(ReadFeatures_Cache)
+{
+  classificator::Load();
+
+  FrozenDataSource dataSource;
+  auto const localFile = platform::LocalCountryFile::MakeForTesting("minsk-pass");
+  auto const [id, res] = dataSource.RegisterMap(localFile);
+  TEST_EQUAL(res, MwmSet::RegResult::Success, ());
+
+  dataSource.EnableFeatureCache(100 * 1024 * 1024 /* maxBytes */);
+  auto const & cache = *dataSource.GetFeatureCache();
+
+  auto const handle = dataSource.GetMwmHandleById(id);
+  auto const source = dataSource.CreateFeatureSource(handle);
+  size_t const numFeatures = source->GetNumFeatures();
+
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    FeaturesLoaderGuard const guard(dataSource, id);
+    for (uint32_t i = 0; i < numFeatures; ++i)
+    {
+      auto expected = source->GetOriginalFeature(i);
+      auto actual = guard.GetFeatureByIndex(i);
+      TEST(actual, (i));
+
+      TEST_EQUAL(actual->GetID(), expected->GetID(), ());
+      TEST_EQUAL(actual->GetGeomType(), expected->GetGeomType(), ());
+      TEST_EQUAL(actual->GetNames(), expected->GetNames(), ());
+      TEST_EQUAL(actual->GetHouseNumber(), expected->GetHouseNumber(), ());
+      TEST_EQUAL(actual->GetRank(), expected->GetRank(), ());
+      TEST_EQUAL(actual->GetLayer(), expected->GetLayer(), ());
+      TEST(actual->GetMetadata().Equals(expected->GetMetadata()), (i));
+
+      vector<uint32_t> expectedTypes, types;
+      expected->ForEachType([&](uint32_t t) { expectedTypes.push_back(t); });
+      actual->ForEachType([&](uint32_t t) { types.push_back(t); });
+      TEST_EQUAL(types, expectedTypes, ());
+
+      // The geometry of the requested scale is returned, see FeatureType::ResetGeometry().
+      for (int const scale :
+           {scales::GetUpperScale(), 10, 5, static_cast<int>(FeatureType::WORST_GEOMETRY)})
+      {
+        actual->ResetGeometry();
+        expected->ResetGeometry();
+        bool const isEmpty = expected->IsEmptyGeometry(scale);
+        TEST_EQUAL(actual->IsEmptyGeometry(scale), isEmpty, (i, scale));
+        if (!isEmpty)
+          TEST_EQUAL(actual->GetLimitRect(scale), expected->GetLimitRect(scale), (i, scale));
+      }
+
+      actual->ResetGeometry();
+      expected->ResetGeometry();
+      int const scale = FeatureType::BEST_GEOMETRY;
+      TEST_EQUAL(actual->GetLimitRect(scale), expected->GetLimitRect(scale), ());
+      TEST_EQUAL(actual->DebugString(), expected->DebugString(), ());
+    }
+  }
+
+  TEST_EQUAL(cache.GetNumFeatures(), numFeatures, ());
+  TEST_EQUAL(cache.GetNumMisses(), numFeatures, ());
+  TEST_EQUAL(cache.GetNumHits(), numFeatures, ());
+
+  // A small cache keeps only the recently used features.
+  dataSource.EnableFeatureCache(64 * 1024 /* maxBytes */);
+  {
+    FeaturesLoaderGuard const guard(dataSource, id);
+    for (uint32_t i = 0; i < numFeatures; ++i)
+      TEST(guard.GetFeatureByIndex(i), (i));
+  }
+  TEST_GREATER(dataSource.GetFeatureCache()->GetNumFeatures(), 0, ());
+  TEST_LESS(dataSource.GetFeatureCache()->GetNumFeatures(), numFeatures, ());
+
+  // Features of a deregistered mwm are dropped.
+  dataSource.GetFeatureCache()->OnMapDeregistered(localFile);
+  TEST_EQUAL(dataSource.GetFeatureCache()->GetNumFeatures(), 0, ());
+  TEST_EQUAL(dataSource.GetFeatureCache()->GetSizeBytes(), 0, ());
+}
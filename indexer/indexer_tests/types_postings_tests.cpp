@@ -0,0 +1,73 @@
+#include "testing/testing.hpp"
+
+#include "indexer/types_postings.hpp"
+
+#include "coding/memory_region.hpp"
+#include "coding/writer.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace types_postings_tests
+{
+using namespace search;
+using namespace std;
+
+vector<uint64_t> GetFeatures(coding::CompressedBitVector const & cbv)
+{
+  vector<uint64_t> features;
+  coding::CompressedBitVectorEnumerator::ForEach(
+      cbv, [&features](uint64_t bit) { features.push_back(bit); });
+  return features;
+}
+
+UNIT_TEST(TypesPostings_Smoke)
+{
+  TypesPostingsBuilder builder;
+  builder.Put(7 /* typeIndex */, 10 /* featureId */);
+  builder.Put(7, 3);
+  builder.Put(7, 10);
+  builder.Put(2, 5);
+  builder.Put(1000, 0);
+
+  vector<uint8_t> buffer;
+  {
+    MemWriter<vector<uint8_t>> writer(buffer);
+    // Postings must not depend on the position of the section in a file.
+    WriteToSink(writer, uint32_t(0xDEADBEEF));
+    builder.Freeze(writer);
+  }
+
+  TypesPostings postings(make_unique<CopiedMemoryRegion>(
+      vector<uint8_t>(buffer.begin() + sizeof(uint32_t), buffer.end())));
+
+  auto cbv = postings.Get(7);
+  TEST(cbv, ());
+  TEST_EQUAL(GetFeatures(*cbv), vector<uint64_t>({3, 10}), ());
+
+  cbv = postings.Get(2);
+  TEST(cbv, ());
+  TEST_EQUAL(GetFeatures(*cbv), vector<uint64_t>({5}), ());
+
+  cbv = postings.Get(1000);
+  TEST(cbv, ());
+  TEST_EQUAL(GetFeatures(*cbv), vector<uint64_t>({0}), ());
+
+  TEST(!postings.Get(0), ());
+  TEST(!postings.Get(3), ());
+  TEST(!postings.Get(1001), ());
+}
+
+UNIT_TEST(TypesPostings_Empty)
+{
+  vector<uint8_t> buffer;
+  {
+    MemWriter<vector<uint8_t>> writer(buffer);
+    TypesPostingsBuilder().Freeze(writer);
+  }
+
+  TypesPostings postings(make_unique<CopiedMemoryRegion>(std::move(buffer)));
+  TEST(!postings.Get(0), ());
+}
+}  // namespace types_postings_tests
@@ -7,7 +7,9 @@
 #include "base/assert.hpp"
 #include "base/buffer_vector.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <utility>
 
 class IntervalIndexBase
 {
@@ -71,7 +73,156 @@ public:
     }
   }
 
+  // Executes |f| on every (key, value) pair whose key belongs to one of |intervals|.
+  // |intervals| is a container of [beg, end) pairs, they are sorted and merged here.
+  // Unlike a ForEach() call per interval, all intervals are walked in one ordered pass:
+  // every node is read at most once and the descents to the common subtrees are shared.
+  // Pairs are reported in the order of keys.
+  template <typename F, typename Intervals>
+  void ForEachInIntervals(F const & f, Intervals const & intervals) const
+  {
+    if (m_Header.m_Levels == 0)
+      return;
+
+    buffer_vector<KeyRange, 64> ranges;
+    for (auto const & interval : intervals)
+    {
+      uint64_t const beg = std::min(static_cast<uint64_t>(interval.first), KeyEnd());
+      uint64_t const end = std::min(static_cast<uint64_t>(interval.second), KeyEnd());
+      if (beg < end)
+        ranges.push_back({beg, end - 1});  // Ranges are inclusive.
+    }
+    if (ranges.empty())
+      return;
+
+    std::sort(ranges.begin(), ranges.end());
+    size_t numMerged = 1;
+    for (size_t i = 1; i < ranges.size(); ++i)
+    {
+      auto & back = ranges[numMerged - 1];
+      // Adjacent ranges are merged too.
+      if (ranges[i].first <= back.second + 1)
+        back.second = std::max(back.second, ranges[i].second);
+      else
+        ranges[numMerged++] = ranges[i];
+    }
+    ranges.resize(numMerged);
+
+    ForEachNodeInRanges(f, ranges.data(), ranges.data() + ranges.size(), m_Header.m_Levels, 0,
+                        m_LevelOffsets[m_Header.m_Levels + 1] - m_LevelOffsets[m_Header.m_Levels],
+                        0 /* started keyBase */);
+  }
+
 private:
+  // Inclusive range of keys.
+  using KeyRange = std::pair<uint64_t, uint64_t>;
+
+  template <typename F>
+  void ForEachLeafInRanges(F const & f, KeyRange const * first, KeyRange const * last,
+                           uint32_t const offset, uint32_t const size, uint64_t keyBase) const
+  {
+    buffer_vector<uint8_t, 1024> data;
+    data.resize(size);
+
+    m_Reader.Read(offset, &data[0], size);
+    ArrayByteSource src(&data[0]);
+
+    void const * pEnd = &data[0] + size;
+    Value value = 0;
+    while (src.Ptr() < pEnd)
+    {
+      uint32_t key = 0;
+      src.Read(&key, m_Header.m_LeafBytes);
+      key = SwapIfBigEndianMacroBased(key);
+
+      uint64_t const fullKey = keyBase + key;
+      while (first != last && first->second < fullKey)
+        ++first;
+      if (first == last)
+        break;
+
+      value += ReadVarInt<int64_t>(src);
+      if (fullKey >= first->first)
+        f(fullKey, value);
+    }
+  }
+
+  // |first|, |last| are the sorted disjoint ranges intersecting the node, keys are absolute.
+  template <typename F>
+  void ForEachNodeInRanges(F const & f, KeyRange const * first, KeyRange const * last, int level,
+                           uint32_t offset, uint32_t size, uint64_t keyBase) const
+  {
+    ASSERT(size > 0, ());
+    ASSERT(first != last, ());
+    offset += m_LevelOffsets[level];
+
+    if (level == 0)
+    {
+      ForEachLeafInRanges(f, first, last, offset, size, keyBase);
+      return;
+    }
+
+    uint8_t const skipBits = (m_Header.m_LeafBytes << 3) + (level - 1) * m_Header.m_BitsPerLevel;
+    uint64_t const levelBytesFF = (1ULL << skipBits) - 1;
+
+    buffer_vector<uint8_t, 576> data;
+    data.resize(size);
+
+    m_Reader.Read(offset, &data[0], size);
+    ArrayByteSource src(&data[0]);
+
+    // Descends to the child |i| with the ranges intersecting it.
+    // Returns false when there are no ranges to the right of the child.
+    auto const processChild = [&](uint32_t i, uint32_t childOffset, uint32_t childSize) {
+      uint64_t const childBeg = keyBase + (uint64_t{i} << skipBits);
+      uint64_t const childEnd = childBeg + levelBytesFF;
+
+      while (first != last && first->second < childBeg)
+        ++first;
+      if (first == last)
+        return false;
+
+      auto childLast = first;
+      while (childLast != last && childLast->first <= childEnd)
+        ++childLast;
+      if (childLast != first)
+        ForEachNodeInRanges(f, first, childLast, level - 1, childOffset, childSize, childBeg);
+      return true;
+    };
+
+    uint32_t const offsetAndFlag = ReadVarUint<uint32_t>(src);
+    uint32_t childOffset = offsetAndFlag >> 1;
+    if (offsetAndFlag & 1)
+    {
+      // Reading bitmap.
+      uint8_t const * pBitmap = static_cast<uint8_t const *>(src.Ptr());
+      src.Advance(BitmapSize(m_Header.m_BitsPerLevel));
+      uint32_t const numChildren = 1U << m_Header.m_BitsPerLevel;
+      for (uint32_t i = 0; i < numChildren; ++i)
+      {
+        if (bits::GetBit(pBitmap, i))
+        {
+          uint32_t const childSize = ReadVarUint<uint32_t>(src);
+          if (!processChild(i, childOffset, childSize))
+            break;
+          childOffset += childSize;
+        }
+      }
+    }
+    else
+    {
+      void const * pEnd = &data[0] + size;
+      while (src.Ptr() < pEnd)
+      {
+        uint8_t const i = src.ReadByte();
+        uint32_t const childSize = ReadVarUint<uint32_t>(src);
+        if (!processChild(i, childOffset, childSize))
+          break;
+        childOffset += childSize;
+      }
+    }
+  }
+
   template <typename F>
   void ForEachLeaf(F const & f, uint64_t const beg, uint64_t const end,
       uint32_t const offset, uint32_t const size,
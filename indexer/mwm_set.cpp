@@ -3,6 +3,7 @@
 #include "indexer/features_offsets_table.hpp"
 #include "indexer/scales.hpp"
 
+#include "coding/files_container.hpp"
 #include "coding/reader.hpp"
 
 #include "platform/local_country_file_utils.hpp"
@@ -14,14 +15,23 @@
 
 #include <algorithm>
 #include <exception>
+#include <mutex>
 #include <sstream>
 
+#include "defines.hpp"
 
 using namespace std;
 using platform::CountryFile;
 using platform::LocalCountryFile;
 
-MwmInfo::MwmInfo() : m_minScale(0), m_maxScale(0), m_status(STATUS_DEREGISTERED), m_numRefs(0) {}
+MwmInfo::MwmInfo()
+  : m_minScale(0), m_maxScale(0), m_status(STATUS_DEREGISTERED), m_numRefs(0), m_lastUsed(0)
+{
+  for (auto & slot : m_cachedValues)
+    slot = nullptr;
+}
+
+MwmInfo::~MwmInfo() { UNUSED_VALUE(ClearCachedValues()); }
 
 MwmInfo::MwmTypeT MwmInfo::GetType() const
 {
@@ -33,6 +43,51 @@ MwmInfo::MwmTypeT MwmInfo::GetType() const
   return COASTS;
 }
 
+unique_ptr<MwmValue> MwmInfo::PopCachedValue()
+{
+  for (auto & slot : m_cachedValues)
+  {
+    if (slot.load(memory_order_relaxed) == nullptr)
+      continue;
+    if (MwmValue * value = slot.exchange(nullptr))
+      return unique_ptr<MwmValue>(value);
+  }
+  return nullptr;
+}
+
+bool MwmInfo::PushCachedValue(unique_ptr<MwmValue> & value)
+{
+  ASSERT(value, ());
+  for (auto & slot : m_cachedValues)
+  {
+    MwmValue * expected = nullptr;
+    if (slot.load(memory_order_relaxed) == nullptr && slot.compare_exchange_strong(expected, value.get()))
+    {
+      UNUSED_VALUE(value.release());
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MwmInfo::HasCachedValues() const
+{
+  return any_of(m_cachedValues.begin(), m_cachedValues.end(),
+                [](auto const & slot) { return slot.load(memory_order_relaxed) != nullptr; });
+}
+
+size_t MwmInfo::ClearCachedValues()
+{
+  size_t count = 0;
+  for (auto & slot : m_cachedValues)
+  {
+    unique_ptr<MwmValue> value(slot.exchange(nullptr));
+    if (value)
+      ++count;
+  }
+  return count;
+}
+
 bool MwmSet::MwmId::IsDeregistered(platform::LocalCountryFile const & deregisteredCountryFile) const
 {
   return m_info && m_info->GetStatus() == MwmInfo::STATUS_DEREGISTERED &&
@@ -85,6 +140,41 @@ MwmSet::MwmHandle & MwmSet::MwmHandle::operator=(MwmHandle && handle)
   return *this;
 }
 
+namespace
+{
+// The page advices of the mwm sections for FilesContainerR::AccessMode::Mmap.
+void SetMwmSectionAdvices()
+{
+  static std::once_flag flag;
+  std::call_once(flag, []()
+  {
+    using Advice = MmapReader::Advice;
+    // The geometry and the features are read at random, the small indexes are read entirely.
+    for (auto const * tag :
+         {GEOMETRY_FILE_TAG, TRIANGLE_FILE_TAG, FEATURES_FILE_TAG, SEARCH_INDEX_FILE_TAG})
+    {
+      FilesContainerR::SetSectionAdvice(tag, Advice::Random);
+    }
+    for (auto const * tag :
+         {INDEX_FILE_TAG, FEATURE_OFFSETS_FILE_TAG, HEADER_FILE_TAG, VERSION_FILE_TAG})
+    {
+      FilesContainerR::SetSectionAdvice(tag, Advice::WillNeed);
+    }
+  });
+}
+}  // namespace
+
+MwmSet::MwmSet(size_t cacheSize) : m_minCacheSize(cacheSize)
+{
+  SetMwmSectionAdvices();
+}
+
+MwmSet::~MwmSet()
+{
+  // Cached values must not outlive the set, while MwmInfo-s may be kept by MwmId-s.
+  ClearCache();
+}
+
 MwmSet::MwmId MwmSet::GetMwmIdByCountryFileImpl(CountryFile const & countryFile) const
 {
   string const & name = countryFile.GetName();
@@ -160,24 +250,28 @@ bool MwmSet::DeregisterImpl(MwmId const & id, EventList & events)
     return false;
 
   shared_ptr<MwmInfo> const & info = id.GetInfo();
-  if (info->m_numRefs == 0)
-  {
-    SetStatus(*info, MwmInfo::STATUS_DEREGISTERED, events);
-    vector<shared_ptr<MwmInfo>> & infos = m_info[info->GetCountryName()];
-    infos.erase(remove(infos.begin(), infos.end(), info), infos.end());
-    for (auto it = m_cache.begin(); it != m_cache.end(); ++it)
-    {
-      if (it->first == id)
-      {
-        m_cache.erase(it);
-        break;
-      }
-    }
-    return true;
-  }
 
+  // The status is marked before |m_numRefs| is checked, while TryLockCachedValue() increments
+  // |m_numRefs| before it checks the status. So either the mwm is not deregistered here,
+  // or the lock-free path sees the mark and does not take a value.
   SetStatus(*info, MwmInfo::STATUS_MARKED_TO_DEREGISTER, events);
-  return false;
+  if (info->m_numRefs != 0)
+    return false;
+
+  SetStatus(*info, MwmInfo::STATUS_DEREGISTERED, events);
+  vector<shared_ptr<MwmInfo>> & infos = m_info[info->GetCountryName()];
+  infos.erase(remove(infos.begin(), infos.end(), info), infos.end());
+  m_numCachedValues -= info->ClearCachedValues();
+  return true;
+}
+
+void MwmSet::DeregisterIfUnused(MwmId const & id, EventList & events)
+{
+  if (id.IsAlive() && id.GetInfo()->m_numRefs == 0 &&
+      id.GetInfo()->GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER)
+  {
+    UNUSED_VALUE(DeregisterImpl(id, events));
+  }
 }
 
 bool MwmSet::Deregister(CountryFile const & countryFile)
@@ -278,25 +372,36 @@ unique_ptr<MwmValue> MwmSet::LockValueImpl(MwmId const & id, EventList & events)
 
   ++info->m_numRefs;
 
-  // Search in cache.
-  for (auto it = m_cache.begin(); it != m_cache.end(); ++it)
+  if (auto value = info->PopCachedValue())
   {
-    if (it->first == id)
-    {
-      unique_ptr<MwmValue> result = std::move(it->second);
-      m_cache.erase(it);
-      return result;
-    }
+    --m_numCachedValues;
+    OnValueLocked();
+    return value;
   }
 
   try
   {
-    return CreateValue(*info);
+    auto value = CreateValue(*info);
+    // The cache shrunk on too many open files grows back by one value per opened mwm.
+    if (m_maxCacheSize < kMaxCacheSize)
+      ++m_maxCacheSize;
+    OnValueLocked();
+    return value;
   }
   catch (Reader::TooManyFilesException const & ex)
   {
     LOG(LERROR, ("Too many open files, can't open:", info->GetCountryName()));
     --info->m_numRefs;
+
+    // Cached values keep their files open, so the cache is shrunk.
+    auto const numCachedValues = m_numCachedValues.load();
+    if (numCachedValues > 0)
+    {
+      m_maxCacheSize = numCachedValues / 2;
+      while (m_numCachedValues > m_maxCacheSize && EvictCachedValue())
+        ;
+    }
+    DeregisterIfUnused(id, events);
     return nullptr;
   }
   catch (exception const & ex)
@@ -311,6 +416,17 @@ unique_ptr<MwmValue> MwmSet::LockValueImpl(MwmId const & id, EventList & events)
 
 void MwmSet::UnlockValue(MwmId const & id, unique_ptr<MwmValue> p)
 {
+  ASSERT(id.IsAlive(), (id));
+  ASSERT(p.get() != nullptr, ());
+  if (!id.IsAlive() || !p)
+    return;
+
+  --m_numLockedValues;
+  id.GetInfo()->m_lastUsed.store(++m_clock, memory_order_relaxed);
+
+  if (TryUnlockToCache(id, p))
+    return;
+
   WithEventLog([&](EventList & events)
                {
                  UnlockValueImpl(id, std::move(p), events);
@@ -319,43 +435,124 @@ void MwmSet::UnlockValue(MwmId const & id, unique_ptr<MwmValue> p)
 
 void MwmSet::UnlockValueImpl(MwmId const & id, unique_ptr<MwmValue> p, EventList & events)
 {
-  ASSERT(id.IsAlive(), (id));
-  ASSERT(p.get() != nullptr, ());
-  if (!id.IsAlive() || !p)
-    return;
-
   shared_ptr<MwmInfo> const & info = id.GetInfo();
+
+  // The value is cached before the reference is dropped, see DeregisterImpl().
+  if (info->IsUpToDate())
+  {
+    if (m_numCachedValues >= GetCacheCapacity())
+    {
+      LOG(LDEBUG, ("MwmValue max cache size reached! Added", id));
+      EvictCachedValue();
+    }
+
+    // The value is counted before it is published, see m_numCachedValues.
+    // All the slots of the mwm may be taken, then the value is destroyed.
+    ++m_numCachedValues;
+    if (!info->PushCachedValue(p))
+      --m_numCachedValues;
+  }
+
   ASSERT_GREATER(info->m_numRefs, 0, ());
   --info->m_numRefs;
-  if (info->m_numRefs == 0 && info->GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER)
-    VERIFY(DeregisterImpl(id, events), ());
+  DeregisterIfUnused(id, events);
+}
 
-  if (info->IsUpToDate())
+unique_ptr<MwmValue> MwmSet::TryLockCachedValue(MwmId const & id)
+{
+  if (!id.IsAlive())
+    return nullptr;
+
+  MwmInfo & info = *id.GetInfo();
+  ++info.m_numRefs;
+  if (info.IsUpToDate())
   {
-    /// @todo Probably, it's better to store only "unique by id" free caches here.
-    /// But it's no obvious if we have many threads working with the single mwm.
+    if (auto value = info.PopCachedValue())
+    {
+      --m_numCachedValues;
+      OnValueLocked();
+      return value;
+    }
+  }
+
+  ReleaseRef(id);
+  return nullptr;
+}
 
-    m_cache.push_back(make_pair(id, std::move(p)));
-    if (m_cache.size() > m_cacheSize)
+bool MwmSet::TryUnlockToCache(MwmId const & id, unique_ptr<MwmValue> & p)
+{
+  MwmInfo & info = *id.GetInfo();
+  if (!info.IsUpToDate())
+    return false;
+
+  // The capacity may be exceeded by a few values released at the same time, it's ok.
+  if (m_numCachedValues >= GetCacheCapacity())
+    return false;
+
+  // The value is counted before it is published, see m_numCachedValues.
+  ++m_numCachedValues;
+  if (!info.PushCachedValue(p))
+  {
+    --m_numCachedValues;
+    return false;
+  }
+
+  ReleaseRef(id);
+  return true;
+}
+
+void MwmSet::ReleaseRef(MwmId const & id)
+{
+  MwmInfo & info = *id.GetInfo();
+  ASSERT_GREATER(info.m_numRefs, 0, ());
+  if (--info.m_numRefs == 0 && info.GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER)
+    WithEventLog([&](EventList & events) { DeregisterIfUnused(id, events); });
+}
+
+void MwmSet::OnValueLocked()
+{
+  auto const numLocked = ++m_numLockedValues;
+  auto peak = m_peakLockedValues.load(memory_order_relaxed);
+  while (numLocked > peak && !m_peakLockedValues.compare_exchange_weak(peak, numLocked))
+    ;
+}
+
+size_t MwmSet::GetCacheCapacity() const
+{
+  return min(max(2 * m_peakLockedValues.load(memory_order_relaxed), m_minCacheSize),
+             m_maxCacheSize.load(memory_order_relaxed));
+}
+
+bool MwmSet::EvictCachedValue()
+{
+  MwmInfo * lru = nullptr;
+  for (auto const & p : m_info)
+  {
+    for (auto const & info : p.second)
     {
-      LOG(LDEBUG, ("MwmValue max cache size reached! Added", id, "removed", m_cache.front().first));
-      ASSERT_EQUAL(m_cache.size(), m_cacheSize + 1, ());
-      m_cache.pop_front();
+      if (info->HasCachedValues() && (!lru || info->m_lastUsed < lru->m_lastUsed))
+        lru = info.get();
     }
   }
+
+  if (!lru || !lru->PopCachedValue())
+    return false;
+
+  --m_numCachedValues;
+  return true;
 }
 
 void MwmSet::Clear()
 {
   lock_guard<mutex> lock(m_lock);
-  ClearCacheImpl(m_cache.begin(), m_cache.end());
+  ClearCacheImpl();
   m_info.clear();
 }
 
 void MwmSet::ClearCache()
 {
   lock_guard<mutex> lock(m_lock);
-  ClearCacheImpl(m_cache.begin(), m_cache.end());
+  ClearCacheImpl();
 }
 
 MwmSet::MwmId MwmSet::GetMwmIdByCountryFile(CountryFile const & countryFile) const
@@ -376,6 +573,9 @@ MwmSet::MwmHandle MwmSet::GetMwmHandleByCountryFile(CountryFile const & countryF
 
 MwmSet::MwmHandle MwmSet::GetMwmHandleById(MwmId const & id)
 {
+  if (auto value = TryLockCachedValue(id))
+    return MwmHandle(*this, id, std::move(value));
+
   MwmSet::MwmHandle handle;
   WithEventLog([&](EventList & events)
                {
@@ -392,15 +592,19 @@ MwmSet::MwmHandle MwmSet::GetMwmHandleByIdImpl(MwmId const & id, EventList & eve
   return MwmHandle(*this, id, std::move(value));
 }
 
-void MwmSet::ClearCacheImpl(Cache::iterator beg, Cache::iterator end) { m_cache.erase(beg, end); }
+void MwmSet::ClearCacheImpl()
+{
+  for (auto const & p : m_info)
+  {
+    for (auto const & info : p.second)
+      m_numCachedValues -= info->ClearCachedValues();
+  }
+}
 
 void MwmSet::ClearCache(MwmId const & id)
 {
-  auto sameId = [&id](pair<MwmSet::MwmId, unique_ptr<MwmValue>> const & p)
-  {
-    return (p.first == id);
-  };
-  ClearCacheImpl(base::RemoveIfKeepValid(m_cache.begin(), m_cache.end(), sameId), m_cache.end());
+  if (id.GetInfo())
+    m_numCachedValues -= id.GetInfo()->ClearCachedValues();
 }
 
 // MwmValue ----------------------------------------------------------------------------------------
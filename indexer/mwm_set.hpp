@@ -1,6 +1,7 @@
 #pragma once
 #include "indexer/data_factory.hpp"
 #include "indexer/house_to_street_iface.hpp"
+#include "indexer/types_postings.hpp"
 
 #include "platform/local_country_file.hpp"
 #include "platform/mwm_version.hpp"
@@ -12,8 +13,8 @@
 
 #include "defines.hpp"
 
+#include <array>
 #include <atomic>
-#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -23,6 +24,8 @@
 
 namespace feature { class FeaturesOffsetsTable; }
 
+class MwmValue;
+
 /// Information about stored mwm.
 class MwmInfo
 {
@@ -45,7 +48,7 @@ public:
   };
 
   MwmInfo();
-  virtual ~MwmInfo() = default;
+  virtual ~MwmInfo();
 
   /// @obsolete Rect around region border. Features which cross region border may cross this rect.
   /// @todo VNG: Not true. This rect accumulates all features in MWM. Since we don't crop features by border,
@@ -88,7 +91,26 @@ protected:
 
   platform::LocalCountryFile m_file;  ///< Path to the mwm file.
   std::atomic<Status> m_status;       ///< Current country status.
-  uint32_t m_numRefs;                 ///< Number of active handles.
+  std::atomic<uint32_t> m_numRefs;    ///< Number of active handles.
+
+private:
+  /// Max number of free values of one mwm cached by MwmSet.
+  static size_t constexpr kMaxCachedValues = 32;
+
+  /// @name Free values cache, it is used by MwmSet without locking.
+  /// A value belongs to the thread which has exchanged it out of the slot.
+  //@{
+  std::unique_ptr<MwmValue> PopCachedValue();
+  /// Returns false and keeps |value| when all the slots are taken.
+  bool PushCachedValue(std::unique_ptr<MwmValue> & value);
+  bool HasCachedValues() const;
+  /// Returns the number of removed values.
+  size_t ClearCachedValues();
+  //@}
+
+  std::array<std::atomic<MwmValue *>, kMaxCachedValues> m_cachedValues;
+  /// MwmSet clock value of the last handle release, for the cache eviction.
+  std::atomic<uint64_t> m_lastUsed;
 };
 
 class MwmInfoEx : public MwmInfo
@@ -108,8 +130,6 @@ private:
   std::weak_ptr<feature::FeaturesOffsetsTable> m_table;
 };
 
-class MwmValue;
-
 class MwmSet
 {
 public:
@@ -138,8 +158,12 @@ public:
   };
 
 public:
-  explicit MwmSet(size_t cacheSize = 64) : m_cacheSize(cacheSize) {}
-  virtual ~MwmSet() = default;
+  /// Max number of free values cached when the process runs out of file descriptors.
+  static size_t constexpr kMaxCacheSize = 256;
+
+  /// |cacheSize| is the min number of cached free values, see GetCacheCapacity().
+  explicit MwmSet(size_t cacheSize = 64);
+  virtual ~MwmSet();
 
   // Mwm handle, which is used to refer to mwm and prevent it from
   // deletion when its FileContainer is used.
@@ -295,10 +319,18 @@ public:
 
   void ClearCache();
 
+  /// The number of cached free values adapts to the load: it is twice the peak number
+  /// of simultaneously locked values, but not less than the min cache size passed
+  /// to the constructor. It is halved when there are too many open files and then grows
+  /// back by one value per successfully opened mwm.
+  size_t GetCacheCapacity() const;
+
   MwmId GetMwmIdByCountryFile(platform::CountryFile const & countryFile) const;
 
   MwmHandle GetMwmHandleByCountryFile(platform::CountryFile const & countryFile);
 
+  /// Takes a cached value of a registered mwm without locking, so the threads which
+  /// work with the same mwms do not contend. Falls back to the locked path otherwise.
   MwmHandle GetMwmHandleById(MwmId const & id);
 
   /// Now this function looks like workaround, but it allows to avoid ugly const_cast everywhere..
@@ -314,8 +346,6 @@ protected:
   virtual std::unique_ptr<MwmValue> CreateValue(MwmInfo & info) const = 0;
 
 private:
-  using Cache = std::deque<std::pair<MwmId, std::unique_ptr<MwmValue>>>;
-
   // This is the only valid way to take |m_lock| and use *Impl()
   // functions. The reason is that event processing requires
   // triggering of observers, but it's generally unsafe to call
@@ -348,12 +378,33 @@ private:
   void UnlockValue(MwmId const & id, std::unique_ptr<MwmValue> p);
   void UnlockValueImpl(MwmId const & id, std::unique_ptr<MwmValue> p, EventList & events);
 
-  /// Do the cleaning for [beg, end) without acquiring the mutex.
+  /// Lock-free fast paths of LockValue() and UnlockValue().
+  //@{
+  std::unique_ptr<MwmValue> TryLockCachedValue(MwmId const & id);
+  bool TryUnlockToCache(MwmId const & id, std::unique_ptr<MwmValue> & p);
+  /// Drops the reference of a handle and finishes the pending deregistration of the mwm.
+  void ReleaseRef(MwmId const & id);
+  //@}
+
+  void OnValueLocked();
+
+  /// @precondition This function is always called under mutex m_lock.
+  void DeregisterIfUnused(MwmId const & id, EventList & events);
+  /// Removes a cached value of the least recently used mwm.
+  /// Returns false when there are no cached values.
+  /// @precondition This function is always called under mutex m_lock.
+  bool EvictCachedValue();
   /// @precondition This function is always called under mutex m_lock.
-  void ClearCacheImpl(Cache::iterator beg, Cache::iterator end);
+  void ClearCacheImpl();
 
-  Cache m_cache;
-  size_t const m_cacheSize;
+  size_t const m_minCacheSize;
+  std::atomic<size_t> m_maxCacheSize = kMaxCacheSize;
+  /// Incremented before a value is published to the cache and decremented after a value
+  /// is taken from it, so it is never less than the number of cached values and never wraps.
+  std::atomic<size_t> m_numCachedValues = 0;
+  std::atomic<size_t> m_numLockedValues = 0;
+  std::atomic<size_t> m_peakLockedValues = 0;
+  std::atomic<uint64_t> m_clock = 0;
 
 protected:
   /// @precondition This function is always called under mutex m_lock.
@@ -381,6 +432,8 @@ public:
   std::shared_ptr<feature::FeaturesOffsetsTable> m_table;
   std::unique_ptr<indexer::MetadataDeserializer> m_metaDeserializer;
   std::unique_ptr<HouseToStreetTable> m_house2street, m_house2place;
+  std::unique_ptr<StreetToHousesTable> m_street2houses;
+  std::unique_ptr<search::TypesPostings> m_typesPostings;
 
   explicit MwmValue(platform::LocalCountryFile const & localFile);
   void SetTable(MwmInfoEx & info);
@@ -31,12 +31,22 @@ namespace
 size_t constexpr kVersionOffset = 0;
 size_t constexpr kHeaderSize = 8;
 
-unique_ptr<CopiedMemoryRegion> GetMemoryRegionForTag(FilesContainerR const & rcont,
-                                                     FilesContainerBase::Tag const & tag)
+unique_ptr<MemoryRegion> GetMemoryRegionForTag(FilesContainerR const & rcont,
+                                               FilesContainerBase::Tag const & tag)
 {
   if (!rcont.IsExist(tag))
     return {};
 
+  try
+  {
+    return make_unique<MappedSectionRegion>(rcont, tag);
+  }
+  catch (Reader::Exception const & e)
+  {
+    // E.g. the container is a part of another file which can't be mapped.
+    LOG(LDEBUG, ("Can't map", tag, "of", rcont.GetFileName(), e.Msg()));
+  }
+
   FilesContainerR::TReader reader = rcont.GetReader(tag);
   vector<uint8_t> buffer(static_cast<size_t>(reader.Size()));
   reader.Read(0, buffer.data(), buffer.size());
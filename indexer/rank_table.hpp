@@ -61,9 +61,10 @@ public:
   // Serializes rank table.
   virtual void Serialize(Writer & writer) = 0;
 
-  // Copies whole section corresponding to a rank table and
-  // deserializes it. Returns nullptr if there're no ranks section or
-  // rank table's header is damaged.
+  // Maps whole section corresponding to a rank table and deserializes
+  // it, the ranks are queried right from the mapping. The section is
+  // copied only when it can't be mapped. Returns nullptr if there're no
+  // ranks section or rank table's header is damaged.
   //
   // *NOTE* Return value can outlive |rcont|. Also note that there is
   // undefined behaviour if ranks section exists but internally
@@ -63,6 +63,21 @@ public:
     }
   }
 
+  // Same as ForEachInIntervalAndScale() for each of |intervals| (which are [beg, end) pairs)
+  // but every node of the index is read once, see IntervalIndex::ForEachInIntervals().
+  // A value may still be reported several times if it is stored under several keys.
+  template <typename Intervals>
+  void ForEachInIntervalsAndScale(Intervals const & intervals, int scale,
+                                  std::function<void(uint64_t, uint32_t)> const & fn) const
+  {
+    auto const scaleBucket = BucketByScale(scale);
+    if (scaleBucket < m_IndexForScale.size())
+    {
+      for (size_t i = 0; i <= scaleBucket; ++i)
+        m_IndexForScale[i]->ForEachInIntervals(fn, intervals);
+    }
+  }
+
 private:
   std::vector<std::unique_ptr<IntervalIndex<Reader, uint32_t>>> m_IndexForScale;
 };
@@ -0,0 +1,142 @@
+#include "indexer/types_postings.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/files_container.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "defines.hpp"
+
+namespace search
+{
+using namespace std;
+
+namespace
+{
+// Maps the section when the mwm is a plain file. Mwms which can't be mapped,
+// e.g. the ones inside the application package, are read to memory.
+unique_ptr<MemoryRegion> GetMemoryRegion(MwmValue const & value)
+{
+  auto const path = value.m_file.GetPath(MapFileType::Map);
+  if (GetPlatform().IsFileExistsByFullPath(path))
+  {
+    // The mapping outlives the container, only the file descriptor is closed.
+    FilesMappingContainer const mcont(path);
+    return make_unique<MappedMemoryRegion>(mcont.Map(TYPES_POSTINGS_FILE_TAG));
+  }
+
+  auto const reader = value.m_cont.GetReader(TYPES_POSTINGS_FILE_TAG);
+  vector<uint8_t> buffer(static_cast<size_t>(reader.Size()));
+  reader.Read(0, buffer.data(), buffer.size());
+  return make_unique<CopiedMemoryRegion>(std::move(buffer));
+}
+}  // namespace
+
+// TypesPostings -----------------------------------------------------------------------------------
+TypesPostings::TypesPostings(unique_ptr<MemoryRegion> && region) : m_region(std::move(region))
+{
+  CHECK(m_region, ());
+
+  MemReader reader(m_region->ImmutableData(), m_region->Size());
+  NonOwningReaderSource source(reader);
+  Header header;
+  header.Read(source);
+  CHECK_EQUAL(static_cast<uint8_t>(header.m_version), static_cast<uint8_t>(Version::V0), ());
+
+  source.SetPosition(header.m_directoryOffset);
+  m_types.resize(header.m_numTypes);
+  m_offsets.resize(header.m_numTypes + 1);
+  for (uint32_t i = 0; i < header.m_numTypes; ++i)
+  {
+    m_types[i] = ReadPrimitiveFromSource<uint32_t>(source);
+    m_offsets[i] = ReadPrimitiveFromSource<uint32_t>(source);
+  }
+  m_offsets.back() = ReadPrimitiveFromSource<uint32_t>(source);
+
+  ASSERT(is_sorted(m_types.begin(), m_types.end()), ());
+  ASSERT(is_sorted(m_offsets.begin(), m_offsets.end()), ());
+}
+
+// static
+unique_ptr<TypesPostings> TypesPostings::Load(MwmValue const & value)
+{
+  if (!value.m_cont.IsExist(TYPES_POSTINGS_FILE_TAG))
+    return {};
+
+  try
+  {
+    return make_unique<TypesPostings>(GetMemoryRegion(value));
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LERROR, ("Can't load", TYPES_POSTINGS_FILE_TAG, "section:", e.Msg()));
+  }
+  return {};
+}
+
+unique_ptr<coding::CompressedBitVector> TypesPostings::Get(uint32_t typeIndex) const
+{
+  auto const it = lower_bound(m_types.begin(), m_types.end(), typeIndex);
+  if (it == m_types.end() || *it != typeIndex)
+    return {};
+
+  auto const i = static_cast<size_t>(distance(m_types.begin(), it));
+  CHECK_LESS_OR_EQUAL(m_offsets[i + 1], m_region->Size(), ());
+  MemReader reader(m_region->ImmutableData() + m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+  return coding::CompressedBitVectorBuilder::DeserializeFromReader(reader);
+}
+
+// TypesPostingsBuilder ----------------------------------------------------------------------------
+void TypesPostingsBuilder::Put(uint32_t typeIndex, uint32_t featureId)
+{
+  m_postings[typeIndex].push_back(featureId);
+}
+
+void TypesPostingsBuilder::Freeze(Writer & writer) const
+{
+  auto const startOffset = writer.Pos();
+
+  TypesPostings::Header header;
+  header.m_numTypes = base::checked_cast<uint32_t>(m_postings.size());
+  header.Serialize(writer);
+
+  vector<uint32_t> offsets;
+  offsets.reserve(m_postings.size() + 1);
+  {
+    // Postings are written before the directory since their sizes are unknown in advance.
+    for (auto const & [type, features] : m_postings)
+    {
+      offsets.push_back(base::checked_cast<uint32_t>(writer.Pos() - startOffset));
+
+      auto sorted = features;
+      sort(sorted.begin(), sorted.end());
+      sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+      coding::CompressedBitVectorBuilder::FromBitPositions(std::move(sorted))->Serialize(writer);
+    }
+    offsets.push_back(base::checked_cast<uint32_t>(writer.Pos() - startOffset));
+  }
+
+  header.m_directoryOffset = base::checked_cast<uint32_t>(writer.Pos() - startOffset);
+  size_t i = 0;
+  for (auto const & kv : m_postings)
+  {
+    WriteToSink(writer, kv.first);
+    WriteToSink(writer, offsets[i++]);
+  }
+  WriteToSink(writer, offsets.back());
+
+  auto const endOffset = writer.Pos();
+  writer.Seek(startOffset);
+  header.Serialize(writer);
+  writer.Seek(endOffset);
+}
+}  // namespace search
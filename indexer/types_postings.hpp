@@ -0,0 +1,87 @@
+#pragma once
+
+#include "coding/compressed_bit_vector.hpp"
+#include "coding/memory_region.hpp"
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+class MwmValue;
+class Writer;
+
+namespace search
+{
+// Precomputed postings: classificator type index -> features of an mwm which
+// have this type in the categories branch of the search index.
+//
+// Format:
+// Header
+// Directory: m_numTypes entries {type index (4 bytes), postings offset (4 bytes)}
+//            sorted by type index, plus one sentinel offset of the postings end.
+// Postings:  serialized coding::CompressedBitVector per type.
+//
+// All offsets are relative to the start of the section.
+//
+// The section is mapped to memory once per MwmValue, the header and the directory
+// are read on loading and the postings are decoded from the mapped memory.
+class TypesPostings
+{
+public:
+  enum class Version : uint8_t
+  {
+    V0 = 0,
+    Latest = V0
+  };
+
+  struct Header
+  {
+    template <typename Sink>
+    void Serialize(Sink & sink) const
+    {
+      WriteToSink(sink, static_cast<uint8_t>(m_version));
+      WriteToSink(sink, m_numTypes);
+      WriteToSink(sink, m_directoryOffset);
+    }
+
+    template <typename Source>
+    void Read(Source & source)
+    {
+      m_version = static_cast<Version>(ReadPrimitiveFromSource<uint8_t>(source));
+      m_numTypes = ReadPrimitiveFromSource<uint32_t>(source);
+      m_directoryOffset = ReadPrimitiveFromSource<uint32_t>(source);
+    }
+
+    Version m_version = Version::Latest;
+    uint32_t m_numTypes = 0;
+    uint32_t m_directoryOffset = 0;
+  };
+
+  explicit TypesPostings(std::unique_ptr<MemoryRegion> && region);
+
+  // Returns nullptr when the mwm has no TYPES_POSTINGS_FILE_TAG section.
+  static std::unique_ptr<TypesPostings> Load(MwmValue const & value);
+
+  // Returns features having the type with |typeIndex|, nullptr if there are no such features.
+  std::unique_ptr<coding::CompressedBitVector> Get(uint32_t typeIndex) const;
+
+private:
+  std::unique_ptr<MemoryRegion> m_region;
+  std::vector<uint32_t> m_types;
+  // m_types.size() + 1 offsets, the last one is the end of the postings.
+  std::vector<uint32_t> m_offsets;
+};
+
+class TypesPostingsBuilder
+{
+public:
+  void Put(uint32_t typeIndex, uint32_t featureId);
+  void Freeze(Writer & writer) const;
+
+private:
+  std::map<uint32_t, std::vector<uint64_t>> m_postings;
+};
+}  // namespace search
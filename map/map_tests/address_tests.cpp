@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace address_tests
 {
@@ -104,4 +105,40 @@ UNIT_TEST(ReverseGeocoder_Smoke)
     TestAddress(coder, mwmInfo, {53.89745, 27.55835}, streetNames, "18А");
   }
 }
+
+UNIT_TEST(ReverseGeocoder_Batch)
+{
+  classificator::Load();
+
+  FrozenDataSource dataSource;
+  auto const regResult = dataSource.RegisterMap(LocalCountryFile::MakeForTesting("minsk-pass"));
+  TEST_EQUAL(regResult.second, MwmSet::RegResult::Success, ());
+
+  ReverseGeocoder coder(dataSource);
+
+  std::vector<m2::PointD> points;
+  for (ms::LatLon const ll : {ms::LatLon(53.89815, 27.54265), ms::LatLon(53.8997617, 27.5429365),
+                              ms::LatLon(53.89666, 27.54904), ms::LatLon(53.89724, 27.54983),
+                              ms::LatLon(53.89745, 27.55835), ms::LatLon(0.0, 0.0)})
+  {
+    points.push_back(mercator::FromLatLon(ll));
+  }
+
+  for (size_t threadsCount : {1, 4})
+  {
+    std::vector<ReverseGeocoder::Address> addrs;
+    coder.GetNearbyAddresses(points, ReverseGeocoder::kLookupRadiusM, addrs, threadsCount);
+    TEST_EQUAL(addrs.size(), points.size(), ());
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      ReverseGeocoder::Address expected;
+      coder.GetNearbyAddress(points[i], expected);
+
+      TEST_EQUAL(addrs[i].IsValid(), expected.IsValid(), (i));
+      TEST_EQUAL(addrs[i].GetStreetName(), expected.GetStreetName(), (i));
+      TEST_EQUAL(addrs[i].GetHouseNumber(), expected.GetHouseNumber(), (i));
+    }
+  }
+}
 } // namespace address_tests
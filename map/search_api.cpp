@@ -8,11 +8,13 @@
 
 #include "storage/downloader_search_params.hpp"
 
+#include "platform/platform.hpp"
 #include "platform/preferred_languages.hpp"
 
 #include "geometry/mercator.hpp"
 
 #include "base/checked_cast.hpp"
+#include "base/file_name_utils.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -136,6 +138,15 @@ private:
   SearchAPI::Delegate & m_delegate;
   OnResults m_onResults;
 };
+
+Engine::Params MakeEngineParams(size_t numThreads)
+{
+  Engine::Params params(languages::GetCurrentTwine() /* locale */, numThreads);
+  // Users import hundreds of thousands of bookmarks, so the index is kept on disk
+  // and only the changed bookmarks are re-indexed on start.
+  params.m_bookmarksIndexDir = base::JoinPath(GetPlatform().WritableDir(), "bookmarks_index");
+  return params;
+}
 }  // namespace
 
 SearchAPI::SearchAPI(DataSource & dataSource, storage::Storage const & storage,
@@ -146,7 +157,7 @@ SearchAPI::SearchAPI(DataSource & dataSource, storage::Storage const & storage,
   , m_infoGetter(infoGetter)
   , m_delegate(delegate)
   , m_engine(m_dataSource, GetDefaultCategories(), m_infoGetter,
-             Engine::Params(languages::GetCurrentTwine() /* locale */, numThreads))
+             MakeEngineParams(numThreads))
 {
 }
 
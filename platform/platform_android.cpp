@@ -4,6 +4,7 @@
 #include "platform/platform_unix_impl.hpp"
 #include "platform/settings.hpp"
 
+#include "coding/files_container.hpp"
 #include "coding/zip_reader.hpp"
 
 #include "base/file_name_utils.hpp"
@@ -56,6 +57,13 @@ unique_ptr<ModelReader> Platform::GetReader(string const & file, string searchSc
   uint32_t const logPageSize = (ext == DATA_FILE_EXTENSION) ? READER_CHUNK_LOG_SIZE : 10;
   uint32_t const logPageCount = (ext == DATA_FILE_EXTENSION) ? READER_CHUNK_LOG_COUNT : 4;
 
+  // Mwms on the file system are read according to the FilesContainerR access params.
+  auto const createFileReader = [&](string const & path) -> unique_ptr<ModelReader> {
+    if (ext == DATA_FILE_EXTENSION)
+      return FilesContainerR::CreateFileReader(path, logPageSize, logPageCount);
+    return make_unique<FileReader>(path, logPageSize, logPageCount);
+  };
+
   if (searchScope.empty())
   {
     if (file[0] == '/')
@@ -94,7 +102,7 @@ unique_ptr<ModelReader> Platform::GetReader(string const & file, string searchSc
     {
       string const path = base::JoinPath(m_writableDir, file);
       if (IsFileExistsByFullPath(path))
-        return make_unique<FileReader>(path, logPageSize, logPageCount);
+        return createFileReader(path);
       break;
     }
 
@@ -108,7 +116,7 @@ unique_ptr<ModelReader> Platform::GetReader(string const & file, string searchSc
 
     case 'f':
       if (IsFileExistsByFullPath(file))
-        return make_unique<FileReader>(file, logPageSize, logPageCount);
+        return createFileReader(file);
       break;
 
     case 'r':
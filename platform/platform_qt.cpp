@@ -4,7 +4,9 @@
 #include "platform/settings.hpp"
 
 #include "coding/file_reader.hpp"
+#include "coding/files_container.hpp"
 
+#include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
 
 #include <future>
@@ -17,8 +19,11 @@
 
 std::unique_ptr<ModelReader> Platform::GetReader(std::string const & file, std::string searchScope) const
 {
-  return std::make_unique<FileReader>(ReadPathForFile(file, std::move(searchScope)),
-                                 READER_CHUNK_LOG_SIZE, READER_CHUNK_LOG_COUNT);
+  auto const path = ReadPathForFile(file, std::move(searchScope));
+  // Mwms are read according to the FilesContainerR access params.
+  if (base::GetFileExtension(path) == DATA_FILE_EXTENSION)
+    return FilesContainerR::CreateFileReader(path, READER_CHUNK_LOG_SIZE, READER_CHUNK_LOG_COUNT);
+  return std::make_unique<FileReader>(path, READER_CHUNK_LOG_SIZE, READER_CHUNK_LOG_COUNT);
 }
 
 bool Platform::GetFileSizeByName(std::string const & fileName, uint64_t & size) const
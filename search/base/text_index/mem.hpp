@@ -47,6 +47,16 @@ public:
     ForEachPosting(strings::ToUtf8(token), std::forward<Fn>(fn));
   }
 
+  // Executes |fn| on every token in the lexicographical order.
+  template <typename Fn>
+  void ForEachToken(Fn && fn) const
+  {
+    for (auto const & entry : m_postingsByToken)
+      fn(entry.first);
+  }
+
+  bool Empty() const { return m_postingsByToken.empty(); }
+
   template <typename Sink>
   void Serialize(Sink & sink)
   {
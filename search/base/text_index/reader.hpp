@@ -11,6 +11,7 @@
 #include "base/string_utils.hpp"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -21,20 +22,28 @@ namespace search_base
 class TextIndexReader
 {
 public:
-  explicit TextIndexReader(FileReader const & fileReader) : m_fileReader(fileReader)
+  explicit TextIndexReader(FileReader const & fileReader)
+    : TextIndexReader(std::make_unique<FileReader>(fileReader))
   {
-    ReaderSource<FileReader> headerSource(m_fileReader);
+  }
+
+  // |reader| may be e.g. an MmapReader to keep the postings in the page cache
+  // instead of reading them through a file handle on every request.
+  explicit TextIndexReader(std::unique_ptr<Reader> && reader) : m_reader(std::move(reader))
+  {
+    ReaderSource<ReaderPtr<Reader>> headerSource(m_reader);
     TextIndexHeader header;
     header.Deserialize(headerSource);
 
     uint64_t const dictStart = header.m_dictPositionsOffset;
     uint64_t const dictEnd = header.m_postingsStartsOffset;
-    ReaderSource<FileReader> dictSource(m_fileReader.SubReader(dictStart, dictEnd - dictStart));
+    ReaderSource<ReaderPtr<Reader>> dictSource(m_reader.SubReader(dictStart, dictEnd - dictStart));
     m_dictionary.Deserialize(dictSource, header);
 
     uint64_t const postStart = header.m_postingsStartsOffset;
     uint64_t const postEnd = header.m_postingsListsOffset;
-    ReaderSource<FileReader> postingsSource(m_fileReader.SubReader(postStart, postEnd - postStart));
+    ReaderSource<ReaderPtr<Reader>> postingsSource(
+        m_reader.SubReader(postStart, postEnd - postStart));
     m_postingsStarts.resize(header.m_numTokens + 1);
     for (uint32_t & start : m_postingsStarts)
       start = ReadPrimitiveFromSource<uint32_t>(postingsSource);
@@ -50,7 +59,7 @@ public:
       return;
     CHECK_LESS(tokenId + 1, m_postingsStarts.size(), ());
 
-    ReaderSource<FileReader> source(m_fileReader.SubReader(
+    ReaderSource<ReaderPtr<Reader>> source(m_reader.SubReader(
         m_postingsStarts[tokenId], m_postingsStarts[tokenId + 1] - m_postingsStarts[tokenId]));
 
     uint32_t last = 0;
@@ -71,7 +80,7 @@ public:
   TextIndexDictionary const & GetDictionary() const { return m_dictionary; }
 
 private:
-  FileReader m_fileReader;
+  ReaderPtr<Reader> m_reader;
   TextIndexDictionary m_dictionary;
   std::vector<uint32_t> m_postingsStarts;
 };
@@ -0,0 +1,636 @@
+#include "search/bookmarks/disk_index.hpp"
+
+#include "search/base/text_index/dictionary.hpp"
+#include "search/base/text_index/header.hpp"
+#include "search/base/text_index/postings.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+#include "base/exception.hpp"
+#include "base/file_name_utils.hpp"
+#include "base/logging.hpp"
+#include "base/stl_helpers.hpp"
+#include "base/string_utils.hpp"
+
+#include <chrono>
+#include <limits>
+#include <utility>
+
+#include "defines.hpp"
+
+namespace search
+{
+namespace bookmarks
+{
+using namespace std;
+
+namespace
+{
+// Slots file layout:
+//   version (1 byte)
+//   generation of the base segment (4 bytes)
+//   number of slots (4 bytes)
+//   {doc id (8 bytes), tokens hash (8 bytes), doc offset (8 bytes),
+//    is the latest slot of the doc (1 byte)} per slot
+//
+// The base segment files are bookmarks.<generation>.index and bookmarks.<generation>.docs.
+// The slots file is replaced after the segment files are written, so it always
+// refers to a complete generation.
+uint8_t constexpr kSlotsVersion = 1;
+
+char const kSlotsFile[] = "bookmarks.slots";
+char const kFilePrefix[] = "bookmarks.";
+char const kIndexExt[] = ".index";
+char const kDocsExt[] = ".docs";
+
+search_base::Posting constexpr kDroppedPosting = numeric_limits<search_base::Posting>::max();
+
+DECLARE_EXCEPTION(DiskIndexException, RootException);
+
+// FNV-1a of the doc tokens. It is stored on disk, so std::hash is not an option.
+uint64_t HashTokens(DocVec const & docVec)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  auto const add = [&hash](uint8_t byte) {
+    hash ^= byte;
+    hash *= 1099511628211ULL;
+  };
+
+  for (size_t i = 0; i < docVec.GetNumTokens(); ++i)
+  {
+    for (char const c : strings::ToUtf8(docVec.GetToken(i)))
+      add(static_cast<uint8_t>(c));
+    add(0);
+  }
+  return hash;
+}
+
+string GetSegmentPath(string const & dir, uint32_t generation, char const * ext)
+{
+  return base::JoinPath(dir, kFilePrefix + strings::to_string(generation) + ext);
+}
+
+// Fetches the precomputed postings of the tokens which have any.
+class CompactedPostingsFetcher : public search_base::PostingsFetcher
+{
+public:
+  using GetPostingsFn =
+      function<void(search_base::Token const & token, vector<search_base::Posting> & postings)>;
+
+  CompactedPostingsFetcher(vector<search_base::Token> const & tokens,
+                           GetPostingsFn const & getPostings)
+    : m_tokens(tokens), m_getPostings(getPostings)
+  {
+    ReadPostings();
+  }
+
+  // PostingsFetcher overrides:
+  bool IsValid() const override { return m_tokenId < m_tokens.size(); }
+
+  void Advance() override
+  {
+    if (!IsValid())
+      return;
+
+    ++m_tokenId;
+    ReadPostings();
+  }
+
+  void ForEachPosting(Fn const & fn) const override
+  {
+    CHECK(IsValid(), ());
+    for (auto const p : m_postings)
+      fn(p);
+  }
+
+private:
+  void ReadPostings()
+  {
+    m_postings.clear();
+    if (IsValid())
+      m_getPostings(m_tokens[m_tokenId], m_postings);
+  }
+
+  vector<search_base::Token> const & m_tokens;
+  GetPostingsFn const & m_getPostings;
+  size_t m_tokenId = 0;
+  vector<search_base::Posting> m_postings;
+};
+}  // namespace
+
+// DiskIndex::SegmentFiles -------------------------------------------------------------------------
+DiskIndex::SegmentFiles::~SegmentFiles()
+{
+  if (!m_obsolete)
+    return;
+  base::DeleteFileX(m_indexPath);
+  base::DeleteFileX(m_docsPath);
+}
+
+// DiskIndex::Segment ------------------------------------------------------------------------------
+DiskIndex::Segment::Segment(string const & dir, uint32_t generation)
+  : m_files{GetSegmentPath(dir, generation, kIndexExt), GetSegmentPath(dir, generation, kDocsExt)}
+  , m_index(make_unique<MmapReader>(m_files.m_indexPath, MmapReader::Advice::Random))
+  , m_docs(m_files.m_docsPath, MmapReader::Advice::Random)
+{
+  auto const & tokens = m_index.GetDictionary().GetTokens();
+  m_tokens.reserve(tokens.size());
+  for (auto const & token : tokens)
+    m_tokens.push_back(strings::MakeUniString(token));
+}
+
+// DiskIndex ---------------------------------------------------------------------------------------
+DiskIndex::DiskIndex(string const & dir) : m_dir(dir), m_pool(1 /* threadCount */)
+{
+  if (!Platform::MkDirRecursively(m_dir))
+    LOG(LWARNING, ("Can't create bookmarks index dir", m_dir));
+
+  Load();
+}
+
+DiskIndex::~DiskIndex() { WaitForMerge(); }
+
+void DiskIndex::Put(Id const & id, DocVec const & docVec)
+{
+  lock_guard<mutex> lock(m_mutex);
+  TryFinishMerge();
+
+  auto const hash = HashTokens(docVec);
+  auto const it = m_idToSlot.find(id);
+  if (it != m_idToSlot.end())
+  {
+    auto & slot = m_slots[it->second];
+    if (slot.m_hash == hash)
+      return;
+    slot.m_searchable = false;
+  }
+
+  auto const posting = base::checked_cast<search_base::Posting>(m_slots.size());
+  CHECK_NOT_EQUAL(posting, kDroppedPosting, ());
+  m_slots.push_back({id, hash, 0 /* docOffset */, false /* searchable */});
+  m_idToSlot[id] = posting;
+
+  for (size_t i = 0; i < docVec.GetNumTokens(); ++i)
+    m_delta.AddPosting(strings::ToUtf8(docVec.GetToken(i)), posting);
+  m_deltaDocs.push_back(docVec);
+  // The doc itself counts too, so that the docs without tokens are merged as well.
+  m_deltaSize += docVec.GetNumTokens() + 1;
+
+  if (m_deltaSize >= kMaxDeltaSize)
+    StartMerge();
+}
+
+void DiskIndex::SetSearchable(Id const & id, bool searchable)
+{
+  lock_guard<mutex> lock(m_mutex);
+  auto const it = m_idToSlot.find(id);
+  if (it != m_idToSlot.end())
+    m_slots[it->second].m_searchable = searchable;
+}
+
+void DiskIndex::Forget(Id const & id)
+{
+  lock_guard<mutex> lock(m_mutex);
+  auto const it = m_idToSlot.find(id);
+  if (it == m_idToSlot.end())
+    return;
+  m_slots[it->second].m_searchable = false;
+  m_idToSlot.erase(it);
+}
+
+void DiskIndex::Reset()
+{
+  lock_guard<mutex> lock(m_mutex);
+  for (auto & slot : m_slots)
+    slot.m_searchable = false;
+}
+
+void DiskIndex::Flush()
+{
+  lock_guard<mutex> lock(m_mutex);
+  TryFinishMerge();
+  StartMerge();
+}
+
+void DiskIndex::WaitForMerge()
+{
+  shared_future<MergeResult> merge;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    merge = m_merge;
+  }
+
+  if (!merge.valid())
+    return;
+  // The index stays available while the merge is running.
+  merge.wait();
+
+  lock_guard<mutex> lock(m_mutex);
+  TryFinishMerge();
+}
+
+bool DiskIndex::GetDocVec(Id const & id, DocVec & docVec) const
+{
+  lock_guard<mutex> lock(m_mutex);
+  auto const it = m_idToSlot.find(id);
+  if (it == m_idToSlot.end())
+    return false;
+
+  auto const slot = it->second;
+  if (slot < m_numBaseSlots)
+  {
+    CHECK(m_base, ());
+    NonOwningReaderSource source(m_base->m_docs, m_slots[slot].m_docOffset, m_base->m_docs.Size());
+    docVec.Deserialize(source);
+  }
+  else if (slot < m_numFrozenSlots)
+  {
+    CHECK(m_frozen, ());
+    docVec = m_frozen->m_docs[slot - m_numBaseSlots];
+  }
+  else
+  {
+    docVec = m_deltaDocs[slot - m_numFrozenSlots];
+  }
+  return true;
+}
+
+uint64_t DiskIndex::GetNumDocs(strings::UniString const & token, bool isPrefix) const
+{
+  lock_guard<mutex> lock(m_mutex);
+
+  auto const utf8 = strings::ToUtf8(token);
+  auto const matches = [&](search_base::Token const & t) {
+    return isPrefix ? t.starts_with(utf8) : t == utf8;
+  };
+
+  vector<search_base::Posting> postings;
+  auto const collect = [&](search_base::Posting const posting) {
+    if (IsSearchable(posting))
+      postings.push_back(posting);
+  };
+
+  if (m_base)
+  {
+    auto const & tokens = m_base->m_index.GetDictionary().GetTokens();
+    for (auto it = lower_bound(tokens.begin(), tokens.end(), utf8);
+         it != tokens.end() && matches(*it); ++it)
+    {
+      m_base->m_index.ForEachPosting(*it, collect);
+    }
+  }
+
+  search_base::MemTextIndex const * const memIndexes[] = {
+      m_frozen ? &m_frozen->m_index : nullptr, &m_delta};
+  for (auto const * index : memIndexes)
+  {
+    if (index == nullptr)
+      continue;
+    index->ForEachToken([&](search_base::Token const & t) {
+      if (matches(t))
+        index->ForEachPosting(t, collect);
+    });
+  }
+
+  // Only the latest slot of a doc is searchable, so unique slots are unique docs.
+  base::SortUnique(postings);
+  return postings.size();
+}
+
+size_t DiskIndex::GetNumSlots() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_slots.size();
+}
+
+size_t DiskIndex::GetDeltaSize() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_deltaSize;
+}
+
+bool DiskIndex::IsMerging() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_merge.valid();
+}
+
+// static
+DiskIndex::MergeResult DiskIndex::Merge(MergeTask && task)
+{
+  MergeResult result;
+  result.m_generation = task.m_generation;
+  if (task.m_liveSlots.empty())
+    return result;
+
+  auto const & base = task.m_base;
+  auto const & frozen = task.m_frozen;
+  auto const numBaseSlots = task.m_baseDocOffsets.size();
+  auto const numSlots = numBaseSlots + (frozen ? frozen->m_docs.size() : 0);
+
+  vector<search_base::Posting> newPostings(numSlots, kDroppedPosting);
+  for (size_t i = 0; i < task.m_liveSlots.size(); ++i)
+    newPostings[task.m_liveSlots[i]] = base::asserted_cast<search_base::Posting>(i);
+
+  CompactedPostingsFetcher::GetPostingsFn const getPostings =
+      [&](search_base::Token const & token, vector<search_base::Posting> & postings) {
+        postings.clear();
+        auto const add = [&](search_base::Posting const posting) {
+          CHECK_LESS(posting, numSlots, ());
+          if (newPostings[posting] != kDroppedPosting)
+            postings.push_back(newPostings[posting]);
+        };
+        if (base)
+          base->m_index.ForEachPosting(token, add);
+        if (frozen)
+          frozen->m_index.ForEachPosting(token, add);
+        base::SortUnique(postings);
+      };
+
+  vector<search_base::Token> tokens;
+  if (base)
+    tokens = base->m_index.GetDictionary().GetTokens();
+  if (frozen)
+    frozen->m_index.ForEachToken([&tokens](search_base::Token const & t) { tokens.push_back(t); });
+  base::SortUnique(tokens);
+
+  // Tokens of the dropped slots only are dropped too.
+  vector<search_base::Posting> postings;
+  base::EraseIf(tokens, [&](search_base::Token const & token) {
+    getPostings(token, postings);
+    return postings.empty();
+  });
+
+  {
+    FileWriter writer(GetSegmentPath(task.m_dir, task.m_generation, kIndexExt));
+
+    search_base::TextIndexHeader header;
+    uint64_t const startPos = writer.Pos();
+    // Will be filled in later.
+    header.Serialize(writer);
+
+    search_base::TextIndexDictionary dict;
+    dict.SetTokens(std::move(tokens));
+    dict.Serialize(writer, header, startPos);
+
+    CompactedPostingsFetcher fetcher(dict.GetTokens(), getPostings);
+    search_base::WritePostings(writer, startPos, header, fetcher);
+
+    uint64_t const finishPos = writer.Pos();
+    writer.Seek(startPos);
+    header.Serialize(writer);
+    writer.Seek(finishPos);
+  }
+
+  {
+    FileWriter writer(GetSegmentPath(task.m_dir, task.m_generation, kDocsExt));
+    result.m_docOffsets.reserve(task.m_liveSlots.size());
+    for (auto const slot : task.m_liveSlots)
+    {
+      result.m_docOffsets.push_back(writer.Pos());
+      if (slot < numBaseSlots)
+      {
+        NonOwningReaderSource source(base->m_docs, task.m_baseDocOffsets[slot],
+                                     base->m_docs.Size());
+        DocVec docVec;
+        docVec.Deserialize(source);
+        docVec.Serialize(writer);
+      }
+      else
+      {
+        frozen->m_docs[slot - numBaseSlots].Serialize(writer);
+      }
+    }
+  }
+
+  result.m_liveSlots = std::move(task.m_liveSlots);
+  return result;
+}
+
+bool DiskIndex::IsLatest(search_base::Posting posting) const
+{
+  auto const it = m_idToSlot.find(m_slots[posting].m_id);
+  return it != m_idToSlot.end() && it->second == posting;
+}
+
+void DiskIndex::Load()
+{
+  auto const slotsPath = base::JoinPath(m_dir, kSlotsFile);
+  if (Platform::IsFileExistsByFullPath(slotsPath))
+  {
+    try
+    {
+      vector<Slot> slots;
+      unordered_map<Id, search_base::Posting> idToSlot;
+      uint32_t generation = 0;
+      {
+        FileReader reader(slotsPath);
+        ReaderSource<FileReader> source(reader);
+
+        auto const version = ReadPrimitiveFromSource<uint8_t>(source);
+        if (version != kSlotsVersion)
+          MYTHROW(DiskIndexException, ("Unknown slots version", version));
+
+        generation = ReadPrimitiveFromSource<uint32_t>(source);
+        slots.resize(ReadPrimitiveFromSource<uint32_t>(source));
+        for (uint32_t i = 0; i < slots.size(); ++i)
+        {
+          slots[i].m_id = ReadPrimitiveFromSource<uint64_t>(source);
+          slots[i].m_hash = ReadPrimitiveFromSource<uint64_t>(source);
+          slots[i].m_docOffset = ReadPrimitiveFromSource<uint64_t>(source);
+          if (ReadPrimitiveFromSource<uint8_t>(source) != 0)
+            idToSlot[slots[i].m_id] = i;
+        }
+      }
+
+      if (!slots.empty())
+        m_base = make_shared<Segment>(m_dir, generation);
+      m_generation = generation;
+      m_slots = std::move(slots);
+      m_idToSlot = std::move(idToSlot);
+      m_numBaseSlots = m_numFrozenSlots = m_slots.size();
+    }
+    catch (RootException const & e)
+    {
+      LOG(LWARNING, ("Can't load bookmarks index", m_dir, e.Msg()));
+      base::DeleteFileX(slotsPath);
+      m_base.reset();
+      m_generation = 0;
+    }
+  }
+
+  // Leftovers of interrupted merges and of the replaced generations.
+  auto const deleteLeftovers = [this](char const * ext) {
+    Platform::FilesList files;
+    Platform::GetFilesByExt(m_dir, ext, files);
+    for (auto const & file : files)
+    {
+      auto const path = base::JoinPath(m_dir, file);
+      if (!m_base || path != GetSegmentPath(m_dir, m_generation, ext))
+        base::DeleteFileX(path);
+    }
+  };
+  deleteLeftovers(kIndexExt);
+  deleteLeftovers(kDocsExt);
+}
+
+void DiskIndex::SaveSlots() const
+{
+  auto const slotsPath = base::JoinPath(m_dir, kSlotsFile);
+  auto const tmpPath = slotsPath + EXTENSION_TMP;
+  {
+    FileWriter writer(tmpPath);
+    WriteToSink(writer, kSlotsVersion);
+    WriteToSink(writer, m_generation);
+    WriteToSink(writer, base::checked_cast<uint32_t>(m_numBaseSlots));
+    for (size_t i = 0; i < m_numBaseSlots; ++i)
+    {
+      auto const & slot = m_slots[i];
+      WriteToSink(writer, slot.m_id);
+      WriteToSink(writer, slot.m_hash);
+      WriteToSink(writer, slot.m_docOffset);
+      bool const isLatest = IsLatest(base::asserted_cast<search_base::Posting>(i));
+      WriteToSink(writer, static_cast<uint8_t>(isLatest ? 1 : 0));
+    }
+  }
+
+  // The slots file is never mapped, so it may be replaced on every platform.
+  if (!base::RenameFileX(tmpPath, slotsPath))
+    MYTHROW(DiskIndexException, ("Can't rename", tmpPath, "to", slotsPath));
+}
+
+void DiskIndex::StartMerge()
+{
+  if (m_merge.valid() || m_mergeFailed || m_deltaDocs.empty())
+    return;
+
+  auto frozen = make_shared<Frozen>();
+  frozen->m_index = std::move(m_delta);
+  frozen->m_docs = std::move(m_deltaDocs);
+  m_delta = {};
+  m_deltaDocs = {};
+  m_deltaSize = 0;
+  m_frozen = frozen;
+  m_numFrozenSlots = m_slots.size();
+
+  MergeTask task;
+  task.m_base = m_base;
+  task.m_frozen = std::move(frozen);
+  task.m_baseDocOffsets.reserve(m_numBaseSlots);
+  for (size_t i = 0; i < m_numBaseSlots; ++i)
+    task.m_baseDocOffsets.push_back(m_slots[i].m_docOffset);
+  for (size_t i = 0; i < m_slots.size(); ++i)
+  {
+    auto const posting = base::asserted_cast<search_base::Posting>(i);
+    if (IsLatest(posting))
+      task.m_liveSlots.push_back(posting);
+  }
+  task.m_dir = m_dir;
+  task.m_generation = m_generation + 1;
+
+  // The task owns its segments, so they survive FinishMerge() of a concurrent merge.
+  m_merge = m_pool.Submit([task = std::move(task)]() mutable { return Merge(std::move(task)); })
+                .share();
+}
+
+void DiskIndex::TryFinishMerge()
+{
+  if (m_merge.valid() && m_merge.wait_for(chrono::seconds(0)) == future_status::ready)
+    FinishMerge();
+}
+
+void DiskIndex::FinishMerge()
+{
+  CHECK(m_merge.valid(), ());
+  auto merge = std::move(m_merge);
+  m_merge = {};
+
+  MergeResult result;
+  shared_ptr<Segment> segment;
+  try
+  {
+    result = merge.get();
+    if (!result.m_liveSlots.empty())
+      segment = make_shared<Segment>(m_dir, result.m_generation);
+  }
+  catch (RootException const & e)
+  {
+    LOG(LERROR, ("Can't merge bookmarks index", m_dir, e.Msg()));
+    m_mergeFailed = true;
+    base::DeleteFileX(GetSegmentPath(m_dir, m_generation + 1, kIndexExt));
+    base::DeleteFileX(GetSegmentPath(m_dir, m_generation + 1, kDocsExt));
+    return;
+  }
+
+  auto const & liveSlots = result.m_liveSlots;
+  CHECK_EQUAL(liveSlots.size(), result.m_docOffsets.size(), ());
+
+  // Slots put during the merge are shifted down to the live ones.
+  auto const numDropped = m_numFrozenSlots - liveSlots.size();
+  auto const getNewPosting = [&](search_base::Posting const posting) {
+    if (posting >= m_numFrozenSlots)
+      return base::asserted_cast<search_base::Posting>(posting - numDropped);
+    auto const it = lower_bound(liveSlots.begin(), liveSlots.end(), posting);
+    if (it == liveSlots.end() || *it != posting)
+      return kDroppedPosting;
+    return base::asserted_cast<search_base::Posting>(distance(liveSlots.begin(), it));
+  };
+
+  vector<Slot> slots;
+  slots.reserve(m_slots.size() - numDropped);
+  for (size_t i = 0; i < liveSlots.size(); ++i)
+  {
+    slots.push_back(m_slots[liveSlots[i]]);
+    slots.back().m_docOffset = result.m_docOffsets[i];
+  }
+  slots.insert(slots.end(), m_slots.begin() + m_numFrozenSlots, m_slots.end());
+
+  search_base::MemTextIndex delta;
+  m_delta.ForEachToken([&](search_base::Token const & token) {
+    m_delta.ForEachPosting(token, [&](search_base::Posting const posting) {
+      delta.AddPosting(token, getNewPosting(posting));
+    });
+  });
+
+  for (auto & idSlot : m_idToSlot)
+  {
+    // A doc may only lose its latest slot during the merge, so its slot is live.
+    idSlot.second = getNewPosting(idSlot.second);
+    CHECK_NOT_EQUAL(idSlot.second, kDroppedPosting, ());
+  }
+
+  auto const prevBase = m_base;
+  m_base = std::move(segment);
+  m_generation = result.m_generation;
+  m_frozen.reset();
+  m_delta = std::move(delta);
+  m_slots = std::move(slots);
+  m_numBaseSlots = m_numFrozenSlots = liveSlots.size();
+
+  try
+  {
+    SaveSlots();
+  }
+  catch (RootException const & e)
+  {
+    // The previous generation is still referenced by the slots file.
+    LOG(LERROR, ("Can't save bookmarks index slots", m_dir, e.Msg()));
+    m_mergeFailed = true;
+    if (m_base)
+      m_base->m_files.m_obsolete = true;
+    return;
+  }
+
+  if (prevBase)
+    prevBase->m_files.m_obsolete = true;
+}
+}  // namespace bookmarks
+}  // namespace search
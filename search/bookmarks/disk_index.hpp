@@ -0,0 +1,264 @@
+#pragma once
+
+#include "search/base/text_index/mem.hpp"
+#include "search/base/text_index/reader.hpp"
+#include "search/base/text_index/text_index.hpp"
+#include "search/bookmarks/types.hpp"
+#include "search/doc_vec.hpp"
+
+#include "coding/mmap_reader.hpp"
+
+#include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace search
+{
+namespace bookmarks
+{
+namespace impl
+{
+// Matches the sorted tokens one by one against |dfa|. DFA states are shared between the common
+// prefixes of adjacent tokens, so a rejected prefix is not walked again for the following tokens.
+template <typename DFA>
+class SortedTokensMatcher
+{
+public:
+  explicit SortedTokensMatcher(DFA const & dfa) { m_states.push_back(dfa.Begin()); }
+
+  // The tokens must be passed in the sorted order.
+  bool Accepts(strings::UniString const & token)
+  {
+    size_t common = 0;
+    while (common < m_prev.size() && common < token.size() && m_prev[common] == token[common])
+      ++common;
+    m_prev = token;
+
+    // m_states[k] is the state after the first k symbols of the token.
+    // DFA iterators are not assignable, so erase() is not an option.
+    while (m_states.size() > common + 1)
+      m_states.pop_back();
+
+    while (m_states.size() <= token.size() && !m_states.back().Rejects())
+    {
+      auto it = m_states.back();
+      it.Move(token[m_states.size() - 1]);
+      m_states.push_back(it);
+    }
+
+    return m_states.size() == token.size() + 1 && m_states.back().Accepts();
+  }
+
+private:
+  std::vector<typename DFA::Iterator> m_states;
+  strings::UniString m_prev;
+};
+}  // namespace impl
+
+// A persistent bookmarks text index. It consists of:
+// * the base segment: a search_base text index mmapped from |dir| and the docs of its slots;
+// * the frozen segment: the delta being merged into the base in the background;
+// * the delta: an in-memory index of the docs put since the last merge.
+//
+// Postings are doc slots. Every slot keeps a doc id and a hash of the doc tokens,
+// so a doc which is already in the base segment is made searchable again
+// without touching the postings, e.g. when all bookmarks are loaded on startup.
+// Slots of erased and updated docs are filtered out on retrieval and dropped
+// with their postings by the next merge.
+//
+// Every merge writes a new generation of the base segment files, so a mapped
+// file is never overwritten. The files of the previous generation are deleted
+// once the segment is not used anymore.
+//
+// This class is thread-safe, so a single index may be shared by several search threads.
+class DiskIndex
+{
+public:
+  // Number of postings in the delta which triggers the merge.
+  static size_t constexpr kMaxDeltaSize = 100000;
+
+  // Loads the index from |dir| or creates an empty one if there is no index or it is broken.
+  explicit DiskIndex(std::string const & dir);
+  // Waits for the running merge, if any. The delta is not merged, so the docs
+  // from it are indexed again on the next start.
+  ~DiskIndex();
+
+  // Keeps |docVec| by |id|. A new doc is not searchable. When the doc did not change,
+  // it keeps its slot and searchability, otherwise it gets a new unsearchable slot.
+  void Put(Id const & id, DocVec const & docVec);
+  void SetSearchable(Id const & id, bool searchable);
+  // Drops the slot of |id|.
+  void Forget(Id const & id);
+  // Makes all docs unsearchable, the slots are kept.
+  void Reset();
+
+  // Starts the merge of the delta into the base segment unless another merge is running.
+  void Flush();
+  // Waits for the running merge, if any, and installs its result.
+  void WaitForMerge();
+
+  // Returns false if |id| is unknown.
+  bool GetDocVec(Id const & id, DocVec & docVec) const;
+
+  // Executes |fn| on the id of every searchable doc having a token accepted by |dfa|.
+  // Ids may be reported several times. |fn| is called under the index lock.
+  template <typename DFA, typename Fn>
+  void ForEachMatch(DFA const & dfa, Fn && fn) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto const emit = [this, &fn](search_base::Posting const posting) {
+      if (IsSearchable(posting))
+        fn(m_slots[posting].m_id);
+    };
+
+    if (m_base)
+    {
+      auto const & tokens = m_base->m_index.GetDictionary().GetTokens();
+      impl::SortedTokensMatcher<DFA> matcher(dfa);
+      for (size_t i = 0; i < tokens.size(); ++i)
+      {
+        if (matcher.Accepts(m_base->m_tokens[i]))
+          m_base->m_index.ForEachPosting(tokens[i], emit);
+      }
+    }
+
+    search_base::MemTextIndex const * const memIndexes[] = {
+        m_frozen ? &m_frozen->m_index : nullptr, &m_delta};
+    for (auto const * index : memIndexes)
+    {
+      if (index == nullptr)
+        continue;
+
+      // The tokens are walked in place, in their lexicographical order.
+      impl::SortedTokensMatcher<DFA> matcher(dfa);
+      index->ForEachToken([&](search_base::Token const & token) {
+        if (matcher.Accepts(strings::MakeUniString(token)))
+          index->ForEachPosting(token, emit);
+      });
+    }
+  }
+
+  // Returns the number of searchable docs having |token| (or a token starting
+  // with |token| when |isPrefix| is true).
+  uint64_t GetNumDocs(strings::UniString const & token, bool isPrefix) const;
+
+  // Number of the slots which have postings, including the dropped ones.
+  size_t GetNumSlots() const;
+  size_t GetDeltaSize() const;
+  bool IsMerging() const;
+
+private:
+  // Deletes the files of a segment generation which is no longer in use.
+  struct SegmentFiles
+  {
+    ~SegmentFiles();
+
+    std::string m_indexPath;
+    std::string m_docsPath;
+    std::atomic<bool> m_obsolete = false;
+  };
+
+  struct Segment
+  {
+    Segment(std::string const & dir, uint32_t generation);
+
+    // The first member, so the files are unmapped by the time they are deleted.
+    SegmentFiles m_files;
+    search_base::TextIndexReader m_index;
+    MmapReader m_docs;
+    // Dictionary of |m_index| for DFA matching.
+    std::vector<strings::UniString> m_tokens;
+  };
+
+  struct Frozen
+  {
+    search_base::MemTextIndex m_index;
+    // Docs of the frozen slots.
+    std::vector<DocVec> m_docs;
+  };
+
+  struct Slot
+  {
+    Id m_id = 0;
+    uint64_t m_hash = 0;
+    // Offset of the doc in the docs file of the base segment.
+    uint64_t m_docOffset = 0;
+    bool m_searchable = false;
+  };
+
+  struct MergeTask
+  {
+    std::shared_ptr<Segment const> m_base;
+    std::shared_ptr<Frozen const> m_frozen;
+    // Doc offsets of the base slots.
+    std::vector<uint64_t> m_baseDocOffsets;
+    // Slots kept by the merge in the increasing order. Postings of the other slots are dropped.
+    std::vector<search_base::Posting> m_liveSlots;
+    std::string m_dir;
+    uint32_t m_generation = 0;
+  };
+
+  struct MergeResult
+  {
+    std::vector<search_base::Posting> m_liveSlots;
+    // Doc offsets of |m_liveSlots| in the new segment.
+    std::vector<uint64_t> m_docOffsets;
+    uint32_t m_generation = 0;
+  };
+
+  // Writes the |task.m_generation| segment with the docs and postings of the live slots only.
+  // The live slots are renumbered in their order.
+  static MergeResult Merge(MergeTask && task);
+
+  bool IsSearchable(search_base::Posting posting) const
+  {
+    return posting < m_slots.size() && m_slots[posting].m_searchable;
+  }
+
+  bool IsLatest(search_base::Posting posting) const;
+
+  void Load();
+  void SaveSlots() const;
+  void StartMerge();
+  void TryFinishMerge();
+  void FinishMerge();
+
+  std::string const m_dir;
+
+  mutable std::mutex m_mutex;
+
+  uint32_t m_generation = 0;
+  std::shared_ptr<Segment> m_base;
+  std::shared_ptr<Frozen> m_frozen;
+  search_base::MemTextIndex m_delta;
+  // Docs of the delta slots.
+  std::vector<DocVec> m_deltaDocs;
+  size_t m_deltaSize = 0;
+
+  std::vector<Slot> m_slots;
+  // Slots with postings in the base and the frozen segments respectively.
+  size_t m_numBaseSlots = 0;
+  size_t m_numFrozenSlots = 0;
+  // The latest slot of every known doc.
+  std::unordered_map<Id, search_base::Posting> m_idToSlot;
+
+  std::shared_future<MergeResult> m_merge;
+  // Set when a merge fails: the frozen segment then stays in memory until the index is destroyed.
+  bool m_mergeFailed = false;
+
+  // The pool is the last member, so the tasks are finished before the other members are gone.
+  base::ComputationalThreadPool m_pool;
+};
+}  // namespace bookmarks
+}  // namespace search
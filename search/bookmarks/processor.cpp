@@ -76,6 +76,8 @@ Processor::Processor(Emitter & emitter, base::Cancellable const & cancellable)
 void Processor::Reset()
 {
   m_index = {};
+  if (m_diskIndex && m_updateDiskIndex)
+    m_diskIndex->Reset();
   m_docs.clear();
   m_indexDescriptions = false;
   m_indexableGroups.clear();
@@ -83,6 +85,13 @@ void Processor::Reset()
   m_bookmarksInGroup.clear();
 }
 
+void Processor::SetIndex(std::shared_ptr<DiskIndex> index, bool updateIndex)
+{
+  ASSERT(m_docs.empty(), ());
+  m_diskIndex = std::move(index);
+  m_updateDiskIndex = updateIndex;
+}
+
 void Processor::EnableIndexingOfDescriptions(bool enable) { m_indexDescriptions = enable; }
 
 void Processor::EnableIndexingOfBookmarkGroup(GroupId const & groupId, bool enable)
@@ -108,6 +117,9 @@ void Processor::EnableIndexingOfBookmarkGroup(GroupId const & groupId, bool enab
 
 void Processor::Add(Id const & id, Doc const & doc)
 {
+  if (m_diskIndex && !m_updateDiskIndex)
+    return;
+
   ASSERT_EQUAL(m_docs.count(id), 0, ());
 
   DocVec::Builder builder;
@@ -122,13 +134,22 @@ void Processor::Add(Id const & id, Doc const & doc)
 
   DocVec const docVec(builder);
 
-  m_docs[id] = docVec;
+  if (m_diskIndex)
+    m_diskIndex->Put(id, docVec);
+  else
+    m_docs[id] = docVec;
 }
 
 void Processor::AddToIndex(Id const & id)
 {
-  ASSERT_EQUAL(m_docs.count(id), 1, ());
+  if (m_diskIndex)
+  {
+    if (m_updateDiskIndex)
+      m_diskIndex->SetSearchable(id, true /* searchable */);
+    return;
+  }
 
+  ASSERT_EQUAL(m_docs.count(id), 1, ());
   m_index.Add(id, DocVecWrapper(m_docs[id]));
 }
 
@@ -152,18 +173,30 @@ void Processor::Update(Id const & id, Doc const & doc)
 
 void Processor::Erase(Id const & id)
 {
-  ASSERT_EQUAL(m_docs.count(id), 1, ());
-
   ASSERT(m_idToGroup.find(id) == m_idToGroup.end(),
          ("A bookmark must be detached from all groups before being deleted."));
 
+  if (m_diskIndex)
+  {
+    if (m_updateDiskIndex)
+      m_diskIndex->Forget(id);
+    return;
+  }
+
+  ASSERT_EQUAL(m_docs.count(id), 1, ());
   m_docs.erase(id);
 }
 
 void Processor::EraseFromIndex(Id const & id)
 {
-  ASSERT_EQUAL(m_docs.count(id), 1, ());
+  if (m_diskIndex)
+  {
+    if (m_updateDiskIndex)
+      m_diskIndex->SetSearchable(id, false /* searchable */);
+    return;
+  }
 
+  ASSERT_EQUAL(m_docs.count(id), 1, ());
   auto const & docVec = m_docs[id];
   m_index.Erase(id, DocVecWrapper(docVec));
 }
@@ -243,12 +276,24 @@ void Processor::Search(Params const & params) const
         continue;
     }
 
-    auto it = m_docs.find(id);
-    CHECK(it != m_docs.end(), ("Can't find retrieved doc:", id));
-    auto const & doc = it->second;
+    DocVec diskDoc;
+    DocVec const * doc = nullptr;
+    if (m_diskIndex)
+    {
+      // The doc may be gone since retrieval when the index is updated by another processor.
+      if (!m_diskIndex->GetDocVec(id, diskDoc))
+        continue;
+      doc = &diskDoc;
+    }
+    else
+    {
+      auto it = m_docs.find(id);
+      CHECK(it != m_docs.end(), ("Can't find retrieved doc:", id));
+      doc = &it->second;
+    }
 
     RankingInfo info;
-    FillRankingInfo(qv, idfs, doc, info);
+    FillRankingInfo(qv, idfs, *doc, info);
 
     idInfos.emplace_back(id, info);
   }
@@ -270,6 +315,9 @@ void Processor::Finish(bool cancelled) { m_emitter.Finish(cancelled); }
 
 uint64_t Processor::GetNumDocs(strings::UniString const & token, bool isPrefix) const
 {
+  if (m_diskIndex)
+    return m_diskIndex->GetNumDocs(token, isPrefix);
+
   return base::asserted_cast<uint64_t>(
       m_index.GetNumDocs(StringUtf8Multilang::kDefaultCode, token, isPrefix));
 }
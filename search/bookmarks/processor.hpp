@@ -1,6 +1,7 @@
 #pragma once
 
 #include "search/base/mem_search_index.hpp"
+#include "search/bookmarks/disk_index.hpp"
 #include "search/bookmarks/types.hpp"
 #include "search/cancel_exception.hpp"
 #include "search/doc_vec.hpp"
@@ -10,6 +11,8 @@
 #include "search/search_params.hpp"
 #include "search/utils.hpp"
 
+#include <memory>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -43,6 +46,13 @@ public:
 
   void Reset();
 
+  // Uses |index| instead of the in-memory index, so that the bookmarks which are
+  // already indexed are not re-indexed when they are added on the next start.
+  // The index may be shared by several processors which get the same updates:
+  // only the one with |updateIndex| set applies them to the index.
+  // Must be called before any bookmark is added.
+  void SetIndex(std::shared_ptr<DiskIndex> index, bool updateIndex);
+
   // By default, only bookmark names are indexed. This method
   // should be used to enable or disable indexing bookmarks
   // by their descriptions.
@@ -81,6 +91,13 @@ private:
     FillRequestFromToken(token, request);
     request.m_langs.insert(StringUtf8Multilang::kDefaultCode);
 
+    if (m_diskIndex)
+    {
+      for (auto const & dfa : request.m_names)
+        m_diskIndex->ForEachMatch(dfa, [&fn](Id const & id) { fn(id, false /* exactMatch */); });
+      return;
+    }
+
     MatchFeaturesInTrie(
         request, m_index.GetRootIterator(), [](Id const & /* id */) { return true; } /* filter */,
         std::forward<Fn>(fn));
@@ -94,6 +111,10 @@ private:
   Index m_index;
   std::unordered_map<Id, DocVec> m_docs;
 
+  // When set, replaces |m_index| and |m_docs|.
+  std::shared_ptr<DiskIndex> m_diskIndex;
+  bool m_updateDiskIndex = false;
+
   bool m_indexDescriptions = false;
   std::unordered_set<GroupId> m_indexableGroups;
 
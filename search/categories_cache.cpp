@@ -29,20 +29,25 @@ CBV CategoriesCache::Load(MwmContext const & context) const
 {
   auto const & c = classif();
 
-  // Any DFA will do, since we only use requests's m_categories,
-  // but the interface of Retrieval forces us to make a choice.
-  SearchTrieRequest<strings::UniStringDFA> request;
-
   // m_categories usually has truncated types; add them together with their subtrees.
-  m_categories.ForEach([&request, &c](uint32_t const type)
+  vector<uint32_t> types;
+  m_categories.ForEach([&types, &c](uint32_t const type)
   {
-    c.ForEachInSubtree([&](uint32_t descendantType)
-    {
-      request.m_categories.emplace_back(FeatureTypeToString(c.GetIndexForType(descendantType)));
-    }, type);
+    c.ForEachInSubtree([&types](uint32_t descendantType) { types.push_back(descendantType); }, type);
   });
 
   Retrieval retrieval(context, m_cancellable);
+
+  // Precomputed postings make the lookup almost free, the search index is a fallback for old mwms.
+  if (auto features = retrieval.RetrieveTypesFeatures(types))
+    return *features;
+
+  // Any DFA will do, since we only use requests's m_categories,
+  // but the interface of Retrieval forces us to make a choice.
+  SearchTrieRequest<strings::UniStringDFA> request;
+  for (uint32_t const type : types)
+    request.m_categories.emplace_back(FeatureTypeToString(c.GetIndexForType(type)));
+
   return retrieval.RetrieveAddressFeatures(request).m_features;
 }
 
@@ -1,5 +1,7 @@
 #include "search/cbv.hpp"
 
+#include "search/tracer.hpp"
+
 #include <limits>
 #include <vector>
 
@@ -77,6 +79,8 @@ uint64_t CBV::PopCount() const
 
 CBV CBV::Union(CBV const & rhs) const
 {
+  Tracer::Inc(Tracer::Profile::Counter::CBVOps);
+
   if (IsFull() || rhs.IsEmpty())
     return *this;
   if (IsEmpty() || rhs.IsFull())
@@ -86,6 +90,8 @@ CBV CBV::Union(CBV const & rhs) const
 
 CBV CBV::Intersect(CBV const & rhs) const
 {
+  Tracer::Inc(Tracer::Profile::Counter::CBVOps);
+
   if (IsFull() || rhs.IsEmpty())
     return rhs;
   if (IsEmpty() || rhs.IsFull())
@@ -95,6 +101,8 @@ CBV CBV::Intersect(CBV const & rhs) const
 
 CBV CBV::Take(uint64_t n) const
 {
+  Tracer::Inc(Tracer::Profile::Counter::CBVOps);
+
   if (IsEmpty())
     return *this;
   if (IsFull())
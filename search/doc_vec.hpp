@@ -2,6 +2,9 @@
 
 #include "search/idf_map.hpp"
 
+#include "coding/read_write_utils.hpp"
+#include "coding/varint.hpp"
+
 #include "base/assert.hpp"
 #include "base/string_utils.hpp"
 
@@ -71,6 +74,30 @@ public:
 
   bool Empty() const { return m_tfs.empty(); }
 
+  template <typename Sink>
+  void Serialize(Sink & sink) const
+  {
+    WriteVarUint(sink, static_cast<uint64_t>(m_tfs.size()));
+    for (auto const & tf : m_tfs)
+    {
+      rw::Write(sink, strings::ToUtf8(tf.m_token));
+      WriteVarUint(sink, tf.m_frequency);
+    }
+  }
+
+  template <typename Source>
+  void Deserialize(Source & source)
+  {
+    m_tfs.resize(ReadVarUint<uint64_t>(source));
+    for (auto & tf : m_tfs)
+    {
+      std::string token;
+      rw::Read(source, token);
+      tf.m_token = strings::MakeUniString(token);
+      tf.m_frequency = ReadVarUint<uint64_t>(source);
+    }
+  }
+
 private:
   friend std::string DebugPrint(DocVec const & dv)
   {
@@ -5,6 +5,7 @@
 #include "storage/country_info_getter.hpp"
 
 #include "indexer/categories_holder.hpp"
+#include "indexer/data_source.hpp"
 #include "indexer/search_string_utils.hpp"
 
 #include "base/scope_guard.hpp"
@@ -82,17 +83,31 @@ Engine::Params::Params(string const & locale, size_t numThreads)
 // Engine ------------------------------------------------------------------------------------------
 Engine::Engine(DataSource & dataSource, CategoriesHolder const & categories,
                storage::CountryInfoGetter const & infoGetter, Params const & params)
-  : m_shutdown(false)
+  : m_dataSource(dataSource), m_shutdown(false)
 {
+  if (params.m_resultsCacheSize > 0)
+  {
+    m_resultsCache = make_unique<ResultsCache>(params.m_resultsCacheSize);
+    m_dataSource.AddObserver(*this);
+  }
+
   InitSuggestions doInit;
   categories.ForEachName(doInit);
   doInit.GetSuggests(m_suggests);
 
+  shared_ptr<bookmarks::DiskIndex> bookmarksIndex;
+  if (!params.m_bookmarksIndexDir.empty())
+    bookmarksIndex = make_shared<bookmarks::DiskIndex>(params.m_bookmarksIndexDir);
+
   m_contexts.resize(params.m_numThreads);
   for (size_t i = 0; i < params.m_numThreads; ++i)
   {
     auto processor = make_unique<Processor>(dataSource, categories, m_suggests, infoGetter);
     processor->SetPreferredLocale(params.m_locale);
+    // Bookmarks updates are broadcast to all threads, so only the first one applies
+    // them to the shared index.
+    if (bookmarksIndex)
+      processor->SetBookmarksIndex(bookmarksIndex, i == 0 /* updateIndex */);
     m_contexts[i].m_processor = std::move(processor);
   }
 
@@ -107,6 +122,9 @@ Engine::Engine(DataSource & dataSource, CategoriesHolder const & categories,
 
 Engine::~Engine()
 {
+  if (m_resultsCache)
+    m_dataSource.RemoveObserver(*this);
+
   {
     lock_guard<mutex> lock(m_mu);
     m_shutdown = true;
@@ -129,6 +147,7 @@ weak_ptr<ProcessorHandle> Engine::Search(SearchParams params)
 
 void Engine::SetLocale(string const & locale)
 {
+  ClearResultsCache();
   PostMessage(Message::TYPE_BROADCAST,
               [locale](Processor & processor) { processor.SetPreferredLocale(locale); });
 }
@@ -137,9 +156,21 @@ size_t Engine::GetNumThreads() const { return m_threads.size(); }
 
 void Engine::ClearCaches()
 {
+  ClearResultsCache();
   PostMessage(Message::TYPE_BROADCAST, [](Processor & processor) { processor.ClearCaches(); });
 }
 
+void Engine::ClearResultsCache()
+{
+  if (m_resultsCache)
+    m_resultsCache->Clear();
+}
+
+ResultsCache::Stats Engine::GetResultsCacheStats() const
+{
+  return m_resultsCache ? m_resultsCache->GetStats() : ResultsCache::Stats();
+}
+
 void Engine::CacheWorldLocalities()
 {
   PostMessage(Message::TYPE_BROADCAST,
@@ -213,6 +244,16 @@ void Engine::OnBookmarksDetachedFromGroup(bookmarks::GroupId const & groupId,
   });
 }
 
+void Engine::OnMapRegistered(platform::LocalCountryFile const & /* localFile */)
+{
+  ClearResultsCache();
+}
+
+void Engine::OnMapDeregistered(platform::LocalCountryFile const & /* localFile */)
+{
+  ClearResultsCache();
+}
+
 void Engine::MainLoop(Context & context)
 {
   while (true)
@@ -288,6 +329,36 @@ void Engine::DoSearch(SearchParams params, shared_ptr<ProcessorHandle> handle, P
     LOG(LINFO, ("Search ended in", timer.ElapsedMilliseconds(), "ms."));
   });
 
+  string cacheKey;
+  if (m_resultsCache)
+    cacheKey = ResultsCache::MakeKey(params);
+
+  if (!cacheKey.empty())
+  {
+    Results results;
+    if (m_resultsCache->Get(cacheKey, results))
+    {
+      LOG(LINFO, ("Search results are taken from cache."));
+      if (params.m_onStarted)
+        params.m_onStarted();
+      params.m_onResults(results);
+      return;
+    }
+
+    // Only complete results of the search which was neither cancelled nor stopped by timeout
+    // are cached.
+    params.m_onResults = [this, &processor, cacheKey,
+                          onResults = std::move(params.m_onResults)](Results const & results)
+    {
+      if (results.IsEndedNormal() &&
+          processor.CancellationStatus() == base::Cancellable::Status::Active)
+      {
+        m_resultsCache->Put(cacheKey, results);
+      }
+      onResults(results);
+    };
+  }
+
   processor.Reset();
   handle->Attach(processor);
   SCOPE_GUARD(detach, [&handle] { handle->Detach(); });
@@ -1,9 +1,11 @@
 #pragma once
 
+#include "search/results_cache.hpp"
 #include "search/search_params.hpp"
 #include "search/suggest.hpp"
 
 #include "indexer/categories_holder.hpp"
+#include "indexer/mwm_set.hpp"
 
 #include "base/macros.hpp"
 #include "base/thread.hpp"
@@ -66,7 +68,7 @@ private:
 // queries one by one.
 //
 // NOTE: this class is thread safe.
-class Engine
+class Engine : public MwmSet::Observer
 {
 public:
   struct Params
@@ -80,12 +82,20 @@ public:
     // to process queries. Use this field wisely as large values may
     // negatively affect performance due to false sharing.
     size_t m_numThreads;
+
+    // Max number of queries with results kept in the results cache.
+    // Zero disables the cache.
+    size_t m_resultsCacheSize = 0;
+
+    // Directory to keep the bookmarks index in. The index is shared by all threads.
+    // Empty means the index is kept in memory.
+    std::string m_bookmarksIndexDir;
   };
 
   // Doesn't take ownership of dataSource and categories.
   Engine(DataSource & dataSource, CategoriesHolder const & categories,
          storage::CountryInfoGetter const & infoGetter, Params const & params);
-  ~Engine();
+  ~Engine() override;
 
   // Posts search request to the queue and returns its handle.
   std::weak_ptr<ProcessorHandle> Search(SearchParams params);
@@ -96,9 +106,15 @@ public:
   // Returns the number of request-processing threads.
   size_t GetNumThreads() const;
 
-  // Posts request to clear caches to the queue.
+  // Posts request to clear caches to the queue. Results cache is cleared immediately.
   void ClearCaches();
 
+  // Drops all cached results, e.g. when features were edited.
+  void ClearResultsCache();
+
+  // Returns empty stats when the results cache is disabled.
+  ResultsCache::Stats GetResultsCacheStats() const;
+
   // Posts requests to load and cache localities from World.mwm.
   void CacheWorldLocalities();
 
@@ -122,6 +138,10 @@ public:
   void OnBookmarksDetachedFromGroup(bookmarks::GroupId const & groupId,
                                     std::vector<bookmarks::Id> const & marks);
 
+  // MwmSet::Observer overrides:
+  void OnMapRegistered(platform::LocalCountryFile const & localFile) override;
+  void OnMapDeregistered(platform::LocalCountryFile const & localFile) override;
+
 private:
   struct Message
   {
@@ -168,8 +188,13 @@ private:
 
   void DoSearch(SearchParams params, std::shared_ptr<ProcessorHandle> handle, Processor & processor);
 
+  DataSource & m_dataSource;
+
   std::vector<Suggest> m_suggests;
 
+  // Null when the results cache is disabled.
+  std::unique_ptr<ResultsCache> m_resultsCache;
+
   bool m_shutdown;
   std::mutex m_mu;
   std::condition_variable m_cv;
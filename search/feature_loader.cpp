@@ -1,5 +1,7 @@
 #include "search/feature_loader.hpp"
 
+#include "search/tracer.hpp"
+
 #include "editor/editable_data_source.hpp"
 
 #include "indexer/feature.hpp"
@@ -12,6 +14,7 @@ FeatureLoader::FeatureLoader(DataSource const & dataSource) : m_dataSource(dataS
 std::unique_ptr<FeatureType> FeatureLoader::Load(FeatureID const & id)
 {
   ASSERT(m_checker.CalledOnOriginalThread(), ());
+  Tracer::Inc(Tracer::Profile::Counter::FeaturesLoaded);
 
   auto const & mwmId = id.m_mwmId;
   if (!m_guard || m_guard->GetId() != mwmId)
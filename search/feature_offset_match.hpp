@@ -42,9 +42,11 @@ bool FindLangIndex(trie::Iterator<ValueList> const & trieRoot, uint8_t lang, uin
   return false;
 }
 
+// When |numVisitedNodes| is not null, it's incremented by the number of visited trie nodes.
 template <typename ValueList, typename DFA, typename ToDo>
 bool MatchInTrie(trie::Iterator<ValueList> const & trieRoot, strings::UniChar const * rootPrefix,
-                 size_t rootPrefixSize, DFA const & dfa, ToDo && toDo)
+                 size_t rootPrefixSize, DFA const & dfa, ToDo && toDo,
+                 uint64_t * numVisitedNodes = nullptr)
 {
   using TrieDFAIt = std::shared_ptr<trie::Iterator<ValueList>>;
   using DFAIt = typename DFA::Iterator;
@@ -61,11 +63,13 @@ bool MatchInTrie(trie::Iterator<ValueList> const & trieRoot, strings::UniChar co
   }
 
   bool found = false;
+  uint64_t numVisited = 0;
 
   while (!q.empty())
   {
     auto const p = q.front();
     q.pop();
+    ++numVisited;
 
     auto const & trieIt = p.first;
     auto const & dfaIt = p.second;
@@ -89,6 +93,9 @@ bool MatchInTrie(trie::Iterator<ValueList> const & trieRoot, strings::UniChar co
     }
   }
 
+  if (numVisitedNodes)
+    *numVisitedNodes += numVisited;
+
   return found;
 }
 
@@ -233,10 +240,13 @@ struct SearchTrieRequest
 // *NOTE* |toDo| may be called several times for the same feature.
 template <typename DFA, typename ValueList, typename ToDo>
 void MatchInTrie(std::vector<DFA> const & dfas, TrieRootPrefix<ValueList> const & trieRoot,
-                 ToDo && toDo)
+                 ToDo && toDo, uint64_t * numVisitedNodes = nullptr)
 {
   for (auto const & dfa : dfas)
-    impl::MatchInTrie(trieRoot.m_root, trieRoot.m_prefix, trieRoot.m_prefixSize, dfa, toDo);
+  {
+    impl::MatchInTrie(trieRoot.m_root, trieRoot.m_prefix, trieRoot.m_prefixSize, dfa, toDo,
+                      numVisitedNodes);
+  }
 }
 
 // Calls |toDo| for each feature in categories branch matching to |request|.
@@ -244,7 +254,8 @@ void MatchInTrie(std::vector<DFA> const & dfas, TrieRootPrefix<ValueList> const
 // *NOTE* |toDo| may be called several times for the same feature.
 template <typename DFA, typename ValueList, typename ToDo>
 bool MatchCategoriesInTrie(SearchTrieRequest<DFA> const & request,
-                           trie::Iterator<ValueList> const & trieRoot, ToDo && toDo)
+                           trie::Iterator<ValueList> const & trieRoot, ToDo && toDo,
+                           uint64_t * numVisitedNodes = nullptr)
 {
   uint32_t langIx = 0;
   if (!impl::FindLangIndex(trieRoot, search::kCategoriesLang, langIx))
@@ -254,7 +265,8 @@ bool MatchCategoriesInTrie(SearchTrieRequest<DFA> const & request,
   ASSERT_GREATER_OR_EQUAL(edge.size(), 1, ());
 
   auto const catRoot = trieRoot.GoToEdge(langIx);
-  MatchInTrie(request.m_categories, TrieRootPrefix<ValueList>(*catRoot, edge), toDo);
+  MatchInTrie(request.m_categories, TrieRootPrefix<ValueList>(*catRoot, edge), toDo,
+              numVisitedNodes);
 
   return true;
 }
@@ -287,22 +299,23 @@ void ForEachLangPrefix(SearchTrieRequest<DFA> const & request,
 template <typename DFA, typename ValueList, typename Filter, typename ToDo>
 void MatchFeaturesInTrie(SearchTrieRequest<DFA> const & request,
                          trie::Iterator<ValueList> const & trieRoot, Filter const & filter,
-                         ToDo && toDo)
+                         ToDo && toDo, uint64_t * numVisitedNodes = nullptr)
 {
   using Value = typename ValueList::Value;
 
   TrieValuesHolder<Filter, Value> categoriesHolder(filter);
-  bool const categoriesExist = MatchCategoriesInTrie(request, trieRoot, categoriesHolder);
+  bool const categoriesExist =
+      MatchCategoriesInTrie(request, trieRoot, categoriesHolder, numVisitedNodes);
 
   /// @todo Not sure why do we have OffsetIntersector here? We are doing aggregation only.
   impl::OffsetIntersector<Filter, Value> intersector(filter);
 
   ForEachLangPrefix(
       request, trieRoot,
-      [&request, &intersector](TrieRootPrefix<ValueList> & langRoot, int8_t /* lang */)
+      [&request, &intersector, numVisitedNodes](TrieRootPrefix<ValueList> & langRoot, int8_t /* lang */)
       {
         // Aggregate for all languages.
-        MatchInTrie(request.m_names, langRoot, intersector);
+        MatchInTrie(request.m_names, langRoot, intersector, numVisitedNodes);
       });
 
   if (categoriesExist)
@@ -317,7 +330,7 @@ void MatchFeaturesInTrie(SearchTrieRequest<DFA> const & request,
 
 template <typename ValueList, typename Filter, typename ToDo>
 void MatchPostcodesInTrie(TokenSlice const & slice, trie::Iterator<ValueList> const & trieRoot,
-                          Filter const & filter, ToDo && toDo)
+                          Filter const & filter, ToDo && toDo, uint64_t * numVisitedNodes = nullptr)
 {
   using namespace strings;
   using Value = typename ValueList::Value;
@@ -338,7 +351,7 @@ void MatchPostcodesInTrie(TokenSlice const & slice, trie::Iterator<ValueList> co
     // postcode zone will give all street vicinity as the result which is wrong.
     std::vector<UniStringDFA> dfas;
     slice.Get(i).ForOriginalAndSynonyms([&dfas](UniString const & s) { dfas.emplace_back(s); });
-    MatchInTrie(dfas, TrieRootPrefix<ValueList>(*postcodesRoot, edge), intersector);
+    MatchInTrie(dfas, TrieRootPrefix<ValueList>(*postcodesRoot, edge), intersector, numVisitedNodes);
 
     intersector.NextStep();
   }
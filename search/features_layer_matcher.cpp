@@ -63,6 +63,7 @@ std::vector<uint32_t> const & FeaturesLayerMatcher::GetPlaceAddrFeatures(
   ASSERT(fn, ());
 
   auto const res = m_place2address.Get(placeId);
+  CountCacheAccess(res.second);
   if (res.second)
   {
     auto & value = m_context->m_value;
@@ -102,6 +103,7 @@ uint32_t FeaturesLayerMatcher::GetMatchingStreet(FeatureType & feature)
 FeaturesLayerMatcher::Streets const & FeaturesLayerMatcher::GetNearbyStreets(FeatureType & feature)
 {
   auto entry = m_nearbyStreetsCache.Get(feature.GetID().m_index);
+  CountCacheAccess(entry.second);
   if (!entry.second)
     return entry.first;
 
@@ -118,6 +120,7 @@ uint32_t FeaturesLayerMatcher::GetMatchingStreetImpl(FeatureID const & id, Featu
 
   // Check the cached result value.
   auto entry = m_matchingStreetsCache.Get(id.m_index);
+  CountCacheAccess(entry.second);
   if (!edited && !entry.second)
     return entry.first;
 
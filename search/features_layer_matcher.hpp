@@ -11,6 +11,7 @@
 #include "search/reverse_geocoder.hpp"
 #include "search/stats_cache.hpp"
 #include "search/street_vicinity_loader.hpp"
+#include "search/tracer.hpp"
 
 #include "indexer/feature.hpp"
 #include "indexer/feature_algo.hpp"
@@ -375,15 +376,30 @@ private:
 //      return res.first->second;
 //    };
 
+    // Precomputed street -> houses adjacency makes street geometry decoding and
+    // geometry index probes in the street's vicinity unnecessary.
+    auto const * street2houses = m_context->GetStreetToHousesTable();
+    std::vector<uint32_t> houses;
+
     for (uint32_t streetId : streets)
     {
       BailIfCancelled();
 
-      StreetVicinityLoader::Street const & street = m_loader.GetStreet(streetId);
-      if (street.IsEmpty())
-        continue;
+      std::vector<uint32_t> const * streetHouses = &houses;
+      if (street2houses)
+      {
+        if (!street2houses->Get(streetId, houses))
+          continue;
+      }
+      else
+      {
+        StreetVicinityLoader::Street const & street = m_loader.GetStreet(streetId);
+        if (street.IsEmpty())
+          continue;
+        streetHouses = &street.m_features;
+      }
 
-      for (uint32_t houseId : street.m_features)
+      for (uint32_t houseId : *streetHouses)
       {
         if (houseNumberFilter(houseId, streetId))
           fn(houseId, streetId);
@@ -461,6 +477,11 @@ private:
 
   Streets const & GetNearbyStreets(FeatureType & feature);
 
+  static void CountCacheAccess(bool isNew)
+  {
+    Tracer::Inc(isNew ? Tracer::Profile::Counter::CacheMisses : Tracer::Profile::Counter::CacheHits);
+  }
+
   std::unique_ptr<FeatureType> GetByIndex(uint32_t id) const
   {
     /// @todo Add Cache for feature id -> (point, name / house number).
@@ -651,6 +651,7 @@ void Geocoder::GoImpl(vector<MwmInfoPtr> const & infos, bool inViewport)
 
 void Geocoder::InitBaseContext(BaseContext & ctx)
 {
+  Tracer::ScopedPhase phase(m_params.m_tracer.get(), Tracer::Profile::Phase::Retrieval);
   Retrieval retrieval(*m_context, m_cancellable);
 
   size_t const numTokens = m_params.GetNumTokens();
@@ -674,6 +675,7 @@ void Geocoder::InitBaseContext(BaseContext & ctx)
       ctx.m_features[i] = retrieval.RetrieveAddressFeatures(m_tokenRequests[i]);
     }
   }
+  Tracer::Inc(Tracer::Profile::Counter::TrieNodesVisited, retrieval.GetNumVisitedTrieNodes());
 
   ctx.m_cuisineFilter = m_cuisineFilter.MakeScopedFilter(*m_context, m_params.m_cuisineTypes);
 }
@@ -1783,6 +1785,7 @@ void Geocoder::FindPaths(BaseContext & ctx)
     return true;
   };
 
+  Tracer::ScopedPhase phase(m_params.m_tracer.get(), Tracer::Profile::Phase::LayersMatching);
   m_finder.ForEachReachableVertex(*m_matcher, sortedLayers, [&](IntersectionResult const & result)
   {
     ASSERT(result.IsValid(), ());
@@ -1966,13 +1969,17 @@ void Geocoder::MatchUnclassified(BaseContext & ctx, size_t curToken)
 
 CBV Geocoder::RetrievePostcodeFeatures(MwmContext const & context, TokenSlice const & slice)
 {
+  Tracer::ScopedPhase phase(m_params.m_tracer.get(), Tracer::Profile::Phase::Retrieval);
   Retrieval retrieval(context, m_cancellable);
-  return CBV(retrieval.RetrievePostcodeFeatures(slice));
+  CBV features(retrieval.RetrievePostcodeFeatures(slice));
+  Tracer::Inc(Tracer::Profile::Counter::TrieNodesVisited, retrieval.GetNumVisitedTrieNodes());
+  return features;
 }
 
 CBV Geocoder::RetrieveGeometryFeatures(MwmContext const & context, m2::RectD const & rect,
                                        RectId id)
 {
+  Tracer::ScopedPhase phase(m_params.m_tracer.get(), Tracer::Profile::Phase::Retrieval);
   switch (id)
   {
   case RectId::Pivot: return m_pivotRectsCache.Get(context, rect, m_params.m_scale);
@@ -16,6 +16,7 @@
 
 #include "defines.hpp"
 
+#include <algorithm>
 #include <vector>
 
 namespace search
@@ -63,6 +64,47 @@ private:
   unique_ptr<Map> m_map;
 };
 
+class EliasFanoStreetMap : public StreetToHousesTable
+{
+public:
+  using Map = MapUint32ToValue<vector<uint32_t>>;
+
+  explicit EliasFanoStreetMap(unique_ptr<Reader> && reader) : m_reader(std::move(reader))
+  {
+    ASSERT(m_reader, ());
+    auto readBlockCallback = [](auto & source, uint32_t blockSize, vector<vector<uint32_t>> & values)
+    {
+      values.clear();
+      values.reserve(blockSize);
+      while (values.size() < blockSize && source.Size() > 0)
+      {
+        // Houses of a street are sorted, each id is encoded as a delta from the previous one.
+        auto & houses = values.emplace_back(ReadVarUint<uint32_t>(source));
+        uint32_t prev = 0;
+        for (auto & id : houses)
+        {
+          prev += ReadVarUint<uint32_t>(source);
+          id = prev;
+        }
+      }
+    };
+
+    m_map = Map::Load(*m_reader, readBlockCallback);
+    ASSERT(m_map.get(), ());
+  }
+
+  // StreetToHousesTable overrides:
+  bool Get(uint32_t streetId, vector<uint32_t> & houses) const override
+  {
+    houses.clear();
+    return m_map->Get(streetId, houses);
+  }
+
+private:
+  unique_ptr<Reader> m_reader;
+  unique_ptr<Map> m_map;
+};
+
 class DummyTable : public HouseToStreetTable
 {
 public:
@@ -70,6 +112,30 @@ public:
   std::optional<Result> Get(uint32_t /* houseId */) const override { return {}; }
 };
 
+// Writes the section header followed by the table written with |freezeTable|.
+template <typename FreezeTable>
+void FreezeWithHeader(Writer & writer, FreezeTable && freezeTable)
+{
+  uint64_t const startOffset = writer.Pos();
+  CHECK(coding::IsAlign8(startOffset), ());
+
+  HouseToStreetTable::Header header;
+  header.Serialize(writer);
+
+  uint64_t bytesWritten = writer.Pos();
+  coding::WritePadding(writer, bytesWritten);
+
+  header.m_tableOffset = base::asserted_cast<uint32_t>(writer.Pos() - startOffset);
+  freezeTable(writer);
+  header.m_tableSize =
+      base::asserted_cast<uint32_t>(writer.Pos() - header.m_tableOffset - startOffset);
+
+  auto const endOffset = writer.Pos();
+  writer.Seek(startOffset);
+  header.Serialize(writer);
+  writer.Seek(endOffset);
+}
+
 unique_ptr<HouseToStreetTable> LoadHouseTableImpl(MwmValue const & value, std::string const & tag)
 {
   unique_ptr<HouseToStreetTable> result;
@@ -111,6 +177,31 @@ std::unique_ptr<HouseToStreetTable> LoadHouseToPlaceTable(MwmValue const & value
   return LoadHouseTableImpl(value, FEATURE2PLACE_FILE_TAG);
 }
 
+std::unique_ptr<StreetToHousesTable> LoadStreetToHousesTable(MwmValue const & value)
+{
+  if (!value.m_cont.IsExist(STREET2FEATURE_FILE_TAG))
+    return {};
+
+  try
+  {
+    FilesContainerR::TReader reader = value.m_cont.GetReader(STREET2FEATURE_FILE_TAG);
+
+    StreetToHousesTable::Header header;
+    ReaderSource source(reader);
+    header.Read(source);
+    CHECK(header.m_version == HouseToStreetTable::Version::V2, ());
+
+    auto subreader = reader.GetPtr()->CreateSubReader(header.m_tableOffset, header.m_tableSize);
+    CHECK(subreader, ());
+    return make_unique<EliasFanoStreetMap>(std::move(subreader));
+  }
+  catch (Reader::OpenException const & ex)
+  {
+    LOG(LERROR, (ex.Msg()));
+  }
+  return {};
+}
+
 // HouseToStreetTableBuilder -----------------------------------------------------------------------
 void HouseToStreetTableBuilder::Put(uint32_t houseId, uint32_t streetId)
 {
@@ -119,15 +210,6 @@ void HouseToStreetTableBuilder::Put(uint32_t houseId, uint32_t streetId)
 
 void HouseToStreetTableBuilder::Freeze(Writer & writer) const
 {
-  uint64_t const startOffset = writer.Pos();
-  CHECK(coding::IsAlign8(startOffset), ());
-
-  HouseToStreetTable::Header header;
-  header.Serialize(writer);
-
-  uint64_t bytesWritten = writer.Pos();
-  coding::WritePadding(writer, bytesWritten);
-
   // Each street id is encoded as delta from some prediction.
   // First street id in the block encoded as VarUint, all other street ids in the block
   // encoded as VarInt delta from previous id
@@ -144,14 +226,43 @@ void HouseToStreetTableBuilder::Freeze(Writer & writer) const
     }
   };
 
-  header.m_tableOffset = base::asserted_cast<uint32_t>(writer.Pos() - startOffset);
-  m_builder.Freeze(writer, writeBlockCallback);
-  header.m_tableSize =
-      base::asserted_cast<uint32_t>(writer.Pos() - header.m_tableOffset - startOffset);
+  FreezeWithHeader(writer, [&](Writer & w) { m_builder.Freeze(w, writeBlockCallback); });
+}
 
-  auto const endOffset = writer.Pos();
-  writer.Seek(startOffset);
-  header.Serialize(writer);
-  writer.Seek(endOffset);
+// StreetToHousesTableBuilder ----------------------------------------------------------------------
+void StreetToHousesTableBuilder::Put(uint32_t houseId, uint32_t streetId)
+{
+  m_street2houses[streetId].push_back(houseId);
+}
+
+void StreetToHousesTableBuilder::Freeze(Writer & writer) const
+{
+  MapUint32ToValueBuilder<vector<uint32_t>> builder;
+  for (auto const & [streetId, houses] : m_street2houses)
+  {
+    auto sorted = houses;
+    sort(sorted.begin(), sorted.end());
+    sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+    builder.Put(streetId, std::move(sorted));
+  }
+
+  auto const writeBlockCallback = [](auto & w, auto begin, auto end)
+  {
+    for (auto it = begin; it != end; ++it)
+    {
+      WriteVarUint(w, base::asserted_cast<uint32_t>(it->size()));
+      uint32_t prev = 0;
+      for (uint32_t const id : *it)
+      {
+        WriteVarUint(w, id - prev);
+        prev = id;
+      }
+    }
+  };
+
+  // Lists of houses are much larger than single street ids, so use smaller blocks
+  // to decode less on every lookup.
+  uint16_t constexpr kBlockSize = 16;
+  FreezeWithHeader(writer, [&](Writer & w) { builder.Freeze(w, writeBlockCallback, kBlockSize); });
 }
 }  // namespace search
@@ -3,7 +3,10 @@
 
 #include "coding/map_uint32_to_val.hpp"
 
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <vector>
 
 class MwmValue;
 class Writer;
@@ -12,6 +15,8 @@ namespace search
 {
 std::unique_ptr<HouseToStreetTable> LoadHouseToStreetTable(MwmValue const & value);
 std::unique_ptr<HouseToStreetTable> LoadHouseToPlaceTable(MwmValue const & value);
+// Returns nullptr when the mwm has no STREET2FEATURE_FILE_TAG section.
+std::unique_ptr<StreetToHousesTable> LoadStreetToHousesTable(MwmValue const & value);
 
 class HouseToStreetTableBuilder
 {
@@ -22,4 +27,14 @@ public:
 private:
   MapUint32ToValueBuilder<uint32_t> m_builder;
 };
+
+class StreetToHousesTableBuilder
+{
+public:
+  void Put(uint32_t houseId, uint32_t streetId);
+  void Freeze(Writer & writer) const;
+
+private:
+  std::map<uint32_t, std::vector<uint32_t>> m_street2houses;
+};
 }  // namespace search
@@ -1,5 +1,6 @@
 #include "search/mwm_context.hpp"
 #include "search/house_to_street_table.hpp"
+#include "search/tracer.hpp"
 
 #include "indexer/cell_id.hpp"
 #include "indexer/fake_feature_ids.hpp"
@@ -33,6 +34,8 @@ MwmContext::MwmContext(MwmSet::MwmHandle handle, MwmType type)
 
 std::unique_ptr<FeatureType> MwmContext::GetFeature(uint32_t index) const
 {
+  Tracer::Inc(Tracer::Profile::Counter::FeaturesLoaded);
+
   std::unique_ptr<FeatureType> ft;
   switch (GetEditedStatus(index))
   {
@@ -53,6 +56,20 @@ std::unique_ptr<FeatureType> MwmContext::GetFeature(uint32_t index) const
   UNREACHABLE();
 }
 
+StreetToHousesTable const * MwmContext::GetStreetToHousesTable() const
+{
+  if (!m_value.m_street2houses)
+    m_value.m_street2houses = LoadStreetToHousesTable(m_value);
+  return m_value.m_street2houses.get();
+}
+
+TypesPostings const * MwmContext::GetTypesPostings() const
+{
+  if (!m_value.m_typesPostings)
+    m_value.m_typesPostings = TypesPostings::Load(m_value);
+  return m_value.m_typesPostings.get();
+}
+
 std::optional<uint32_t> MwmContext::GetStreet(uint32_t index) const
 {
   /// @todo Should store and fetch parent street id in Editor (now it has only name).
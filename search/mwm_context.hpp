@@ -108,6 +108,11 @@ public:
 
   std::optional<uint32_t> GetStreet(uint32_t index) const;
 
+  // Returns nullptr for mwms without precomputed street -> houses adjacency.
+  StreetToHousesTable const * GetStreetToHousesTable() const;
+  // Returns nullptr when the mwm has no types postings section.
+  TypesPostings const * GetTypesPostings() const;
+
   MwmSet::MwmHandle m_handle;
   MwmValue & m_value;
 
@@ -121,13 +126,11 @@ private:
   void ForEachIndexImpl(covering::Intervals const & intervals, uint32_t scale, Fn && fn) const
   {
     CheckUniqueIndexes checkUnique;
-    for (auto const & i : intervals)
-      m_index.ForEachInIntervalAndScale(i.first, i.second, scale,
-          [&](uint64_t /* key */, uint32_t value)
-          {
-            if (checkUnique(value))
-              fn(value);
-          });
+    m_index.ForEachInIntervalsAndScale(intervals, scale, [&](uint64_t /* key */, uint32_t value)
+    {
+      if (checkUnique(value))
+        fn(value);
+    });
   }
 
   FeaturesVector m_vector;
@@ -253,13 +253,20 @@ void PreRanker::Filter()
 
 void PreRanker::UpdateResults(bool lastUpdate)
 {
-  FilterRelaxedResults(lastUpdate);
-  FillMissingFieldsInPreResults();
-  Filter();
+  auto * tracer = m_params.m_tracer.get();
+  {
+    Tracer::ScopedPhase phase(tracer, Tracer::Profile::Phase::PreRanking);
+    FilterRelaxedResults(lastUpdate);
+    FillMissingFieldsInPreResults();
+    Filter();
+  }
   m_numSentResults += m_results.size();
   m_ranker.AddPreRankerResults(std::move(m_results));
   m_results.clear();
-  m_ranker.UpdateResults(lastUpdate);
+  {
+    Tracer::ScopedPhase phase(tracer, Tracer::Profile::Phase::Ranking);
+    m_ranker.UpdateResults(lastUpdate);
+  }
 
   if (lastUpdate && !m_currEmit.empty())
     m_currEmit.swap(m_prevEmit);
@@ -3,6 +3,7 @@
 #include "search/intermediate_result.hpp"
 #include "search/nested_rects_cache.hpp"
 #include "search/ranker.hpp"
+#include "search/tracer.hpp"
 
 #include "geometry/point2d.hpp"
 #include "geometry/rect2d.hpp"
@@ -11,6 +12,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
@@ -57,6 +59,9 @@ public:
     bool m_categorialRequest = false;
 
     size_t m_numQueryTokens = 0;
+
+    // Collects the pre-ranking and ranking timings when not null.
+    std::shared_ptr<Tracer> m_tracer;
   };
 
   PreRanker(DataSource const & dataSource, Ranker & ranker);
@@ -11,6 +11,7 @@
 #include "search/query_params.hpp"
 #include "search/ranking_utils.hpp"
 #include "search/search_params.hpp"
+#include "search/tracer.hpp"
 #include "search/utils.hpp"
 #include "search/utm_mgrs_coords_match.hpp"
 
@@ -336,6 +337,11 @@ void Processor::LoadCitiesBoundaries()
 
 void Processor::LoadCountriesTree() { m_ranker.LoadCountriesTree(); }
 
+void Processor::SetBookmarksIndex(shared_ptr<bookmarks::DiskIndex> index, bool updateIndex)
+{
+  m_bookmarksProcessor.SetIndex(std::move(index), updateIndex);
+}
+
 void Processor::EnableIndexingOfBookmarksDescriptions(bool enable)
 {
   m_bookmarksProcessor.EnableIndexingOfDescriptions(enable);
@@ -547,6 +553,9 @@ void Processor::ForEachCategoryTypeFuzzy(StringSliceBase const & slice, ToDo &&
 
 void Processor::Search(SearchParams params)
 {
+  // The work done by the search thread is counted to the request's tracer.
+  Tracer::ScopedProfile profile(params.m_tracer.get());
+
   /// @DebugNote
   // Comment this line to run search in a debugger.
   SetDeadline(chrono::steady_clock::now() + params.m_timeout);
@@ -902,6 +911,7 @@ void Processor::InitPreRanker(Geocoder::Params const & geocoderParams,
   params.m_viewportSearch = viewportSearch;
   params.m_categorialRequest = geocoderParams.IsCategorialRequest();
   params.m_numQueryTokens = geocoderParams.GetNumTokens();
+  params.m_tracer = searchParams.m_tracer;
 
   m_preRanker.Init(params);
 }
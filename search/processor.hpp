@@ -93,6 +93,7 @@ public:
   void LoadCitiesBoundaries();
   void LoadCountriesTree();
 
+  void SetBookmarksIndex(std::shared_ptr<bookmarks::DiskIndex> index, bool updateIndex);
   void EnableIndexingOfBookmarksDescriptions(bool enable);
   void EnableIndexingOfBookmarkGroup(bookmarks::GroupId const & groupId, bool enable);
 
@@ -7,6 +7,7 @@
 #include "search/pre_ranking_info.hpp"
 #include "search/ranking_utils.hpp"
 #include "search/token_slice.hpp"
+#include "search/tracer.hpp"
 
 #include "indexer/brands_holder.hpp"
 #include "indexer/data_source.hpp"
@@ -435,6 +436,7 @@ private:
 
   static unique_ptr<FeatureType> LoadFeatureImpl(FeatureID const & id, FeaturesLoaderGuard & loader)
   {
+    Tracer::Inc(Tracer::Profile::Counter::FeaturesLoaded);
     auto ft = loader.GetFeatureByIndex(id.m_index);
     if (ft)
     {
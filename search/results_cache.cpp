@@ -0,0 +1,123 @@
+#include "search/results_cache.hpp"
+
+#include "search/search_params.hpp"
+
+#include "indexer/cell_id.hpp"
+#include "indexer/search_string_utils.hpp"
+
+#include "geometry/mercator.hpp"
+
+#include "base/string_utils.hpp"
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace search
+{
+using namespace std;
+
+namespace
+{
+int64_t GetPivotCell(m2::PointD pt)
+{
+  mercator::ClampPoint(pt);
+  return CellIdConverter<mercator::Bounds, RectId>::ToCellId(pt.x, pt.y)
+      .AncestorAtLevel(ResultsCache::kPivotCellLevel)
+      .ToInt64(RectId::DEPTH_LEVELS);
+}
+}  // namespace
+
+ResultsCache::ResultsCache(size_t maxSize) : m_cache(maxSize) {}
+
+// static
+string ResultsCache::MakeKey(SearchParams const & params)
+{
+  // Only the main search modes are cached, tracer needs the actual search run.
+  if ((params.m_mode != Mode::Everywhere && params.m_mode != Mode::Viewport) || params.m_tracer)
+    return {};
+
+  auto const & viewport = params.m_viewport;
+  if (!viewport.IsValid())
+    return {};
+
+  vector<strings::UniString> tokens;
+  bool const isPrefix = TokenizeStringAndCheckIfLastTokenIsPrefix(params.m_query, tokens);
+
+  ostringstream os;
+  os << static_cast<int>(params.m_mode) << '|' << params.m_inputLocale << '|';
+  for (auto const & token : tokens)
+    os << strings::ToUtf8(token) << ' ';
+  os << (isPrefix ? 'p' : 'f') << '|';
+
+  // Same as Processor::GetPivotPoint().
+  bool const viewportSearch = params.m_mode == Mode::Viewport;
+  m2::PointD pivot = viewport.Center();
+  if (!viewportSearch && params.m_position && viewport.IsPointInside(*params.m_position))
+    pivot = *params.m_position;
+  os << GetPivotCell(pivot) << '|';
+
+  // Viewport results are limited by the viewport, so it is quantized as well,
+  // otherwise only the viewport scale matters.
+  if (viewportSearch)
+    os << GetPivotCell(viewport.LeftBottom()) << ',' << GetPivotCell(viewport.RightTop()) << '|';
+  else
+    os << static_cast<int>(floor(log2(max(viewport.SizeX(), viewport.SizeY())))) << '|';
+
+  os << params.m_maxNumResults << '|' << params.m_batchSize << '|'
+     << params.m_categorialRequest << params.m_suggestsEnabled << params.m_needAddress
+     << params.m_needHighlighting << params.m_useDebugInfo << '|'
+     << params.m_minDistanceOnMapBetweenResults.x << ',' << params.m_minDistanceOnMapBetweenResults.y << '|'
+     << params.m_filteringParams.m_streetSearchRadiusM << ',' << params.m_filteringParams.m_maxStreetsCount
+     << ',' << params.m_filteringParams.m_streetClusterRadiusMercator;
+  return os.str();
+}
+
+bool ResultsCache::Get(string const & key, Results & results)
+{
+  lock_guard<mutex> lock(m_mu);
+
+  if (auto const * cached = m_cache.Get(key))
+  {
+    ++m_stats.m_hits;
+    results = *cached;
+    return true;
+  }
+
+  ++m_stats.m_misses;
+  return false;
+}
+
+void ResultsCache::Put(string const & key, Results const & results)
+{
+  ASSERT(results.IsEndedNormal(), ());
+
+  lock_guard<mutex> lock(m_mu);
+  bool found;
+  m_cache.Find(key, found) = results;
+}
+
+void ResultsCache::Clear()
+{
+  lock_guard<mutex> lock(m_mu);
+  m_cache.Clear();
+  ++m_stats.m_clears;
+}
+
+ResultsCache::Stats ResultsCache::GetStats() const
+{
+  lock_guard<mutex> lock(m_mu);
+  return m_stats;
+}
+
+string DebugPrint(ResultsCache::Stats const & stats)
+{
+  ostringstream os;
+  os << "ResultsCache::Stats [";
+  os << "hits: " << stats.m_hits << ", ";
+  os << "misses: " << stats.m_misses << ", ";
+  os << "clears: " << stats.m_clears;
+  os << "]";
+  return os.str();
+}
+}  // namespace search
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "search/result.hpp"
+
+#include "base/lru_cache.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace search
+{
+struct SearchParams;
+
+// Thread-safe LRU cache of complete search results.
+//
+// Results are keyed by the normalized query tokens, search mode, locale,
+// parameters which affect the results and the search pivot quantized to
+// a cell, so the same query issued again from about the same place is
+// answered without running the search.
+class ResultsCache
+{
+public:
+  struct Stats
+  {
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    // Number of Clear() calls, i.e. cache invalidations.
+    uint64_t m_clears = 0;
+  };
+
+  // Side of the cell the pivot is quantized to, 2^-kPivotCellLevel of the world width.
+  static int constexpr kPivotCellLevel = 14;
+
+  explicit ResultsCache(size_t maxSize);
+
+  // Returns an empty key for requests which can't be cached.
+  static std::string MakeKey(SearchParams const & params);
+
+  // Returns true and fills |results| when there are cached results for |key|.
+  bool Get(std::string const & key, Results & results);
+  void Put(std::string const & key, Results const & results);
+
+  void Clear();
+
+  Stats GetStats() const;
+
+private:
+  mutable std::mutex m_mu;
+  LruCache<std::string, Results> m_cache;
+  Stats m_stats;
+};
+
+std::string DebugPrint(ResultsCache::Stats const & stats);
+}  // namespace search
@@ -15,6 +15,7 @@
 #include "indexer/feature_source.hpp"
 #include "indexer/search_string_utils.hpp"
 #include "indexer/trie_reader.hpp"
+#include "indexer/types_postings.hpp"
 
 #include "platform/mwm_version.hpp"
 
@@ -96,6 +97,8 @@ public:
     m_created = editor.GetFeaturesByStatus(id, FeatureStatus::Created);
   }
 
+  bool Empty() const { return m_deleted.empty() && m_modified.empty() && m_created.empty(); }
+
   bool ModifiedOrDeleted(uint32_t featureIndex) const
   {
     return binary_search(m_deleted.begin(), m_deleted.end(), featureIndex) ||
@@ -242,7 +245,8 @@ template <typename Value, typename DFA>
 Retrieval::ExtendedFeatures RetrieveAddressFeaturesImpl(Retrieval::TrieRoot<Value> const & root,
                                                         MwmContext const & context,
                                                         base::Cancellable const & cancellable,
-                                                        SearchTrieRequest<DFA> const & request)
+                                                        SearchTrieRequest<DFA> const & request,
+                                                        uint64_t * numVisitedTrieNodes)
 {
   EditedFeaturesHolder holder(context.GetId());
   vector<uint64_t> features;
@@ -254,7 +258,7 @@ Retrieval::ExtendedFeatures RetrieveAddressFeaturesImpl(Retrieval::TrieRoot<Valu
       [&holder](Value const & value) {
         return !holder.ModifiedOrDeleted(base::asserted_cast<uint32_t>(value.m_featureId));
       } /* filter */,
-      collector);
+      collector, numVisitedTrieNodes);
 
   holder.ForEachModifiedOrCreated([&](EditableMapObject const & emo, uint64_t index) {
     auto const matched = MatchFeatureByNameAndType(emo, request);
@@ -273,7 +277,8 @@ template <typename Value>
 Retrieval::ExtendedFeatures RetrievePostcodeFeaturesImpl(Retrieval::TrieRoot<Value> const & root,
                                                          MwmContext const & context,
                                                          base::Cancellable const & cancellable,
-                                                         TokenSlice const & slice)
+                                                         TokenSlice const & slice,
+                                                         uint64_t * numVisitedTrieNodes)
 {
   EditedFeaturesHolder holder(context.GetId());
   vector<uint64_t> features;
@@ -285,7 +290,7 @@ Retrieval::ExtendedFeatures RetrievePostcodeFeaturesImpl(Retrieval::TrieRoot<Val
       [&holder](Value const & value) {
         return !holder.ModifiedOrDeleted(base::asserted_cast<uint32_t>(value.m_featureId));
       } /* filter */,
-      collector);
+      collector, numVisitedTrieNodes);
 
   holder.ForEachModifiedOrCreated([&](EditableMapObject const & emo, uint64_t index) {
     if (MatchFeatureByPostcode(emo, slice))
@@ -409,11 +414,55 @@ Retrieval::Features Retrieval::RetrieveGeometryFeatures(m2::RectD const & rect,
   return RetrieveGeometryFeaturesImpl(m_context, m_cancellable, rect, scale).m_features;
 }
 
+optional<Retrieval::Features> Retrieval::RetrieveTypesFeatures(vector<uint32_t> const & types) const
+{
+  auto const * postings = m_context.GetTypesPostings();
+  if (!postings)
+    return {};
+
+  auto const & c = classif();
+  Features features;
+  for (uint32_t const type : types)
+  {
+    BailIfCancelled(m_cancellable);
+    if (auto cbv = postings->Get(c.GetIndexForType(type)))
+      features = features.Union(CBV(std::move(cbv)));
+  }
+
+  EditedFeaturesHolder holder(m_context.GetId());
+  if (holder.Empty())
+    return features;
+
+  // Apply editor changes the same way as for the search index retrieval.
+  vector<uint64_t> ids;
+  features.ForEach([&](uint64_t id)
+  {
+    if (!holder.ModifiedOrDeleted(base::asserted_cast<uint32_t>(id)))
+      ids.push_back(id);
+  });
+
+  auto sortedTypes = types;
+  base::SortUnique(sortedTypes);
+  holder.ForEachModifiedOrCreated([&](EditableMapObject const & emo, uint64_t index)
+  {
+    for (uint32_t const type : emo.GetTypes())
+    {
+      if (binary_search(sortedTypes.begin(), sortedTypes.end(), type))
+      {
+        ids.push_back(index);
+        break;
+      }
+    }
+  });
+
+  return SortFeaturesAndBuildResult(std::move(ids)).m_features;
+}
+
 template <template <typename> class R, typename... Args>
 Retrieval::ExtendedFeatures Retrieval::Retrieve(Args &&... args) const
 {
   R<Uint64IndexValue> r;
   ASSERT(m_root, ());
-  return r(*m_root, m_context, m_cancellable, std::forward<Args>(args)...);
+  return r(*m_root, m_context, m_cancellable, std::forward<Args>(args)..., &m_numVisitedTrieNodes);
 }
 }  // namespace search
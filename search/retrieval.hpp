@@ -18,7 +18,9 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <utility>
+#include <vector>
 
 class MwmValue;
 
@@ -107,6 +109,13 @@ public:
   // Retrieves all features belonging to |rect| from the geometry index.
   Features RetrieveGeometryFeatures(m2::RectD const & rect, int scale) const;
 
+  // Retrieves all features having any of classificator |types| from the precomputed
+  // types postings. Returns nullopt when the mwm has no postings section.
+  std::optional<Features> RetrieveTypesFeatures(std::vector<uint32_t> const & types) const;
+
+  // Total number of search index trie nodes visited by this instance.
+  uint64_t GetNumVisitedTrieNodes() const { return m_numVisitedTrieNodes; }
+
 private:
   template <template <typename> class R, typename... Args>
   ExtendedFeatures Retrieve(Args &&... args) const;
@@ -116,5 +125,7 @@ private:
   ModelReaderPtr m_reader;
 
   std::unique_ptr<TrieRoot<Uint64IndexValue>> m_root;
+
+  mutable uint64_t m_numVisitedTrieNodes = 0;
 };
 }  // namespace search
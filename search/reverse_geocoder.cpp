@@ -9,6 +9,7 @@
 
 #include "editor/osm_editor.hpp"
 
+#include "indexer/cell_id.hpp"
 #include "indexer/data_source.hpp"
 #include "indexer/fake_feature_ids.hpp"
 #include "indexer/feature.hpp"
@@ -16,12 +17,17 @@
 #include "indexer/ftypes_matcher.hpp"
 #include "indexer/scales.hpp"
 
+#include "geometry/parametrized_segment.hpp"
+#include "geometry/triangle2d.hpp"
+
 #include "base/stl_helpers.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <limits>
+#include <utility>
 
 namespace search
 {
@@ -73,6 +79,82 @@ std::string const & GetHouseNumber(FeatureType & ft)
   return hn;
 }
 
+/// Building with a copy of its best geometry, so the distance to it can be calculated
+/// for many points without the feature reloading. Used by GetNearbyAddresses.
+struct BuildingCandidate
+{
+  BuildingCandidate(FeatureType & ft, std::string const & hn)
+    : m_building(FromFeatureImpl(ft, hn, 0.0 /* distMeters */))
+    , m_geomType(ft.GetGeomType())
+    , m_rect(ft.GetLimitRect(FeatureType::BEST_GEOMETRY))
+  {
+    switch (m_geomType)
+    {
+    case feature::GeomType::Point: m_points.push_back(ft.GetCenter()); break;
+    case feature::GeomType::Line:
+      ft.ForEachPoint(base::MakeBackInsertFunctor(m_points), FeatureType::BEST_GEOMETRY);
+      break;
+    default:
+      ft.ForEachTriangle([this](m2::PointD const & p1, m2::PointD const & p2, m2::PointD const & p3)
+      {
+        m_points.push_back(p1);
+        m_points.push_back(p2);
+        m_points.push_back(p3);
+      }, FeatureType::BEST_GEOMETRY);
+    }
+  }
+
+  /// Same as feature::GetMinDistanceMeters for the stored geometry.
+  double GetMinDistanceMeters(m2::PointD const & pt) const
+  {
+    double res = std::numeric_limits<double>::max();
+    auto const updateDistance = [&](m2::PointD const & p1, m2::PointD const & p2)
+    {
+      m2::ParametrizedSegment<m2::PointD> const segment(p1, p2);
+      res = std::min(res, mercator::DistanceOnEarth(segment.ClosestPointTo(pt), pt));
+    };
+
+    switch (m_geomType)
+    {
+    case feature::GeomType::Point:
+      res = mercator::DistanceOnEarth(m_points.front(), pt);
+      break;
+    case feature::GeomType::Line:
+      for (size_t i = 1; i < m_points.size(); ++i)
+        updateDistance(m_points[i - 1], m_points[i]);
+      break;
+    default:
+      for (size_t i = 0; i + 2 < m_points.size(); i += 3)
+      {
+        if (m2::IsPointInsideTriangle(pt, m_points[i], m_points[i + 1], m_points[i + 2]))
+          return 0.0;
+
+        updateDistance(m_points[i], m_points[i + 1]);
+        updateDistance(m_points[i + 1], m_points[i + 2]);
+        updateDistance(m_points[i + 2], m_points[i]);
+      }
+    }
+    return res;
+  }
+
+  ReverseGeocoder::Building m_building;
+  feature::GeomType m_geomType;
+  m2::RectD m_rect;
+  std::vector<m2::PointD> m_points;
+};
+
+/// @return Level of cells to group points in GetNearbyAddresses.
+/// Cell side is not less than doubled lookup radius, so buildings loaded for a cell
+/// are mostly relevant for all of its points.
+int GetBatchCellLevel(double maxDistanceM)
+{
+  double const minCellSize = 2.0 * mercator::MetersToMercator(std::max(maxDistanceM, 1.0));
+  int level = RectId::DEPTH_LEVELS - 1;
+  while (level > 0 && mercator::Bounds::kRangeX / static_cast<double>(1 << level) < minCellSize)
+    --level;
+  return level;
+}
+
 }  // namespace
 
 ReverseGeocoder::ReverseGeocoder(DataSource const & dataSource) : m_dataSource(dataSource) {}
@@ -215,6 +297,136 @@ bool ReverseGeocoder::GetExactAddress(FeatureID const & fid, Address & addr) con
   return res;
 }
 
+void ReverseGeocoder::GetNearbyAddresses(vector<m2::PointD> const & points, double maxDistanceM,
+                                         vector<Address> & addrs, size_t threadsCount) const
+{
+  addrs.assign(points.size(), {});
+  if (points.empty())
+    return;
+
+  auto const toCellId = [&points](size_t i)
+  {
+    auto pt = points[i];
+    mercator::ClampPoint(pt);
+    return CellIdConverter<mercator::Bounds, RectId>::ToCellId(pt.x, pt.y);
+  };
+
+  // Sort points along Z-order curve, so points of the same cell of any level are adjacent.
+  vector<pair<int64_t, size_t>> cellToPoint;
+  cellToPoint.reserve(points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+    cellToPoint.emplace_back(toCellId(i).ToInt64(RectId::DEPTH_LEVELS), i);
+  sort(cellToPoint.begin(), cellToPoint.end());
+
+  vector<size_t> order;
+  order.reserve(cellToPoint.size());
+  for (auto const & cp : cellToPoint)
+    order.push_back(cp.second);
+
+  // Split sorted points into [beg, end) ranges of the same cell.
+  int const level = GetBatchCellLevel(maxDistanceM);
+  vector<pair<size_t, size_t>> cells;
+  for (size_t beg = 0; beg < order.size();)
+  {
+    auto const cell = toCellId(order[beg]).AncestorAtLevel(level);
+    size_t end = beg + 1;
+    while (end < order.size() && toCellId(order[end]).AncestorAtLevel(level) == cell)
+      ++end;
+    cells.emplace_back(beg, end);
+    beg = end;
+  }
+
+  // Each range of cells has its own HouseTable (and own mwm handles), so workers do not share
+  // lazily loaded house->street tables.
+  auto const processCells = [&](size_t from, size_t to)
+  {
+    HouseTable table(m_dataSource);
+    for (size_t i = from; i < to; ++i)
+    {
+      GetNearbyAddressesInCell(points, order.data() + cells[i].first, order.data() + cells[i].second,
+                               maxDistanceM, table, addrs);
+    }
+  };
+
+  threadsCount = min(max(threadsCount, size_t(1)), cells.size());
+  if (threadsCount == 1)
+  {
+    processCells(0, cells.size());
+    return;
+  }
+
+  // Several chunks per thread for better balancing between dense and sparse regions.
+  size_t const chunksCount = min(cells.size(), threadsCount * 4);
+  base::ComputationalThreadPool pool(threadsCount);
+  for (size_t i = 0; i < chunksCount; ++i)
+    pool.SubmitWork(processCells, cells.size() * i / chunksCount, cells.size() * (i + 1) / chunksCount);
+  pool.WaitingStop();
+}
+
+void ReverseGeocoder::GetNearbyAddressesInCell(vector<m2::PointD> const & points,
+                                               size_t const * beg, size_t const * end,
+                                               double maxDistanceM, HouseTable & table,
+                                               vector<Address> & addrs) const
+{
+  m2::RectD rect;
+  for (auto it = beg; it != end; ++it)
+    rect.Add(GetLookupRect(points[*it], maxDistanceM));
+
+  vector<BuildingCandidate> candidates;
+  m_dataSource.ForEachInRect([&](FeatureType & ft)
+  {
+    std::string const & hn = GetHouseNumber(ft);
+    if (!hn.empty())
+      candidates.emplace_back(ft, hn);
+  }, rect, kQueryScale);
+
+  if (candidates.empty())
+    return;
+
+  // Address of a building depends on the building only, so it is resolved once per cell.
+  enum class State : uint8_t { Unknown, Found, NotFound };
+  vector<State> states(candidates.size(), State::Unknown);
+  vector<Address> resolved(candidates.size());
+
+  vector<pair<double, size_t>> nearest;
+  for (auto it = beg; it != end; ++it)
+  {
+    m2::PointD const & center = points[*it];
+    m2::RectD const lookupRect = GetLookupRect(center, maxDistanceM);
+
+    nearest.clear();
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+      if (!lookupRect.IsIntersect(candidates[i].m_rect))
+        continue;
+      double const distance = candidates[i].GetMinDistanceMeters(center);
+      if (distance <= maxDistanceM)
+        nearest.emplace_back(distance, i);
+    }
+
+    size_t const triesCount = min(nearest.size(), kMaxNumTriesToApproxAddress);
+    partial_sort(nearest.begin(), nearest.begin() + triesCount, nearest.end());
+
+    for (size_t i = 0; i < triesCount; ++i)
+    {
+      auto const [distance, index] = nearest[i];
+      if (states[index] == State::Unknown)
+      {
+        bool const found = GetNearbyAddress(table, candidates[index].m_building,
+                                            false /* ignoreEdits */, resolved[index]);
+        states[index] = found ? State::Found : State::NotFound;
+      }
+
+      if (states[index] == State::Found)
+      {
+        addrs[*it] = resolved[index];
+        addrs[*it].m_building.m_distanceMeters = distance;
+        break;
+      }
+    }
+  }
+}
+
 bool ReverseGeocoder::GetNearbyAddress(HouseTable & table, Building const & bld, bool ignoreEdits,
                                        Address & addr) const
 {
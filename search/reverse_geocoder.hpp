@@ -153,6 +153,14 @@ public:
 
   bool GetExactAddress(FeatureID const & fid, Address & addr) const;
 
+  /// Batch version of GetNearbyAddress(center, maxDistanceM, addr) for a big number of points.
+  /// Points are sorted by cell ids and grouped into cells comparable with |maxDistanceM|,
+  /// nearby buildings and their streets are loaded once per cell and are shared by all points
+  /// of the cell. Cells are processed in parallel by |threadsCount| threads.
+  /// @param[out] addrs  Addresses in the same order as |points|, invalid when nothing was found.
+  void GetNearbyAddresses(std::vector<m2::PointD> const & points, double maxDistanceM,
+                          std::vector<Address> & addrs, size_t threadsCount = 1) const;
+
   /// Returns the nearest region address where mwm or exact city is known.
   static RegionAddress GetNearbyRegionAddress(m2::PointD const & center,
                                               storage::CountryInfoGetter const & infoGetter,
@@ -181,6 +189,11 @@ private:
   bool GetNearbyAddress(HouseTable & table, Building const & bld, bool ignoreEdits,
                         Address & addr) const;
 
+  /// Fills |addrs| for |points| with indices [beg, end) from the same cell of GetNearbyAddresses.
+  void GetNearbyAddressesInCell(std::vector<m2::PointD> const & points, size_t const * beg,
+                                size_t const * end, double maxDistanceM, HouseTable & table,
+                                std::vector<Address> & addrs) const;
+
   /// @return Sorted by distance houses vector with valid house number.
   void GetNearbyBuildings(m2::PointD const & center, double maxDistanceM,
                           std::vector<Building> & buildings) const;
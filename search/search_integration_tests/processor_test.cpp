@@ -9,6 +9,7 @@
 #include "search/search_tests_support/test_results_matching.hpp"
 #include "search/search_tests_support/test_search_request.hpp"
 
+#include "search/categories_cache.hpp"
 #include "search/cities_boundaries_table.hpp"
 #include "search/features_layer_path_finder.hpp"
 #include "search/mwm_context.hpp"
@@ -16,7 +17,10 @@
 #include "search/token_range.hpp"
 #include "search/token_slice.hpp"
 
+#include "indexer/classificator.hpp"
 #include "indexer/feature_impl.hpp"
+#include "indexer/ftypes_matcher.hpp"
+#include "indexer/search_string_utils.hpp"
 
 #include "geometry/mercator.hpp"
 #include "geometry/point2d.hpp"
@@ -25,6 +29,7 @@
 #include "base/checked_cast.hpp"
 #include "base/scope_guard.hpp"
 #include "base/string_utils.hpp"
+#include "base/uni_string_dfa.hpp"
 
 #include <string>
 #include <tuple>
@@ -3687,4 +3692,68 @@ UNIT_CLASS_TEST(ProcessorTest, NonSearchable_Categories)
   }
 }
 
+UNIT_CLASS_TEST(ProcessorTest, CategoriesCache_TypesPostings)
+{
+  TestStreet street({m2::PointD(0, 0), m2::PointD(1, 1)}, "Main street", "en");
+  TestStreet avenue({m2::PointD(0, 1), m2::PointD(1, 0)}, "Main avenue", "en");
+  TestPOI cafe(m2::PointD(0.5, 0.5), "Cafe", "en");
+  cafe.SetTypes({{"amenity", "cafe"}});
+  TestPOI restaurant(m2::PointD(0.5, 0.6), "Restaurant", "en");
+  restaurant.SetTypes({{"amenity", "restaurant"}});
+  TestPOI bar(m2::PointD(0.6, 0.5), "Bar", "en");
+  bar.SetTypes({{"amenity", "bar"}});
+
+  auto const countryId = BuildCountry("Wonderland", [&](TestMwmBuilder & builder)
+  {
+    builder.Add(street);
+    builder.Add(avenue);
+    builder.Add(cafe);
+    builder.Add(restaurant);
+    builder.Add(bar);
+  });
+
+  MwmContext context(m_dataSource.GetMwmHandleById(countryId));
+  TEST(context.GetTypesPostings(), ());
+  base::Cancellable cancellable;
+
+  // Features of |types| retrieved from the search index, the way CategoriesCache
+  // does it for mwms without the types postings.
+  auto const retrieveFromTrie = [&](vector<uint32_t> const & types)
+  {
+    auto const & c = classif();
+    SearchTrieRequest<strings::UniStringDFA> request;
+    for (uint32_t const type : types)
+    {
+      c.ForEachInSubtree([&](uint32_t descendantType)
+      {
+        request.m_categories.emplace_back(FeatureTypeToString(c.GetIndexForType(descendantType)));
+      }, type);
+    }
+    return Retrieval(context, cancellable).RetrieveAddressFeatures(request).m_features;
+  };
+
+  auto const getFeatures = [](CBV const & cbv)
+  {
+    vector<uint64_t> features;
+    cbv.ForEach([&features](uint64_t id) { features.push_back(id); });
+    return features;
+  };
+
+  {
+    StreetsCache cache(cancellable);
+    auto const & types = ftypes::IsStreetOrSquareChecker::Instance().GetTypes();
+    auto const features = getFeatures(cache.Get(context));
+    TEST_EQUAL(features.size(), 2, ());
+    TEST_EQUAL(features, getFeatures(retrieveFromTrie(types)), ());
+  }
+
+  {
+    vector<uint32_t> const types = {classif().GetTypeByPath({"amenity", "cafe"}),
+                                    classif().GetTypeByPath({"amenity", "bar"})};
+    CategoriesCache cache(types, cancellable);
+    auto const features = getFeatures(cache.Get(context));
+    TEST_EQUAL(features.size(), 2, ());
+    TEST_EQUAL(features, getFeatures(retrieveFromTrie(types)), ());
+  }
+}
 } // namespace processor_test
@@ -1,5 +1,6 @@
 #include "testing/testing.hpp"
 
+#include "search/cbv.hpp"
 #include "search/geocoder_context.hpp"
 #include "search/search_tests_support/helpers.hpp"
 #include "search/search_tests_support/test_results_matching.hpp"
@@ -86,4 +87,65 @@ UNIT_CLASS_TEST(TracerTest, Smoke)
     TEST_EQUAL(expected, actual, ());
   }
 }
+
+UNIT_CLASS_TEST(TracerTest, Profile)
+{
+  using Profile = Tracer::Profile;
+
+  TestCity moscow(m2::PointD(0, 0), "Moscow", "en", 100 /* rank */);
+  TestStreet tverskaya(vector<m2::PointD>{m2::PointD(0, 0), m2::PointD(0, 1)}, "Tverskaya street",
+                       "en");
+  TestBuilding building(m2::PointD(0, 0.5), "", "1", tverskaya.GetName("en"), "en");
+
+  BuildWorld([&](TestMwmBuilder & builder) { builder.Add(moscow); });
+
+  auto const id = BuildCountry("Wonderland", [&](TestMwmBuilder & builder) {
+    builder.Add(tverskaya);
+    builder.Add(building);
+  });
+
+  SearchParams params;
+  params.m_inputLocale = "en";
+  params.m_viewport = m2::RectD(-1, -1, 1, 1);
+  params.m_mode = Mode::Everywhere;
+  params.m_query = "tverskaya 1 ";
+
+  auto tracer = make_shared<Tracer>();
+  params.m_tracer = tracer;
+
+  TestSearchRequest request(m_engine, params);
+  request.Run();
+  auto const & results = request.Results();
+  TEST(!results.empty(), ());
+  TEST(ResultsMatch(vector<Result>{results.front()}, {ExactMatch(id, building)}), (results));
+
+  auto const & profile = tracer->GetProfile();
+  TEST_GREATER(profile.Get(Profile::Counter::TrieNodesVisited), 0, (profile));
+  TEST_GREATER(profile.Get(Profile::Counter::CBVOps), 0, (profile));
+  TEST_GREATER(profile.Get(Profile::Counter::FeaturesLoaded), 0, (profile));
+  TEST_GREATER(profile.Get(Profile::Counter::CacheHits) + profile.Get(Profile::Counter::CacheMisses),
+               0, (profile));
+
+  TEST_GREATER(profile.Get(Profile::Phase::Retrieval).count(), 0, (profile));
+  TEST_GREATER(profile.Get(Profile::Phase::LayersMatching).count(), 0, (profile));
+  TEST_GREATER(profile.Get(Profile::Phase::Ranking).count(), 0, (profile));
+}
+
+UNIT_TEST(Tracer_ScopedProfile)
+{
+  Tracer tracer;
+  CBV const full = CBV::GetFull();
+  {
+    Tracer::ScopedProfile profile(&tracer);
+    full.Intersect(full);
+    {
+      Tracer::ScopedProfile noProfile(nullptr);
+      full.Union(full);
+    }
+    full.Take(10);
+  }
+  full.Union(full);
+
+  TEST_EQUAL(tracer.GetProfile().Get(Tracer::Profile::Counter::CBVOps), 2, ());
+}
 }  // namespace
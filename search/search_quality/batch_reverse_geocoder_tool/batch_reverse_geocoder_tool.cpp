@@ -0,0 +1,188 @@
+// Reads "lat,lon[,...]" CSV rows and writes each input row extended with
+// ",street,house number,distance in meters" of the nearest address.
+// Rows are processed in batches of --batch_size with ReverseGeocoder::GetNearbyAddresses,
+// so the whole input never needs to be kept in memory.
+
+#include "search/search_quality/helpers.hpp"
+
+#include "search/reverse_geocoder.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/data_source.hpp"
+
+#include "platform/platform_tests_support/helpers.hpp"
+
+#include "geometry/mercator.hpp"
+
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+using namespace search::search_quality;
+using namespace search;
+using namespace std;
+
+DEFINE_string(data_path, "", "Path to data directory (resources dir)");
+DEFINE_string(mwm_path, "", "Path to mwm files (writable dir)");
+DEFINE_string(mwm_list_path, "", "Path to a file containing the names of available mwms, one per line");
+DEFINE_string(csv_in, "", "Path to the input csv file with lat,lon in the first columns (default: stdin)");
+DEFINE_string(csv_out, "", "Path to the output csv file (default: stdout)");
+DEFINE_double(max_distance_m, ReverseGeocoder::kLookupRadiusM, "Max distance to the building in meters");
+DEFINE_uint64(batch_size, 100000, "Number of rows geocoded at once");
+DEFINE_int32(num_threads, max(static_cast<int32_t>(thread::hardware_concurrency()), 1),
+             "Number of geocoding threads (default: number of cores)");
+
+namespace
+{
+// Quotes |s| if it contains csv special characters.
+string EscapeCSV(string const & s)
+{
+  if (s.find_first_of(",\"\n") == string::npos)
+    return s;
+
+  string res = "\"";
+  for (char c : s)
+  {
+    if (c == '"')
+      res.push_back('"');
+    res.push_back(c);
+  }
+  res.push_back('"');
+  return res;
+}
+
+bool ParsePoint(string const & row, m2::PointD & pt)
+{
+  vector<string> columns;
+  strings::ParseCSVRow(row, ',', columns);
+
+  double lat, lon;
+  if (columns.size() < 2 || !strings::to_double(columns[0], lat) ||
+      !strings::to_double(columns[1], lon) || !mercator::ValidLat(lat) || !mercator::ValidLon(lon))
+  {
+    return false;
+  }
+
+  pt = mercator::FromLatLon(lat, lon);
+  return true;
+}
+
+void ProcessBatch(ReverseGeocoder const & coder, vector<string> const & rows, size_t threadsCount,
+                  ostream & os)
+{
+  vector<m2::PointD> points;
+  vector<size_t> rowToPoint(rows.size(), rows.size());
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    m2::PointD pt;
+    if (ParsePoint(rows[i], pt))
+    {
+      rowToPoint[i] = points.size();
+      points.push_back(pt);
+    }
+  }
+
+  vector<ReverseGeocoder::Address> addrs;
+  coder.GetNearbyAddresses(points, FLAGS_max_distance_m, addrs, threadsCount);
+
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    os << rows[i];
+    if (rowToPoint[i] < addrs.size() && addrs[rowToPoint[i]].IsValid())
+    {
+      auto const & addr = addrs[rowToPoint[i]];
+      os << ',' << EscapeCSV(addr.GetStreetName()) << ',' << EscapeCSV(addr.GetHouseNumber()) << ','
+         << strings::to_string_dac(addr.GetDistance(), 1);
+    }
+    else
+    {
+      os << ",,,";
+    }
+    os << '\n';
+  }
+}
+}  // namespace
+
+int main(int argc, char * argv[])
+{
+  platform::tests_support::ChangeMaxNumberOfOpenFiles(kMaxOpenFiles);
+
+  gflags::SetUsageMessage("Batch reverse geocoder tool.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_num_threads < 1)
+  {
+    cerr << "Number of threads must be positive." << endl;
+    return -1;
+  }
+  auto const threadsCount = static_cast<size_t>(FLAGS_num_threads);
+
+  SetPlatformDirs(FLAGS_data_path, FLAGS_mwm_path);
+
+  classificator::Load();
+
+  FrozenDataSource dataSource;
+  InitDataSource(dataSource, FLAGS_mwm_list_path);
+
+  ReverseGeocoder const coder(dataSource);
+
+  ifstream ifs;
+  if (!FLAGS_csv_in.empty())
+  {
+    ifs.open(FLAGS_csv_in);
+    if (!ifs.is_open())
+    {
+      cerr << "Can't open input csv file." << endl;
+      return -1;
+    }
+  }
+  istream & is = FLAGS_csv_in.empty() ? cin : ifs;
+
+  ofstream ofs;
+  if (!FLAGS_csv_out.empty())
+  {
+    ofs.open(FLAGS_csv_out);
+    if (!ofs.is_open())
+    {
+      cerr << "Can't open output csv file." << endl;
+      return -1;
+    }
+  }
+  ostream & os = FLAGS_csv_out.empty() ? cout : ofs;
+
+  base::Timer timer;
+  uint64_t rowsCount = 0;
+  vector<string> rows;
+  rows.reserve(FLAGS_batch_size);
+
+  string line;
+  while (getline(is, line))
+  {
+    rows.push_back(std::move(line));
+    if (rows.size() >= FLAGS_batch_size)
+    {
+      ProcessBatch(coder, rows, threadsCount, os);
+      rowsCount += rows.size();
+      rows.clear();
+      LOG(LINFO, ("Processed", rowsCount, "rows in", timer.ElapsedSeconds(), "seconds"));
+    }
+  }
+
+  if (!rows.empty())
+  {
+    ProcessBatch(coder, rows, threadsCount, os);
+    rowsCount += rows.size();
+  }
+
+  LOG(LINFO, ("Done.", rowsCount, "rows in", timer.ElapsedSeconds(), "seconds"));
+  return 0;
+}
@@ -14,6 +14,8 @@
 #include "base/logging.hpp"
 #include "base/string_utils.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <limits>
 #include <utility>
@@ -158,5 +160,14 @@ unique_ptr<search::tests_support::TestSearchEngine> InitSearchEngine(
 
   return make_unique<search::tests_support::TestSearchEngine>(dataSource, params);
 }
+
+double Percentile(vector<double> const & values, double p)
+{
+  ASSERT(is_sorted(values.begin(), values.end()), ());
+  if (values.empty())
+    return 0;
+  auto const rank = static_cast<size_t>(ceil(p / 100.0 * static_cast<double>(values.size())));
+  return values[rank == 0 ? 0 : rank - 1];
+}
 }  // namespace search_quality
 }  // namespace search
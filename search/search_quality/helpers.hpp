@@ -30,5 +30,8 @@ void InitDataSource(FrozenDataSource & dataSource, std::string const & mwmListPa
 
 std::unique_ptr<search::tests_support::TestSearchEngine> InitSearchEngine(
     DataSource & dataSource, std::string const & locale, size_t numThreads);
+
+// Returns the value at the |p|-th percentile of the sorted |values| (nearest-rank method).
+double Percentile(std::vector<double> const & values, double p);
 }  // namespace search_quality
 }  // namespace search
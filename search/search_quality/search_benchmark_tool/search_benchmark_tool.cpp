@@ -0,0 +1,337 @@
+// Replays a query log through search::Engine and reports throughput, latency
+// percentiles and peak memory. The log is a text file, every line of it is either
+// "query" or "locale<TAB>query". Queries are replayed as is, so a query without
+// a trailing space is searched with a prefix token.
+//
+// The report may be saved with --json_out and later passed to --compare_with
+// to print the relative difference between two runs.
+
+#include "search/search_quality/helpers.hpp"
+
+#include "search/search_tests_support/test_search_engine.hpp"
+#include "search/search_tests_support/test_search_request.hpp"
+
+#include "search/search_params.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/data_source.hpp"
+
+#include "platform/platform_tests_support/helpers.hpp"
+
+#include "coding/file_reader.hpp"
+
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+#include "base/timer.hpp"
+
+#include "std/target_os.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if !defined(OMIM_OS_WINDOWS)
+#include <sys/resource.h>
+#endif
+
+#include "cppjansson/cppjansson.hpp"
+
+#include <gflags/gflags.h>
+
+using namespace search::search_quality;
+using namespace search::tests_support;
+using namespace search;
+using namespace std::chrono;
+using namespace std;
+
+DEFINE_string(data_path, "", "Path to data directory (resources dir)");
+DEFINE_string(mwm_path, "", "Path to mwm files (writable dir)");
+DEFINE_string(mwm_list_path, "",
+              "Path to a file containing the names of mwms to load, one per line (default: all mwms "
+              "from --mwm_path)");
+DEFINE_string(queries_path, "", "Path to the query log");
+DEFINE_string(locale, "en", "Locale of the queries without an explicit locale");
+DEFINE_string(viewport, "", "Viewport to use when searching (default, moscow, london, zurich)");
+DEFINE_int32(num_threads, 1, "Number of search engine threads");
+DEFINE_int32(concurrency, 0, "Number of queries in flight (default: --num_threads)");
+DEFINE_int32(repeat, 1, "Number of times the query log is replayed");
+DEFINE_int32(warmup, 0, "Number of queries executed before the measurement");
+DEFINE_int32(timeout_ms, 0, "Search timeout in milliseconds (default: no timeout)");
+DEFINE_string(json_out, "", "Path to save the report to");
+DEFINE_string(compare_with, "", "Path to a report of a previous run to compare with");
+DEFINE_double(max_regression_pct, 0,
+              "Exit with an error if QPS or any latency percentile is worse than in --compare_with "
+              "by more than this percentage (0: disabled)");
+
+namespace
+{
+struct Query
+{
+  string m_locale;
+  string m_query;
+};
+
+struct Report
+{
+  double m_queries = 0;
+  double m_emptyResults = 0;
+  double m_wallTimeS = 0;
+  double m_qps = 0;
+  double m_latencyAvgMs = 0;
+  double m_latencyP50Ms = 0;
+  double m_latencyP90Ms = 0;
+  double m_latencyP99Ms = 0;
+  double m_latencyMaxMs = 0;
+  double m_peakRssMb = 0;
+};
+
+struct Metric
+{
+  char const * m_name;
+  double Report::*m_value;
+  // QPS is the only metric where the larger value is the better one.
+  bool m_higherIsBetter;
+  bool m_checkRegression;
+};
+
+// Metrics in the order they are printed and saved.
+Metric const kMetrics[] = {
+    {"queries", &Report::m_queries, false, false},
+    {"empty_results", &Report::m_emptyResults, false, false},
+    {"wall_time_s", &Report::m_wallTimeS, false, false},
+    {"qps", &Report::m_qps, true, true},
+    {"latency_avg_ms", &Report::m_latencyAvgMs, false, true},
+    {"latency_p50_ms", &Report::m_latencyP50Ms, false, true},
+    {"latency_p90_ms", &Report::m_latencyP90Ms, false, true},
+    {"latency_p99_ms", &Report::m_latencyP99Ms, false, true},
+    {"latency_max_ms", &Report::m_latencyMaxMs, false, false},
+    {"peak_rss_mb", &Report::m_peakRssMb, false, false},
+};
+
+vector<Query> ReadQueries(string const & path, string const & defaultLocale)
+{
+  vector<string> lines;
+  ReadStringsFromFile(path, lines);
+
+  vector<Query> queries;
+  queries.reserve(lines.size());
+  for (auto const & line : lines)
+  {
+    auto const tab = line.find('\t');
+    if (tab == string::npos)
+      queries.push_back({defaultLocale, line});
+    else
+      queries.push_back({line.substr(0, tab), line.substr(tab + 1)});
+  }
+  return queries;
+}
+
+// Peak resident set size of the process in megabytes.
+double GetPeakRssMb()
+{
+#if defined(OMIM_OS_WINDOWS)
+  return 0;
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#if defined(OMIM_OS_MAC)
+  // Bytes on Mac OS, kilobytes on Linux.
+  return static_cast<double>(usage.ru_maxrss) / (1024 * 1024);
+#else
+  return static_cast<double>(usage.ru_maxrss) / 1024;
+#endif
+#endif
+}
+
+void RunQuery(TestSearchEngine & engine, Query const & q, m2::RectD const & viewport,
+              double & latencyMs, bool & emptyResults)
+{
+  // The latency is measured from the submission, so the time the query waits for a free engine
+  // thread is included, as a client sees it.
+  base::Timer timer;
+
+  TestSearchRequest request(engine, q.m_query, q.m_locale, Mode::Everywhere, viewport);
+  if (FLAGS_timeout_ms > 0)
+    request.SetTimeout(milliseconds(FLAGS_timeout_ms));
+  request.Run();
+
+  latencyMs = duration_cast<duration<double, milli>>(timer.TimeElapsed()).count();
+  emptyResults = request.Results().empty();
+}
+
+Report RunBenchmark(TestSearchEngine & engine, vector<Query> const & queries,
+                    m2::RectD const & viewport)
+{
+  for (size_t i = 0; i < min(queries.size(), static_cast<size_t>(max(FLAGS_warmup, 0))); ++i)
+  {
+    double latencyMs;
+    bool emptyResults;
+    RunQuery(engine, queries[i], viewport, latencyMs, emptyResults);
+  }
+
+  size_t const total = queries.size() * static_cast<size_t>(max(FLAGS_repeat, 1));
+  size_t const concurrency =
+      static_cast<size_t>(FLAGS_concurrency > 0 ? FLAGS_concurrency : max(FLAGS_num_threads, 1));
+
+  vector<double> latencies(total);
+  // vector<bool> is not safe to be written from several threads.
+  vector<uint8_t> emptyResults(total);
+  atomic<size_t> next(0);
+
+  LOG(LINFO, ("Replaying", total, "queries with concurrency", concurrency));
+  base::Timer timer;
+
+  vector<thread> clients;
+  clients.reserve(concurrency);
+  for (size_t c = 0; c < concurrency; ++c)
+  {
+    clients.emplace_back([&]()
+    {
+      for (size_t i = next++; i < total; i = next++)
+      {
+        bool empty;
+        RunQuery(engine, queries[i % queries.size()], viewport, latencies[i], empty);
+        emptyResults[i] = empty ? 1 : 0;
+      }
+    });
+  }
+  for (auto & client : clients)
+    client.join();
+
+  double const wallTime = timer.ElapsedSeconds();
+
+  sort(latencies.begin(), latencies.end());
+  double sum = 0;
+  for (auto const l : latencies)
+    sum += l;
+
+  Report report;
+  report.m_queries = static_cast<double>(total);
+  report.m_emptyResults = static_cast<double>(count(emptyResults.begin(), emptyResults.end(), 1));
+  report.m_wallTimeS = wallTime;
+  report.m_qps = wallTime > 0 ? static_cast<double>(total) / wallTime : 0;
+  report.m_latencyAvgMs = total == 0 ? 0 : sum / static_cast<double>(total);
+  report.m_latencyP50Ms = Percentile(latencies, 50);
+  report.m_latencyP90Ms = Percentile(latencies, 90);
+  report.m_latencyP99Ms = Percentile(latencies, 99);
+  report.m_latencyMaxMs = latencies.empty() ? 0 : latencies.back();
+  report.m_peakRssMb = GetPeakRssMb();
+  return report;
+}
+
+void SaveReport(Report const & report, string const & path)
+{
+  auto root = base::NewJSONObject();
+  for (auto const & metric : kMetrics)
+    ToJSONObject(*root, metric.m_name, report.*metric.m_value);
+
+  ofstream os(path);
+  CHECK(os.is_open(), ("Can't open", path));
+  os << base::DumpToString(root, JSON_INDENT(2)) << endl;
+}
+
+Report LoadReport(string const & path)
+{
+  string data;
+  FileReader(path).ReadAsString(data);
+
+  base::Json root(data.c_str());
+  Report report;
+  for (auto const & metric : kMetrics)
+    FromJSONObject(root.get(), metric.m_name, report.*metric.m_value);
+  return report;
+}
+
+void PrintReport(Report const & report)
+{
+  cout << fixed << setprecision(3);
+  for (auto const & metric : kMetrics)
+    cout << setw(16) << left << metric.m_name << right << setw(14) << report.*metric.m_value << endl;
+}
+
+// Prints both reports side by side and returns false if any checked metric
+// regressed by more than |maxRegressionPct| percent.
+bool Compare(Report const & baseline, Report const & current, double maxRegressionPct)
+{
+  cout << fixed << setprecision(3);
+  cout << setw(16) << left << "metric" << right << setw(14) << "baseline" << setw(14) << "current"
+       << setw(12) << "diff, %" << endl;
+
+  bool ok = true;
+  for (auto const & metric : kMetrics)
+  {
+    double const before = baseline.*metric.m_value;
+    double const after = current.*metric.m_value;
+    double const diffPct = before == 0 ? 0 : 100.0 * (after - before) / before;
+
+    cout << setw(16) << left << metric.m_name << right << setw(14) << before << setw(14) << after
+         << setw(12) << diffPct;
+
+    double const regressionPct = metric.m_higherIsBetter ? -diffPct : diffPct;
+    if (maxRegressionPct > 0 && metric.m_checkRegression && regressionPct > maxRegressionPct)
+    {
+      cout << "  <- regression";
+      ok = false;
+    }
+    cout << endl;
+  }
+  return ok;
+}
+}  // namespace
+
+int main(int argc, char * argv[])
+{
+  platform::tests_support::ChangeMaxNumberOfOpenFiles(kMaxOpenFiles);
+  CheckLocale();
+
+  gflags::SetUsageMessage("Search throughput benchmark.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_queries_path.empty())
+  {
+    cerr << "Path to the query log is not set." << endl;
+    return -1;
+  }
+
+  SetPlatformDirs(FLAGS_data_path, FLAGS_mwm_path);
+
+  classificator::Load();
+
+  FrozenDataSource dataSource;
+  InitDataSource(dataSource, FLAGS_mwm_list_path);
+
+  auto engine = InitSearchEngine(dataSource, FLAGS_locale, static_cast<size_t>(FLAGS_num_threads));
+  engine->InitAffiliations();
+
+  m2::RectD viewport;
+  InitViewport(FLAGS_viewport, viewport);
+
+  auto const queries = ReadQueries(FLAGS_queries_path, FLAGS_locale);
+  if (queries.empty())
+  {
+    cerr << "Query log is empty." << endl;
+    return -1;
+  }
+
+  Report const report = RunBenchmark(*engine, queries, viewport);
+
+  if (!FLAGS_json_out.empty())
+    SaveReport(report, FLAGS_json_out);
+
+  if (FLAGS_compare_with.empty())
+  {
+    PrintReport(report);
+    return 0;
+  }
+
+  return Compare(LoadReport(FLAGS_compare_with), report, FLAGS_max_regression_pct) ? 0 : 1;
+}
@@ -6,6 +6,7 @@
 #include "search/ranking_info.hpp"
 #include "search/result.hpp"
 #include "search/search_params.hpp"
+#include "search/tracer.hpp"
 
 #include "indexer/classificator_loader.hpp"
 #include "indexer/data_source.hpp"
@@ -34,6 +35,7 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
 #include <numeric>
 #include <sstream>
 #include <string>
@@ -58,6 +60,7 @@ DEFINE_int32(top, 1, "Number of top results to show for every query");
 DEFINE_string(viewport, "", "Viewport to use when searching (default, moscow, london, zurich)");
 DEFINE_string(check_completeness, "", "Path to the file with completeness data");
 DEFINE_string(ranking_csv_file, "", "File ranking info will be exported to");
+DEFINE_bool(profile, false, "Print per-phase latency and work counter percentiles over all queries");
 
 string const kDefaultQueriesPathSuffix =
     "/../search/search_quality/search_quality_tool/queries.txt";
@@ -184,6 +187,44 @@ void CalcStatistics(vector<double> const & a, double & avg, double & maximum, do
   stdDev = sqrt(var);
 }
 
+void PrintProfiles(vector<shared_ptr<Tracer>> const & tracers)
+{
+  using Profile = Tracer::Profile;
+
+  auto const printRow = [](string const & name, vector<double> & values)
+  {
+    sort(values.begin(), values.end());
+    cout << setw(20) << left << name << right;
+    for (double const p : {50.0, 90.0, 99.0, 100.0})
+      cout << setw(14) << Percentile(values, p);
+    cout << endl;
+  };
+
+  cout << endl;
+  cout << setw(20) << left << "Phase/counter" << right << setw(14) << "p50" << setw(14) << "p90"
+       << setw(14) << "p99" << setw(14) << "max" << endl;
+
+  vector<double> values(tracers.size());
+  for (size_t i = 0; i < Profile::kNumPhases; ++i)
+  {
+    auto const phase = static_cast<Profile::Phase>(i);
+    for (size_t j = 0; j < tracers.size(); ++j)
+    {
+      auto const us = duration_cast<microseconds>(tracers[j]->GetProfile().Get(phase)).count();
+      values[j] = static_cast<double>(us) / 1000;
+    }
+    printRow(DebugPrint(phase) + ", ms", values);
+  }
+
+  for (size_t i = 0; i < Profile::kNumCounters; ++i)
+  {
+    auto const counter = static_cast<Profile::Counter>(i);
+    for (size_t j = 0; j < tracers.size(); ++j)
+      values[j] = static_cast<double>(tracers[j]->GetProfile().Get(counter));
+    printRow(DebugPrint(counter), values);
+  }
+}
+
 // Returns the position of the result that is expected to be found by geocoder completeness
 // tests in the |result| vector or -1 if it does not occur there.
 int FindResult(DataSource & dataSource, string const & mwmName, uint32_t const featureId,
@@ -290,7 +331,7 @@ void CheckCompleteness(string const & path, DataSource & dataSource, TestSearchE
 }
 
 void RunRequests(TestSearchEngine & engine, m2::RectD const & viewport, string queriesPath,
-                 string const & locale, string const & rankingCSVFile, size_t top)
+                 string const & locale, string const & rankingCSVFile, size_t top, bool profile)
 {
   vector<string> queries;
   {
@@ -300,11 +341,17 @@ void RunRequests(TestSearchEngine & engine, m2::RectD const & viewport, string q
   }
 
   vector<unique_ptr<TestSearchRequest>> requests;
+  vector<shared_ptr<Tracer>> tracers;
   for (size_t i = 0; i < queries.size(); ++i)
   {
     // todo(@m) Add a bool flag to search with prefixes?
     requests.emplace_back(make_unique<TestSearchRequest>(engine, MakePrefixFree(queries[i]), locale,
                                                          Mode::Everywhere, viewport));
+    if (profile)
+    {
+      tracers.push_back(make_shared<Tracer>());
+      requests.back()->SetTracer(tracers.back());
+    }
   }
 
   ofstream csv;
@@ -353,6 +400,9 @@ void RunRequests(TestSearchEngine & engine, m2::RectD const & viewport, string q
   cout << "Maximum response time: " << maxTime << "s" << endl;
   cout << "Average response time: " << averageTime << "s"
        << " (std. dev. " << stdDevTime << "s)" << endl;
+
+  if (profile)
+    PrintProfiles(tracers);
 }
 
 int main(int argc, char * argv[])
@@ -385,6 +435,6 @@ int main(int argc, char * argv[])
   }
 
   RunRequests(*engine, viewport, FLAGS_queries_path, FLAGS_locale, FLAGS_ranking_csv_file,
-              static_cast<size_t>(FLAGS_top));
+              static_cast<size_t>(FLAGS_top), FLAGS_profile);
   return 0;
 }
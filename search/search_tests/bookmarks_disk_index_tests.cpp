@@ -0,0 +1,213 @@
+#include "testing/testing.hpp"
+
+#include "search/bookmarks/disk_index.hpp"
+#include "search/doc_vec.hpp"
+
+#include "platform/platform.hpp"
+#include "platform/platform_tests_support/scoped_dir.hpp"
+
+#include "base/dfa_helpers.hpp"
+#include "base/levenshtein_dfa.hpp"
+#include "base/stl_helpers.hpp"
+#include "base/string_utils.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace bookmarks_disk_index_tests
+{
+using namespace platform::tests_support;
+using namespace search::bookmarks;
+using namespace search;
+using namespace std;
+
+using Ids = vector<Id>;
+
+string const kIndexDir = "bookmarks_disk_index_tests";
+
+DocVec MakeDoc(string const & text)
+{
+  DocVec::Builder builder;
+  for (auto const & token : strings::Tokenize(text, " "))
+    builder.Add(strings::MakeUniString(token));
+  return DocVec(builder);
+}
+
+Ids Match(DiskIndex const & index, string const & token, bool isPrefix = false)
+{
+  Ids ids;
+  auto const collect = [&ids](Id const & id) { ids.push_back(id); };
+
+  strings::LevenshteinDFA dfa(token, 0 /* maxErrors */);
+  if (isPrefix)
+    index.ForEachMatch(strings::PrefixDFAModifier<strings::LevenshteinDFA>(std::move(dfa)), collect);
+  else
+    index.ForEachMatch(dfa, collect);
+
+  base::SortUnique(ids);
+  return ids;
+}
+
+class DiskIndexTest
+{
+public:
+  DiskIndexTest() : m_dir(kIndexDir) {}
+
+  ~DiskIndexTest()
+  {
+    TEST(Platform::RmDirRecursively(m_dir.GetFullPath()), ());
+    m_dir.Reset();
+  }
+
+protected:
+  void Add(DiskIndex & index, Id const & id, string const & text)
+  {
+    index.Put(id, MakeDoc(text));
+    index.SetSearchable(id, true /* searchable */);
+  }
+
+  vector<string> GetSegmentFiles() const
+  {
+    Platform::FilesList files;
+    Platform::GetFilesByRegExp(m_dir.GetFullPath(), R"(^bookmarks\..*\.(index|docs)$)", files);
+    sort(files.begin(), files.end());
+    return files;
+  }
+
+  ScopedDir m_dir;
+};
+
+UNIT_CLASS_TEST(DiskIndexTest, Smoke)
+{
+  DiskIndex index(m_dir.GetFullPath());
+  Add(index, Id{10}, "double r diner");
+  Add(index, Id{18}, "silver mustang casino");
+
+  TEST_EQUAL(Match(index, "diner"), Ids({10}), ());
+  TEST_EQUAL(Match(index, "din", true /* isPrefix */), Ids({10}), ());
+  TEST_EQUAL(Match(index, "din"), Ids{}, ());
+  TEST_EQUAL(index.GetNumDocs(strings::MakeUniString("s"), true /* isPrefix */), 1, ());
+
+  // Postings are served from the same segments before and after the merge.
+  index.Flush();
+  Add(index, Id{20}, "great northern hotel silver");
+  TEST_EQUAL(Match(index, "silver"), Ids({18, 20}), ());
+  index.WaitForMerge();
+  TEST(!index.IsMerging(), ());
+  TEST_EQUAL(Match(index, "silver"), Ids({18, 20}), ());
+  TEST_EQUAL(index.GetNumDocs(strings::MakeUniString("silver"), false /* isPrefix */), 2, ());
+
+  index.SetSearchable(Id{18}, false /* searchable */);
+  TEST_EQUAL(Match(index, "silver"), Ids({20}), ());
+  TEST_EQUAL(index.GetNumDocs(strings::MakeUniString("silver"), false /* isPrefix */), 1, ());
+
+  // An updated doc gets a new slot, the postings of the old one are ignored.
+  Add(index, Id{20}, "great northern hotel");
+  TEST_EQUAL(Match(index, "silver"), Ids{}, ());
+  TEST_EQUAL(Match(index, "northern"), Ids({20}), ());
+
+  index.Reset();
+  TEST_EQUAL(Match(index, "northern"), Ids{}, ());
+}
+
+UNIT_CLASS_TEST(DiskIndexTest, Docs)
+{
+  DiskIndex index(m_dir.GetFullPath());
+  auto const doc = MakeDoc("silver mustang silver");
+  index.Put(Id{18}, doc);
+
+  DocVec docVec;
+  TEST(index.GetDocVec(Id{18}, docVec), ());
+  TEST_EQUAL(DebugPrint(docVec), DebugPrint(doc), ());
+
+  index.Flush();
+  index.WaitForMerge();
+  TEST(index.GetDocVec(Id{18}, docVec), ());
+  TEST_EQUAL(DebugPrint(docVec), DebugPrint(doc), ());
+
+  index.Forget(Id{18});
+  TEST(!index.GetDocVec(Id{18}, docVec), ());
+}
+
+UNIT_CLASS_TEST(DiskIndexTest, Compaction)
+{
+  DiskIndex index(m_dir.GetFullPath());
+  Add(index, Id{10}, "double r diner");
+  Add(index, Id{18}, "silver mustang casino");
+  Add(index, Id{20}, "great northern hotel");
+  index.Flush();
+  index.WaitForMerge();
+  TEST_EQUAL(index.GetNumSlots(), 3, ());
+  TEST_EQUAL(GetSegmentFiles(), vector<string>({"bookmarks.1.docs", "bookmarks.1.index"}), ());
+
+  index.Forget(Id{10});
+  Add(index, Id{18}, "golden mustang casino");
+  TEST_EQUAL(index.GetNumSlots(), 4, ());
+
+  // Unsearchable docs keep their slots.
+  index.SetSearchable(Id{20}, false /* searchable */);
+
+  index.Flush();
+  // Slots put during the merge are renumbered when it is finished.
+  Add(index, Id{30}, "one eyed jacks");
+  index.WaitForMerge();
+  TEST_EQUAL(index.GetNumSlots(), 3, ());
+  TEST_EQUAL(GetSegmentFiles(), vector<string>({"bookmarks.2.docs", "bookmarks.2.index"}), ());
+
+  TEST_EQUAL(Match(index, "diner"), Ids{}, ());
+  TEST_EQUAL(Match(index, "silver"), Ids{}, ());
+  TEST_EQUAL(Match(index, "golden"), Ids({18}), ());
+  TEST_EQUAL(Match(index, "mustang"), Ids({18}), ());
+  TEST_EQUAL(Match(index, "hotel"), Ids{}, ());
+  TEST_EQUAL(Match(index, "jacks"), Ids({30}), ());
+  index.SetSearchable(Id{20}, true /* searchable */);
+  TEST_EQUAL(Match(index, "hotel"), Ids({20}), ());
+
+  index.Flush();
+  index.WaitForMerge();
+  TEST_EQUAL(index.GetNumSlots(), 3, ());
+  TEST_EQUAL(Match(index, "jacks"), Ids({30}), ());
+  TEST_EQUAL(GetSegmentFiles(), vector<string>({"bookmarks.3.docs", "bookmarks.3.index"}), ());
+}
+
+UNIT_CLASS_TEST(DiskIndexTest, Reload)
+{
+  {
+    DiskIndex index(m_dir.GetFullPath());
+    Add(index, Id{10}, "double r diner");
+    Add(index, Id{18}, "silver mustang casino");
+    Add(index, Id{20}, "great northern hotel");
+    index.Forget(Id{20});
+    index.Flush();
+    index.WaitForMerge();
+    // The delta is not merged on destruction.
+    Add(index, Id{30}, "one eyed jacks");
+  }
+
+  DiskIndex index(m_dir.GetFullPath());
+  // Nothing is searchable until the docs are added.
+  TEST_EQUAL(Match(index, "diner"), Ids{}, ());
+  TEST_EQUAL(index.GetNumSlots(), 2, ());
+
+  // Docs which did not change are not indexed again.
+  Add(index, Id{10}, "double r diner");
+  TEST_EQUAL(index.GetDeltaSize(), 0, ());
+  TEST_EQUAL(Match(index, "diner"), Ids({10}), ());
+
+  // The delta size includes the doc itself.
+  Add(index, Id{18}, "golden mustang casino");
+  TEST_EQUAL(index.GetDeltaSize(), 4, ());
+  TEST_EQUAL(Match(index, "silver"), Ids{}, ());
+  TEST_EQUAL(Match(index, "golden"), Ids({18}), ());
+
+  // Forgotten docs are indexed from scratch.
+  Add(index, Id{20}, "great northern hotel");
+  TEST_EQUAL(index.GetDeltaSize(), 8, ());
+  TEST_EQUAL(Match(index, "hotel"), Ids({20}), ());
+
+  Add(index, Id{30}, "one eyed jacks");
+  TEST_EQUAL(index.GetDeltaSize(), 12, ());
+  TEST_EQUAL(Match(index, "jacks"), Ids({30}), ());
+}
+}  // namespace bookmarks_disk_index_tests
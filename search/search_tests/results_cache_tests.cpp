@@ -0,0 +1,103 @@
+#include "testing/testing.hpp"
+
+#include "search/results_cache.hpp"
+#include "search/search_params.hpp"
+
+#include "geometry/mercator.hpp"
+
+#include <string>
+
+namespace results_cache_tests
+{
+using namespace search;
+using namespace std;
+
+SearchParams GetParams(string const & query, m2::PointD const & center)
+{
+  SearchParams params;
+  params.m_query = query;
+  params.m_inputLocale = "en";
+  params.m_viewport = mercator::RectByCenterXYAndSizeInMeters(center, 5000);
+  params.m_mode = Mode::Everywhere;
+  return params;
+}
+
+UNIT_TEST(ResultsCache_MakeKey)
+{
+  m2::PointD const minsk = mercator::FromLatLon(53.9, 27.56);
+  m2::PointD const london = mercator::FromLatLon(51.5, 0.0);
+
+  auto const key = ResultsCache::MakeKey(GetParams("Cafe", minsk));
+  TEST(!key.empty(), ());
+
+  // Normalization.
+  TEST_EQUAL(key, ResultsCache::MakeKey(GetParams("  CAFE", minsk)), ());
+  // Full token is not the same as a prefix.
+  TEST_NOT_EQUAL(key, ResultsCache::MakeKey(GetParams("cafe ", minsk)), ());
+  // Nearby pivot is in the same cell.
+  TEST_EQUAL(key, ResultsCache::MakeKey(GetParams("cafe", minsk + m2::PointD(1e-5, 1e-5))), ());
+  TEST_NOT_EQUAL(key, ResultsCache::MakeKey(GetParams("cafe", london)), ());
+
+  {
+    auto params = GetParams("cafe", minsk);
+    params.m_inputLocale = "ru";
+    TEST_NOT_EQUAL(key, ResultsCache::MakeKey(params), ());
+  }
+  {
+    auto params = GetParams("cafe", minsk);
+    params.m_mode = Mode::Viewport;
+    TEST_NOT_EQUAL(key, ResultsCache::MakeKey(params), ());
+  }
+  {
+    auto params = GetParams("cafe", minsk);
+    params.m_mode = Mode::Bookmarks;
+    TEST(ResultsCache::MakeKey(params).empty(), ());
+  }
+}
+
+UNIT_TEST(ResultsCache_Smoke)
+{
+  ResultsCache cache(2 /* maxSize */);
+
+  Results results;
+  results.AddResultNoChecks(Result(m2::PointD(1, 1), "first"));
+  results.SetEndMarker(false /* cancelled */);
+
+  Results cached;
+  TEST(!cache.Get("a", cached), ());
+  cache.Put("a", results);
+  TEST(cache.Get("a", cached), ());
+  TEST_EQUAL(cached.GetCount(), 1, ());
+  TEST(cached.IsEndedNormal(), ());
+  TEST_EQUAL(cached[0].GetString(), "first", ());
+
+  // "a" is the least recently used one and is evicted.
+  cache.Put("b", results);
+  TEST(cache.Get("b", cached), ());
+  cache.Put("c", results);
+  TEST(!cache.Get("a", cached), ());
+  TEST(cache.Get("c", cached), ());
+
+  cache.Clear();
+  TEST(!cache.Get("c", cached), ());
+
+  auto const stats = cache.GetStats();
+  TEST_EQUAL(stats.m_hits, 3, ());
+  TEST_EQUAL(stats.m_misses, 3, ());
+  TEST_EQUAL(stats.m_clears, 1, ());
+}
+
+UNIT_TEST(ResultsCache_MissesDontEvict)
+{
+  ResultsCache cache(1 /* maxSize */);
+
+  Results results;
+  results.SetEndMarker(false /* cancelled */);
+  cache.Put("a", results);
+
+  Results cached;
+  TEST(!cache.Get("b", cached), ());
+  TEST(!cache.Get("c", cached), ());
+  TEST(cache.Get("a", cached), ());
+}
+}  // namespace results_cache_tests
@@ -9,8 +9,10 @@
 
 #include <chrono>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace search
@@ -30,6 +32,8 @@ public:
   TestSearchRequest(TestSearchEngine & engine, SearchParams const & params);
 
   void SetCategorial() { m_params.m_categorialRequest = true; }
+  void SetTracer(std::shared_ptr<Tracer> tracer) { m_params.m_tracer = std::move(tracer); }
+  void SetTimeout(SearchParams::TimeDurationT timeout) { m_params.m_timeout = timeout; }
 
   // Initiates the search and waits for it to finish.
   void Run();
@@ -11,6 +11,11 @@ using namespace std;
 
 namespace search
 {
+namespace
+{
+thread_local Tracer * g_profiledTracer = nullptr;
+}  // namespace
+
 // Tracer::Parse -----------------------------------------------------------------------------------
 Tracer::Parse::Parse(vector<TokenType> const & types, bool category) : m_category(category)
 {
@@ -42,6 +47,45 @@ vector<Tracer::Parse> Tracer::GetUniqueParses() const
   return parses;
 }
 
+void Tracer::StartPhase(Profile::Phase phase)
+{
+  auto const now = chrono::steady_clock::now();
+  if (!m_activePhases.empty())
+  {
+    auto & outer = m_activePhases.back();
+    m_profile.m_durations[static_cast<size_t>(outer.first)] += now - outer.second;
+  }
+  m_activePhases.emplace_back(phase, now);
+}
+
+void Tracer::EndPhase(Profile::Phase phase)
+{
+  CHECK(!m_activePhases.empty(), ());
+  CHECK_EQUAL(m_activePhases.back().first, phase, ());
+
+  auto const now = chrono::steady_clock::now();
+  m_profile.m_durations[static_cast<size_t>(phase)] += now - m_activePhases.back().second;
+  m_activePhases.pop_back();
+
+  if (!m_activePhases.empty())
+    m_activePhases.back().second = now;
+}
+
+// static
+void Tracer::Inc(Profile::Counter counter, uint64_t delta)
+{
+  if (g_profiledTracer)
+    g_profiledTracer->m_profile.m_counters[static_cast<size_t>(counter)] += delta;
+}
+
+// Tracer::ScopedProfile ---------------------------------------------------------------------------
+Tracer::ScopedProfile::ScopedProfile(Tracer * tracer) : m_prevTracer(g_profiledTracer)
+{
+  g_profiledTracer = tracer;
+}
+
+Tracer::ScopedProfile::~ScopedProfile() { g_profiledTracer = m_prevTracer; }
+
 // ResultTracer ------------------------------------------------------------------------------------
 void ResultTracer::Clear() { m_provenance.clear(); }
 
@@ -82,6 +126,58 @@ string DebugPrint(Tracer::Parse const & parse)
   return os.str();
 }
 
+string DebugPrint(Tracer::Profile::Phase phase)
+{
+  using Phase = Tracer::Profile::Phase;
+  switch (phase)
+  {
+  case Phase::Retrieval: return "Retrieval";
+  case Phase::LayersMatching: return "LayersMatching";
+  case Phase::PreRanking: return "PreRanking";
+  case Phase::Ranking: return "Ranking";
+  case Phase::Count: return "Count";
+  }
+  UNREACHABLE();
+}
+
+string DebugPrint(Tracer::Profile::Counter counter)
+{
+  using Counter = Tracer::Profile::Counter;
+  switch (counter)
+  {
+  case Counter::CBVOps: return "CBVOps";
+  case Counter::FeaturesLoaded: return "FeaturesLoaded";
+  case Counter::TrieNodesVisited: return "TrieNodesVisited";
+  case Counter::CacheHits: return "CacheHits";
+  case Counter::CacheMisses: return "CacheMisses";
+  case Counter::Count: return "Count";
+  }
+  UNREACHABLE();
+}
+
+string DebugPrint(Tracer::Profile const & profile)
+{
+  using Profile = Tracer::Profile;
+
+  ostringstream os;
+  os << "Profile [";
+  for (size_t i = 0; i < Profile::kNumPhases; ++i)
+  {
+    auto const phase = static_cast<Profile::Phase>(i);
+    os << DebugPrint(phase) << ": "
+       << chrono::duration_cast<chrono::microseconds>(profile.Get(phase)).count() << "us, ";
+  }
+  for (size_t i = 0; i < Profile::kNumCounters; ++i)
+  {
+    auto const counter = static_cast<Profile::Counter>(i);
+    if (i != 0)
+      os << ", ";
+    os << DebugPrint(counter) << ": " << profile.Get(counter);
+  }
+  os << "]";
+  return os.str();
+}
+
 string DebugPrint(ResultTracer::Branch branch)
 {
   switch (branch)
@@ -4,6 +4,9 @@
 #include "search/token_range.hpp"
 
 #include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
@@ -45,8 +48,95 @@ public:
 
   std::vector<Parse> GetUniqueParses() const;
 
+  // Per-query latency breakdown and work counters.
+  struct Profile
+  {
+    using Duration = std::chrono::steady_clock::duration;
+
+    enum class Phase
+    {
+      Retrieval,
+      LayersMatching,
+      PreRanking,
+      Ranking,
+      Count
+    };
+
+    enum class Counter
+    {
+      CBVOps,
+      FeaturesLoaded,
+      TrieNodesVisited,
+      CacheHits,
+      CacheMisses,
+      Count
+    };
+
+    static size_t constexpr kNumPhases = static_cast<size_t>(Phase::Count);
+    static size_t constexpr kNumCounters = static_cast<size_t>(Counter::Count);
+
+    Duration Get(Phase phase) const { return m_durations[static_cast<size_t>(phase)]; }
+    uint64_t Get(Counter counter) const { return m_counters[static_cast<size_t>(counter)]; }
+
+    std::array<Duration, kNumPhases> m_durations{};
+    std::array<uint64_t, kNumCounters> m_counters{};
+  };
+
+  // Phases may nest: the time spent in a nested phase is not accounted to
+  // the enclosing one, so the sum of all phases does not exceed the wall time.
+  void StartPhase(Profile::Phase phase);
+  void EndPhase(Profile::Phase phase);
+
+  Profile const & GetProfile() const { return m_profile; }
+
+  // Increments |counter| of the tracer bound to the current thread by ScopedProfile, if any.
+  // Bit vectors and feature loaders know nothing about the request they work for,
+  // so the work is counted this way.
+  static void Inc(Profile::Counter counter, uint64_t delta = 1);
+
+  // Binds |tracer| to the current thread for the scope. |tracer| may be null,
+  // then nothing is counted.
+  class ScopedProfile
+  {
+  public:
+    explicit ScopedProfile(Tracer * tracer);
+    ~ScopedProfile();
+
+    ScopedProfile(ScopedProfile const &) = delete;
+    ScopedProfile & operator=(ScopedProfile const &) = delete;
+
+  private:
+    Tracer * m_prevTracer;
+  };
+
+  class ScopedPhase
+  {
+  public:
+    ScopedPhase(Tracer * tracer, Profile::Phase phase) : m_tracer(tracer), m_phase(phase)
+    {
+      if (m_tracer)
+        m_tracer->StartPhase(m_phase);
+    }
+
+    ~ScopedPhase()
+    {
+      if (m_tracer)
+        m_tracer->EndPhase(m_phase);
+    }
+
+    ScopedPhase(ScopedPhase const &) = delete;
+    ScopedPhase & operator=(ScopedPhase const &) = delete;
+
+  private:
+    Tracer * m_tracer;
+    Profile::Phase m_phase;
+  };
+
 private:
   std::vector<Parse> m_parses;
+
+  Profile m_profile;
+  std::vector<std::pair<Profile::Phase, std::chrono::steady_clock::time_point>> m_activePhases;
 };
 
 class ResultTracer
@@ -82,5 +172,8 @@ private:
 };
 
 std::string DebugPrint(Tracer::Parse const & parse);
+std::string DebugPrint(Tracer::Profile::Phase phase);
+std::string DebugPrint(Tracer::Profile::Counter counter);
+std::string DebugPrint(Tracer::Profile const & profile);
 std::string DebugPrint(ResultTracer::Branch branch);
 }  // namespace search
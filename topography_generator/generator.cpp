@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -82,7 +83,7 @@ public:
 
   void SetPrefferedTile(ms::LatLon const & pos)
   {
-    m_preferredTile = &m_srtmManager.GetTile(pos);
+    m_preferredTile = m_srtmManager.GetTile(pos);
     m_leftBottomOfPreferredTile = {std::floor(pos.m_lat), std::floor(pos.m_lon)};
   }
 
@@ -165,7 +166,7 @@ private:
   }
 
   generator::SrtmTileManager m_srtmManager;
-  generator::SrtmTile const * m_preferredTile = nullptr;
+  std::shared_ptr<generator::SrtmTile const> m_preferredTile;
   ms::LatLon m_leftBottomOfPreferredTile;
 };
 